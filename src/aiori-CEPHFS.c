@@ -19,8 +19,11 @@
 #endif
 
 #include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <cephfs/libcephfs.h>
 
@@ -46,6 +49,9 @@ struct cephfs_options{
   char * prefix;
   char * remote_prefix;
   int olazy;
+  int ll;
+  int async;
+  int window;
 };
 
 static struct cephfs_options o = {
@@ -54,6 +60,9 @@ static struct cephfs_options o = {
   .prefix = NULL,
   .remote_prefix = NULL,
   .olazy = 0,
+  .ll = 0,
+  .async = 0,
+  .window = 16,
 };
 
 static option_help options [] = {
@@ -62,10 +71,18 @@ static option_help options [] = {
       {0, "cephfs.prefix", "Mount prefix", OPTION_OPTIONAL_ARGUMENT, 's', & o.prefix},
       {0, "cephfs.remote_prefix", "Remote mount prefix", OPTION_OPTIONAL_ARGUMENT, 's', & o.remote_prefix},
       {0, "cephfs.olazy", "Enable Lazy I/O", OPTION_FLAG, 'd', & o.olazy},
+      {0, "cephfs.ll", "Use the low-level API with cached inodes of the parent directories instead of resolving the full path with each call", OPTION_FLAG, 'd', & o.ll},
+      {0, "cephfs.async", "Use asynchronous I/O (ceph_ll_nonblocking_readv_writev) with up to cephfs.window operations in flight, implies cephfs.ll", OPTION_FLAG, 'd', & o.async},
+      {0, "cephfs.window", "Number of asynchronous operations in flight per rank", OPTION_OPTIONAL_ARGUMENT, 'd', & o.window},
       LAST_OPTION
 };
 
 static struct ceph_mount_info *cmount;
+static Inode *root;                     /* root inode of the mount */
+static UserPerm *perms;
+
+/* the low-level API is used for metadata and files */
+#define CEPHFS_LL (o.ll || o.async)
 
 /**************************** P R O T O T Y P E S *****************************/
 static void CEPHFS_Init();
@@ -85,6 +102,7 @@ static int CEPHFS_RmDir(const char *path, aiori_mod_opt_t *options);
 static int CEPHFS_Access(const char *path, int mode, aiori_mod_opt_t *options);
 static int CEPHFS_Stat(const char *path, struct stat *buf, aiori_mod_opt_t *options);
 static void CEPHFS_Sync(aiori_mod_opt_t *);
+static int CEPHFS_check_params(aiori_mod_opt_t *);
 static option_help * CEPHFS_options();
 
 static aiori_xfer_hint_t * hints = NULL;
@@ -111,6 +129,7 @@ ior_aiori_t cephfs_aiori = {
         .access = CEPHFS_Access,
         .stat = CEPHFS_Stat,
         .sync = CEPHFS_Sync,
+        .check_params = CEPHFS_check_params,
         .enable_mdtest = true,
 };
 
@@ -141,6 +160,250 @@ static option_help * CEPHFS_options(){
   return options;
 }
 
+static int CEPHFS_check_params(aiori_mod_opt_t *options)
+{
+        if (o.window < 1)
+                ERR("CEPHFS window must be at least 1");
+#ifndef HAVE_CEPH_LL_NONBLOCKING_READV_WRITEV
+        if (o.async)
+                ERR("CEPHFS async requires ceph_ll_nonblocking_readv_writev() of libcephfs (Ceph 18 or later)");
+#endif
+        return 0;
+}
+
+/*
+ * Inodes of directories by their path below the mount, so that the low-level
+ * API resolves only the last component of a path with each call. Every entry
+ * holds a reference of its inode; parents are looked up (and cached) first.
+ * Other ranks may remove and recreate a cached directory, an operation that
+ * fails with ENOENT or ESTALE therefore drops the entries and is retried once.
+ */
+#define CEPHFS_CACHE_BUCKETS 4096
+
+typedef struct cephfs_dentry {
+        char *path;
+        Inode *inode;
+        struct cephfs_dentry *next;
+} cephfs_dentry_t;
+
+static cephfs_dentry_t *inode_cache[CEPHFS_CACHE_BUCKETS];
+
+static unsigned CEPHFS_Hash(const char *path, size_t len)
+{
+        unsigned hash = 5381;
+        size_t i;
+
+        for (i = 0; i < len; i++)
+                hash = hash * 33 + (unsigned char)path[i];
+        return hash % CEPHFS_CACHE_BUCKETS;
+}
+
+static cephfs_dentry_t **CEPHFS_CacheFind(const char *path, size_t len)
+{
+        cephfs_dentry_t **e = &inode_cache[CEPHFS_Hash(path, len)];
+
+        for (; *e != NULL; e = &(*e)->next) {
+                if (strncmp((*e)->path, path, len) == 0 && (*e)->path[len] == 0)
+                        return e;
+        }
+        return e;
+}
+
+static void CEPHFS_CacheInsert(const char *path, size_t len, Inode *inode)
+{
+        cephfs_dentry_t **e = CEPHFS_CacheFind(path, len);
+
+        if (*e != NULL) {
+                ceph_ll_put(cmount, (*e)->inode);
+                (*e)->inode = inode;
+                return;
+        }
+        *e = safeMalloc(sizeof(cephfs_dentry_t));
+        (*e)->path = strndup(path, len);
+        (*e)->inode = inode;
+        (*e)->next = NULL;
+}
+
+/* the directory inode of the path with len characters (without a leading /) */
+static Inode *CEPHFS_LookupDir(const char *path, size_t len, int *ret)
+{
+        cephfs_dentry_t **e;
+        struct ceph_statx stx;
+        const char *slash = NULL;
+        Inode *parent;
+        Inode *inode;
+        char *name;
+        size_t i;
+
+        if (len == 0)
+                return root;
+        e = CEPHFS_CacheFind(path, len);
+        if (*e != NULL)
+                return (*e)->inode;
+
+        for (i = 0; i < len; i++) {
+                if (path[i] == '/')
+                        slash = path + i;
+        }
+        parent = CEPHFS_LookupDir(path, slash ? slash - path : 0, ret);
+        if (parent == NULL)
+                return NULL;
+        name = slash ? strndup(slash + 1, len - (slash + 1 - path)) : strndup(path, len);
+        *ret = ceph_ll_lookup(cmount, parent, name, &inode, &stx, 0, 0, perms);
+        free(name);
+        if (*ret < 0)
+                return NULL;
+        CEPHFS_CacheInsert(path, len, inode);
+        return inode;
+}
+
+/* the parent inode of the path and its last component, NULL with *ret set on error */
+static Inode *CEPHFS_Parent(const char *path, const char **name, int *ret)
+{
+        const char *p = pfix(path);
+        const char *slash;
+
+        while (*p == '/')
+                p++;
+        slash = strrchr(p, '/');
+        if (slash == NULL) {
+                *name = p;
+                return root;
+        }
+        *name = slash + 1;
+        return CEPHFS_LookupDir(p, slash - p, ret);
+}
+
+/* drops the cached inode of the directory p[0..len) and of everything below it, 0 if it was not cached */
+static int CEPHFS_ForgetDir(const char *p, size_t len)
+{
+        cephfs_dentry_t **e = CEPHFS_CacheFind(p, len);
+        int i;
+
+        /* nothing below a directory is cached unless the directory itself is */
+        if (*e == NULL)
+                return 0;
+        for (i = 0; i < CEPHFS_CACHE_BUCKETS; i++) {
+                e = &inode_cache[i];
+                while (*e != NULL) {
+                        cephfs_dentry_t *d = *e;
+                        if (strncmp(d->path, p, len) == 0 && (d->path[len] == 0 || d->path[len] == '/')) {
+                                *e = d->next;
+                                ceph_ll_put(cmount, d->inode);
+                                free(d->path);
+                                free(d);
+                        } else {
+                                e = &d->next;
+                        }
+                }
+        }
+        return 1;
+}
+
+/* drops the cached inode of a removed directory and of everything below it */
+static void CEPHFS_Forget(const char *path)
+{
+        const char *p = pfix(path);
+
+        while (*p == '/')
+                p++;
+        CEPHFS_ForgetDir(p, strlen(p));
+}
+
+/*
+ * Returns 1 if the error of an operation on path may be caused by a stale
+ * entry of its parents; the topmost cached parent and everything below it
+ * are dropped then, so that the retry looks them up again.
+ */
+static int CEPHFS_Stale(const char *path, int ret)
+{
+        const char *p = pfix(path);
+        const char *c;
+
+        if (ret != -ENOENT && ret != -ESTALE)
+                return 0;
+        while (*p == '/')
+                p++;
+        for (c = strchr(p, '/'); c != NULL; c = strchr(c + 1, '/')) {
+                if (CEPHFS_ForgetDir(p, c - p))
+                        return 1;
+        }
+        return 0;
+}
+
+static void CEPHFS_CacheClear(void)
+{
+        int i;
+
+        for (i = 0; i < CEPHFS_CACHE_BUCKETS; i++) {
+                while (inode_cache[i] != NULL) {
+                        cephfs_dentry_t *d = inode_cache[i];
+                        inode_cache[i] = d->next;
+                        ceph_ll_put(cmount, d->inode);
+                        free(d->path);
+                        free(d);
+                }
+        }
+}
+
+static void CEPHFS_StatxToStat(const struct ceph_statx *stx, struct stat *buf)
+{
+        memset(buf, 0, sizeof(struct stat));
+        buf->st_dev = stx->stx_dev;
+        buf->st_ino = stx->stx_ino;
+        buf->st_mode = stx->stx_mode;
+        buf->st_nlink = stx->stx_nlink;
+        buf->st_uid = stx->stx_uid;
+        buf->st_gid = stx->stx_gid;
+        buf->st_rdev = stx->stx_rdev;
+        buf->st_size = stx->stx_size;
+        buf->st_blksize = stx->stx_blksize;
+        buf->st_blocks = stx->stx_blocks;
+        buf->st_atime = stx->stx_atime.tv_sec;
+        buf->st_mtime = stx->stx_mtime.tv_sec;
+        buf->st_ctime = stx->stx_ctime.tv_sec;
+}
+
+/*
+ * File of the path API (fd) or of the low-level API (inode, fh). Asynchronous
+ * operations use the slots of the window, writes copy their data into the
+ * buffer of the slot, reads transfer into the buffer of the caller directly.
+ */
+#ifdef HAVE_CEPH_LL_NONBLOCKING_READV_WRITEV
+typedef struct {
+        struct ceph_ll_io_info io;
+        struct iovec iov;
+        char *buf;
+        size_t size;                    /* of buf */
+        int busy;
+        int done;                       /* set by the completion callback */
+        double start;
+        double end;
+} CEPHFS_slot_t;
+
+static pthread_mutex_t async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_cond = PTHREAD_COND_INITIALIZER;
+#else
+typedef struct {
+        int busy;
+} CEPHFS_slot_t;
+#endif
+
+typedef struct {
+        int fd;                         /* -1 with the low-level API */
+        Inode *inode;
+        Fh *fh;
+        CEPHFS_slot_t *slots;           /* the window in async mode, NULL otherwise */
+        uint32_t stripe_unit;
+        int inflight;
+} CEPHFS_fd_t;
+
+/* statistics of the asynchronous operations of all files */
+static uint64_t async_ops;
+static int async_max_inflight;
+static double async_latency;
+static double async_max_latency;
+
 static void CEPHFS_Init()
 {
         char *remote_prefix = "/";
@@ -180,8 +443,6 @@ static void CEPHFS_Init()
 
         }
 
-        Inode *root;
-
         /* try retrieving the root cephfs inode */
         ret = ceph_ll_lookup_root(cmount, &root);
         if (ret) {
@@ -189,12 +450,23 @@ static void CEPHFS_Init()
                 ceph_shutdown(cmount);
 
         }
+        perms = ceph_mount_perms(cmount);
 
         return;
 }
 
 static void CEPHFS_Final()
 {
+        if (async_ops > 0 && rank == 0) {
+                fprintf(out_logfile, "CEPHFS async: %" PRIu64 " ops, up to %d in flight, latency mean %.3f ms max %.3f ms on rank 0\n",
+                        async_ops, async_max_inflight, async_latency * 1e3 / async_ops, async_max_latency * 1e3);
+        }
+        if (root != NULL) {
+                CEPHFS_CacheClear();
+                ceph_ll_put(cmount, root);
+                root = NULL;
+        }
+
         /* shutdown */
         int ret = ceph_unmount(cmount);
         if (ret < 0) {
@@ -215,8 +487,9 @@ static aiori_fd_t *CEPHFS_Create(char *path, int flags, aiori_mod_opt_t *options
 static aiori_fd_t *CEPHFS_Open(char *path, int flags, aiori_mod_opt_t *options)
 {
         const char *file = pfix(path);
-        int* fd;
-        fd = (int *)malloc(sizeof(int));
+        CEPHFS_fd_t *fd;
+        fd = (CEPHFS_fd_t *)calloc(1, sizeof(CEPHFS_fd_t));
+        fd->fd = -1;
 
         mode_t mode = 0664;
         int ceph_flags = (int) 0;
@@ -247,12 +520,55 @@ static aiori_fd_t *CEPHFS_Open(char *path, int flags, aiori_mod_opt_t *options)
         if (flags & IOR_DIRECT) {
                 CEPHFS_ERR("O_DIRECT not implemented in CephFS", EINVAL);
         }
-        *fd = ceph_open(cmount, file, ceph_flags, mode);
-        if (*fd < 0) {
-                CEPHFS_ERR("ceph_open failed", *fd);
+        if (CEPHFS_LL) {
+                struct ceph_statx stx;
+                const char *name;
+                Inode *parent;
+                int retried = 0;
+                int ret = 0;
+                do {
+                        parent = CEPHFS_Parent(path, &name, &ret);
+                        if (parent == NULL) {
+                                continue;
+                        }
+                        if (ceph_flags & CEPH_O_CREAT) {
+                                ret = ceph_ll_create(cmount, parent, name, mode, ceph_flags, &fd->inode, &fd->fh, &stx, 0, 0, perms);
+                        } else {
+                                ret = ceph_ll_lookup(cmount, parent, name, &fd->inode, &stx, 0, 0, perms);
+                        }
+                } while (ret < 0 && !retried++ && CEPHFS_Stale(path, ret));
+                if (parent == NULL) {
+                        CEPHFS_ERR("unable to look up the parent directory in CephFS", ret);
+                }
+                if (ceph_flags & CEPH_O_CREAT) {
+                        if (ret < 0) {
+                                CEPHFS_ERR("ceph_ll_create failed", ret);
+                        }
+                } else {
+                        if (ret < 0) {
+                                CEPHFS_ERR("ceph_ll_lookup failed", ret);
+                        }
+                        ret = ceph_ll_open(cmount, fd->inode, ceph_flags, &fd->fh, perms);
+                        if (ret < 0) {
+                                CEPHFS_ERR("ceph_ll_open failed", ret);
+                        }
+                }
+                if (o.olazy == TRUE && ceph_ll_lazyio(cmount, fd->fh, 1) != 0) {
+                        WARN("Error enabling lazy mode");
+                }
+                if (o.async) {
+                        /* the operations are split at the object boundaries */
+                        fd->stripe_unit = ceph_ll_stripe_unit(cmount, fd->inode);
+                        fd->slots = calloc(o.window, sizeof(CEPHFS_slot_t));
+                }
+                return (void *) fd;
+        }
+        fd->fd = ceph_open(cmount, file, ceph_flags, mode);
+        if (fd->fd < 0) {
+                CEPHFS_ERR("ceph_open failed", fd->fd);
         }
         if (o.olazy == TRUE) {
-                int ret = ceph_lazyio(cmount, *fd, 1);
+                int ret = ceph_lazyio(cmount, fd->fd, 1);
                 if (ret != 0) {
                         WARN("Error enabling lazy mode");
                 }
@@ -260,17 +576,177 @@ static aiori_fd_t *CEPHFS_Open(char *path, int flags, aiori_mod_opt_t *options)
         return (void *) fd;
 }
 
+#ifdef HAVE_CEPH_LL_NONBLOCKING_READV_WRITEV
+static void CEPHFS_Complete(struct ceph_ll_io_info *io)
+{
+        CEPHFS_slot_t *slot = (CEPHFS_slot_t *) io->priv;
+
+        pthread_mutex_lock(&async_lock);
+        slot->end = GetTimeStamp();
+        slot->done = 1;
+        pthread_cond_broadcast(&async_cond);
+        pthread_mutex_unlock(&async_lock);
+}
+
+/* waits for the operation of the slot and checks its result */
+static void CEPHFS_Reap(CEPHFS_fd_t *fd, CEPHFS_slot_t *slot)
+{
+        double latency;
+
+        pthread_mutex_lock(&async_lock);
+        while (!slot->done) {
+                pthread_cond_wait(&async_cond, &async_lock);
+        }
+        pthread_mutex_unlock(&async_lock);
+        slot->busy = 0;
+        fd->inflight--;
+        latency = slot->end - slot->start;
+        async_ops++;
+        async_latency += latency;
+        if (latency > async_max_latency) {
+                async_max_latency = latency;
+        }
+        if (slot->io.result < 0) {
+                CEPHFS_ERR(slot->io.write ? "unable to write file to CephFS" : "unable to read file from CephFS", slot->io.result);
+        } else if (slot->io.result < (int64_t) slot->iov.iov_len) {
+                ERR(slot->io.write ? "short write to CephFS" : "short read from CephFS");
+        }
+}
+
+/* returns a free slot, reaps a completed or else the oldest operation if the window is full */
+static CEPHFS_slot_t *CEPHFS_FreeSlot(CEPHFS_fd_t *fd)
+{
+        CEPHFS_slot_t *oldest = NULL;
+        CEPHFS_slot_t *done = NULL;
+        int i;
+
+        for (i = 0; i < o.window; i++) {
+                if (!fd->slots[i].busy) {
+                        return &fd->slots[i];
+                }
+        }
+        pthread_mutex_lock(&async_lock);
+        for (i = 0; i < o.window && done == NULL; i++) {
+                if (fd->slots[i].done) {
+                        done = &fd->slots[i];
+                }
+                if (oldest == NULL || fd->slots[i].start < oldest->start) {
+                        oldest = &fd->slots[i];
+                }
+        }
+        pthread_mutex_unlock(&async_lock);
+        if (done != NULL) {
+                oldest = done;
+        }
+        CEPHFS_Reap(fd, oldest);
+        return oldest;
+}
+
+static void CEPHFS_Post(CEPHFS_fd_t *fd, int write, char *data, size_t length, int64_t offset)
+{
+        CEPHFS_slot_t *slot = CEPHFS_FreeSlot(fd);
+        int64_t ret;
+
+        if (write) {
+                /* the caller may reuse its buffer once the transfer returns */
+                if (slot->size < length) {
+                        free(slot->buf);
+                        slot->buf = safeMalloc(length);
+                        slot->size = length;
+                }
+                memcpy(slot->buf, data, length);
+                slot->iov.iov_base = slot->buf;
+        } else {
+                slot->iov.iov_base = data;
+        }
+        slot->iov.iov_len = length;
+        memset(&slot->io, 0, sizeof(slot->io));
+        slot->io.callback = CEPHFS_Complete;
+        slot->io.priv = slot;
+        slot->io.fh = fd->fh;
+        slot->io.iov = &slot->iov;
+        slot->io.iovcnt = 1;
+        slot->io.off = offset;
+        slot->io.write = write;
+        slot->busy = 1;
+        slot->done = 0;
+        slot->start = GetTimeStamp();
+        fd->inflight++;
+        if (fd->inflight > async_max_inflight) {
+                async_max_inflight = fd->inflight;
+        }
+        ret = ceph_ll_nonblocking_readv_writev(cmount, &slot->io);
+        if (ret < 0) {
+                CEPHFS_ERR("unable to submit asynchronous I/O to CephFS", ret);
+        }
+}
+#endif
+
+/* waits for all asynchronous operations of the file */
+static void CEPHFS_Drain(CEPHFS_fd_t *fd)
+{
+#ifdef HAVE_CEPH_LL_NONBLOCKING_READV_WRITEV
+        int i;
+
+        if (fd->slots == NULL) {
+                return;
+        }
+        for (i = 0; i < o.window; i++) {
+                if (fd->slots[i].busy) {
+                        CEPHFS_Reap(fd, &fd->slots[i]);
+                }
+        }
+#endif
+}
+
+/*
+ * Asynchronous transfers are split at the boundaries of the stripe units, so
+ * the pieces go to different objects concurrently. Writes return once their
+ * operations are submitted, reads (including the check reads) once all their
+ * operations completed.
+ */
+static void CEPHFS_AsyncXfer(int access, CEPHFS_fd_t *fd, char *buf, uint64_t size, int64_t offset)
+{
+#ifdef HAVE_CEPH_LL_NONBLOCKING_READV_WRITEV
+        uint64_t pos = 0;
+
+        while (pos < size) {
+                uint64_t len = size - pos;
+                if (fd->stripe_unit > 0 && len > fd->stripe_unit - (offset + pos) % fd->stripe_unit) {
+                        len = fd->stripe_unit - (offset + pos) % fd->stripe_unit;
+                }
+                CEPHFS_Post(fd, access == WRITE, buf + pos, len, offset + pos);
+                pos += len;
+        }
+        if (access != WRITE) {
+                CEPHFS_Drain(fd);
+        }
+#endif
+}
+
 static IOR_offset_t CEPHFS_Xfer(int access, aiori_fd_t *file, IOR_size_t *buffer,
                            IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t *options)
 {
         uint64_t size = (uint64_t) length;
         char *buf = (char *) buffer;
-        int fd = *(int *) file;
+        CEPHFS_fd_t *fd = (CEPHFS_fd_t *) file;
         int ret;
 
+        if (fd->slots != NULL) {
+                CEPHFS_AsyncXfer(access, fd, buf, size, offset);
+                if (access == WRITE && hints->fsyncPerWrite == TRUE) {
+                        CEPHFS_Fsync(file, options);
+                }
+                return length;
+        }
+
         if (access == WRITE)
         {
-                ret = ceph_write(cmount, fd, buf, size, offset);
+                if (fd->fh != NULL) {
+                        ret = ceph_ll_write(cmount, fd->fh, offset, size, buf);
+                } else {
+                        ret = ceph_write(cmount, fd->fd, buf, size, offset);
+                }
                 if (ret < 0) {
                         CEPHFS_ERR("unable to write file to CephFS", ret);
                 } else if (ret < size) {
@@ -282,7 +758,11 @@ static IOR_offset_t CEPHFS_Xfer(int access, aiori_fd_t *file, IOR_size_t *buffer
         }
         else /* READ */
         {
-                ret = ceph_read(cmount, fd, buf, size, offset);
+                if (fd->fh != NULL) {
+                        ret = ceph_ll_read(cmount, fd->fh, offset, size, buf);
+                } else {
+                        ret = ceph_read(cmount, fd->fd, buf, size, offset);
+                }
                 if (ret < 0) {
                         CEPHFS_ERR("unable to read file from CephFS", ret);
                 } else if (ret < size) {
@@ -295,8 +775,15 @@ static IOR_offset_t CEPHFS_Xfer(int access, aiori_fd_t *file, IOR_size_t *buffer
 
 static void CEPHFS_Fsync(aiori_fd_t *file, aiori_mod_opt_t *options)
 {
-        int fd = *(int *) file;
-        int ret = ceph_fsync(cmount, fd, 0);
+        CEPHFS_fd_t *fd = (CEPHFS_fd_t *) file;
+        int ret;
+
+        if (fd->fh != NULL) {
+                CEPHFS_Drain(fd);
+                ret = ceph_ll_fsync(cmount, fd->fh, 0);
+        } else {
+                ret = ceph_fsync(cmount, fd->fd, 0);
+        }
         if (ret < 0) {
                 CEPHFS_ERR("ceph_fsync failed", ret);
         }
@@ -304,8 +791,25 @@ static void CEPHFS_Fsync(aiori_fd_t *file, aiori_mod_opt_t *options)
 
 static void CEPHFS_Close(aiori_fd_t *file, aiori_mod_opt_t *options)
 {
-        int fd = *(int *) file;
-        int ret = ceph_close(cmount, fd);
+        CEPHFS_fd_t *fd = (CEPHFS_fd_t *) file;
+        int ret;
+
+        if (fd->fh != NULL) {
+                CEPHFS_Drain(fd);
+                if (fd->slots != NULL) {
+#ifdef HAVE_CEPH_LL_NONBLOCKING_READV_WRITEV
+                        int i;
+                        for (i = 0; i < o.window; i++) {
+                                free(fd->slots[i].buf);
+                        }
+#endif
+                        free(fd->slots);
+                }
+                ret = ceph_ll_close(cmount, fd->fh);
+                ceph_ll_put(cmount, fd->inode);
+        } else {
+                ret = ceph_close(cmount, fd->fd);
+        }
         if (ret < 0) {
                 CEPHFS_ERR("ceph_close failed", ret);
         }
@@ -315,7 +819,24 @@ static void CEPHFS_Close(aiori_fd_t *file, aiori_mod_opt_t *options)
 
 static void CEPHFS_Delete(char *path, aiori_mod_opt_t *options)
 {
-        int ret = ceph_unlink(cmount, pfix(path));
+        int ret;
+
+        if (CEPHFS_LL) {
+                const char *name;
+                Inode *parent;
+                int retried = 0;
+                do {
+                        parent = CEPHFS_Parent(path, &name, &ret);
+                        if (parent != NULL) {
+                                ret = ceph_ll_unlink(cmount, parent, name, perms);
+                        }
+                } while (ret < 0 && !retried++ && CEPHFS_Stale(path, ret));
+                if (parent == NULL) {
+                        CEPHFS_ERR("unable to look up the parent directory in CephFS", ret);
+                }
+        } else {
+                ret = ceph_unlink(cmount, pfix(path));
+        }
         if (ret < 0) {
                 CEPHFS_ERR("ceph_unlink failed", ret);
         }
@@ -382,22 +903,82 @@ static int CEPHFS_StatFS(const char *path, ior_aiori_statfs_t *stat_buf, aiori_m
 
 static int CEPHFS_MkDir(const char *path, mode_t mode, aiori_mod_opt_t *options)
 {
+        if (CEPHFS_LL) {
+                struct ceph_statx stx;
+                const char *name;
+                Inode *inode;
+                Inode *parent;
+                int retried = 0;
+                int ret = 0;
+                do {
+                        parent = CEPHFS_Parent(path, &name, &ret);
+                        if (parent != NULL) {
+                                ret = ceph_ll_mkdir(cmount, parent, name, mode, &inode, &stx, 0, 0, perms);
+                        }
+                } while (ret < 0 && !retried++ && CEPHFS_Stale(path, ret));
+                if (ret == 0) {
+                        /* new directories are likely parents of the next calls */
+                        const char *p = pfix(path);
+                        while (*p == '/') {
+                                p++;
+                        }
+                        CEPHFS_CacheInsert(p, strlen(p), inode);
+                }
+                return ret;
+        }
         return ceph_mkdir(cmount, pfix(path), mode);
 }
 
 static int CEPHFS_RmDir(const char *path, aiori_mod_opt_t *options)
 {
+        if (CEPHFS_LL) {
+                const char *name;
+                Inode *parent;
+                int retried = 0;
+                int ret = 0;
+                do {
+                        parent = CEPHFS_Parent(path, &name, &ret);
+                        if (parent != NULL) {
+                                ret = ceph_ll_rmdir(cmount, parent, name, perms);
+                        }
+                } while (ret < 0 && !retried++ && CEPHFS_Stale(path, ret));
+                if (ret == 0) {
+                        CEPHFS_Forget(path);
+                }
+                return ret;
+        }
         return ceph_rmdir(cmount, pfix(path));
 }
 
 static int CEPHFS_Access(const char *path, int mode, aiori_mod_opt_t *options)
 {
         struct stat buf;
-        return ceph_stat(cmount, pfix(path), &buf);
+        return CEPHFS_Stat(path, &buf, options);
 }
 
 static int CEPHFS_Stat(const char *path, struct stat *buf, aiori_mod_opt_t *options)
 {
+        if (CEPHFS_LL) {
+                struct ceph_statx stx;
+                const char *name;
+                Inode *inode;
+                Inode *parent;
+                int retried = 0;
+                int ret = 0;
+                do {
+                        parent = CEPHFS_Parent(path, &name, &ret);
+                        if (parent != NULL) {
+                                /* the lookup returns the attributes as well */
+                                ret = ceph_ll_lookup(cmount, parent, name, &inode, &stx, CEPH_STATX_BASIC_STATS, 0, perms);
+                        }
+                } while (ret < 0 && !retried++ && CEPHFS_Stale(path, ret));
+                if (ret < 0) {
+                        return ret;
+                }
+                CEPHFS_StatxToStat(&stx, buf);
+                ceph_ll_put(cmount, inode);
+                return 0;
+        }
         return ceph_stat(cmount, pfix(path), buf);
 }
 
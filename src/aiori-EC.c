@@ -0,0 +1,621 @@
+/*
+ This backend stripes each file across K data and M parity target files, which are
+ accessed with another backend (POSIX by default). The stripe unit is the granularity of the striping;
+ the columns of a stripe rotate across the targets. Parity is computed with XOR (M = 1)
+ or a Reed-Solomon code over GF(2^8) with a Cauchy matrix, using AVX2 if available.
+ Targets can be marked as failed: they are not accessed and reads reconstruct the
+ data from the parity.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#  define EC_X86
+#  include <immintrin.h>
+#endif
+
+#include "ior.h"
+#include "aiori.h"
+#include "iordef.h"
+#include "utilities.h"
+
+/************************** O P T I O N S *****************************/
+typedef struct{
+  char * backend_name; // the backend of the targets
+  char * targets;      // target directories separated by @
+  char * code;         // xor or rs
+  char * failed;       // failed targets separated by ,
+  int k;
+  int m;
+  int stripe_unit;
+  int scalar;
+
+  // runtime data
+  int n;                  // number of targets, k + m
+  const ior_aiori_t * backend;
+  aiori_mod_opt_t * backend_options;
+  char ** dirs;           // NULL if the targets are stored next to the file
+  char * dirs_buf;        // the copy of targets that dirs point into
+  int * is_failed;
+  unsigned char * matrix; // m x k coefficients of the parity
+} ec_options_t;
+
+option_help * ec_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t * init_values){
+  ec_options_t * o = malloc(sizeof(ec_options_t));
+
+  if (init_values != NULL){
+    memcpy(o, init_values, sizeof(ec_options_t));
+    /* the runtime data is allocated per options by check_params */
+    o->dirs = NULL;
+    o->dirs_buf = NULL;
+    o->is_failed = NULL;
+    o->matrix = NULL;
+    o->backend = NULL;
+    o->backend_options = NULL;
+  }else{
+    memset(o, 0, sizeof(ec_options_t));
+    o->backend_name = "POSIX";
+    o->code = "xor";
+    o->k = 4;
+    o->m = 1;
+    o->stripe_unit = 65536;
+  }
+  *init_backend_options = (aiori_mod_opt_t*) o;
+
+  option_help h [] = {
+    {0, "ec.k", "Number of data targets", OPTION_OPTIONAL_ARGUMENT, 'd', & o->k},
+    {0, "ec.m", "Number of parity targets", OPTION_OPTIONAL_ARGUMENT, 'd', & o->m},
+    {0, "ec.code", "Parity code: xor (m = 1) or rs (Reed-Solomon)", OPTION_OPTIONAL_ARGUMENT, 's', & o->code},
+    {0, "ec.stripeUnit", "Bytes per target in a stripe, the transfer size must be a multiple of k * stripeUnit", OPTION_OPTIONAL_ARGUMENT, 'd', & o->stripe_unit},
+    {0, "ec.backend", "Backend of the targets, its options are set with its own prefix", OPTION_OPTIONAL_ARGUMENT, 's', & o->backend_name},
+    {0, "ec.targets", "k + m target directories separated by @, by default the targets are stored next to the file", OPTION_OPTIONAL_ARGUMENT, 's', & o->targets},
+    {0, "ec.failed", "Failed targets (0 to k + m - 1) separated by comma, they are not accessed and reads reconstruct their data", OPTION_OPTIONAL_ARGUMENT, 's', & o->failed},
+    {0, "ec.scalar", "Compute the parity without SIMD", OPTION_FLAG, 'd', & o->scalar},
+    LAST_OPTION
+  };
+  option_help * help = malloc(sizeof(h));
+  memcpy(help, h, sizeof(h));
+  return help;
+}
+
+
+/************************** D E C L A R A T I O N S ***************************/
+
+typedef struct{
+  aiori_fd_t ** pfd;         // the fd of the backend per target, NULL if failed
+  unsigned char ** parity;   // m stripe units
+} ec_fd_t;
+
+/***************************** F U N C T I O N S ******************************/
+
+static aiori_xfer_hint_t * hints = NULL;
+static const ior_aiori_t * backend = NULL; // the backend of the targets, set by check_params
+
+/* CPU time of the encoding and decoding, reported on close */
+static struct {
+  double encode_time;
+  double decode_time;
+  uint64_t encoded;
+  uint64_t decoded;
+} stats;
+
+static void ec_xfer_hints(aiori_xfer_hint_t * params){
+  hints = params;
+  if(backend != NULL && backend->xfer_hints){
+    backend->xfer_hints(params);
+  }
+}
+
+/* GF(2^8) with the polynomial 0x11d */
+static unsigned char gf_exp[512];
+static unsigned char gf_log[256];
+static unsigned char gf_mul_table[256][256];
+static int use_avx2 = 0;
+
+static unsigned char gf_mul(unsigned char a, unsigned char b){
+  if(a == 0 || b == 0){
+    return 0;
+  }
+  return gf_exp[gf_log[a] + gf_log[b]];
+}
+
+static unsigned char gf_inv(unsigned char a){
+  return gf_exp[255 - gf_log[a]];
+}
+
+static void gf_init(void){
+  int x = 1;
+  for(int i = 0; i < 255; i++){
+    gf_exp[i] = x;
+    gf_exp[i + 255] = x;
+    gf_log[x] = i;
+    x <<= 1;
+    if(x & 0x100){
+      x ^= 0x11d;
+    }
+  }
+  for(int a = 0; a < 256; a++){
+    for(int b = 0; b < 256; b++){
+      gf_mul_table[a][b] = gf_mul(a, b);
+    }
+  }
+}
+
+#ifdef EC_X86
+__attribute__((target("avx2")))
+static size_t ec_mul_add_avx2(unsigned char * dst, const unsigned char * src, unsigned char c, size_t len){
+  unsigned char lo[16], hi[16];
+  size_t i;
+  for(i = 0; i < 16; i++){
+    lo[i] = gf_mul_table[c][i];
+    hi[i] = gf_mul_table[c][i << 4];
+  }
+  const __m256i tlo = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*) lo));
+  const __m256i thi = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*) hi));
+  const __m256i mask = _mm256_set1_epi8(0x0f);
+  for(i = 0; i + 32 <= len; i += 32){
+    __m256i x = _mm256_loadu_si256((__m256i*) (src + i));
+    __m256i d = _mm256_loadu_si256((__m256i*) (dst + i));
+    if(c != 1){
+      __m256i l = _mm256_shuffle_epi8(tlo, _mm256_and_si256(x, mask));
+      __m256i h = _mm256_shuffle_epi8(thi, _mm256_and_si256(_mm256_srli_epi64(x, 4), mask));
+      x = _mm256_xor_si256(l, h);
+    }
+    _mm256_storeu_si256((__m256i*) (dst + i), _mm256_xor_si256(d, x));
+  }
+  return i;
+}
+#endif
+
+/* dst += c * src */
+static void ec_mul_add(unsigned char * dst, const unsigned char * src, unsigned char c, size_t len){
+  size_t i = 0;
+  if(c == 0){
+    return;
+  }
+#ifdef EC_X86
+  if(use_avx2){
+    i = ec_mul_add_avx2(dst, src, c, len);
+  }
+#endif
+  if(c == 1){
+    for(; i + 8 <= len; i += 8){
+      uint64_t a, b;
+      memcpy(& a, dst + i, 8);
+      memcpy(& b, src + i, 8);
+      a ^= b;
+      memcpy(dst + i, & a, 8);
+    }
+    for(; i < len; i++){
+      dst[i] ^= src[i];
+    }
+    return;
+  }
+  const unsigned char * t = gf_mul_table[c];
+  for(; i < len; i++){
+    dst[i] ^= t[src[i]];
+  }
+}
+
+/* Gauss-Jordan elimination of the k x k matrix a, which is destroyed */
+static void gf_invert(unsigned char * a, unsigned char * inv, int k){
+  memset(inv, 0, k * k);
+  for(int i = 0; i < k; i++){
+    inv[i * k + i] = 1;
+  }
+  for(int c = 0; c < k; c++){
+    int r = c;
+    while(r < k && a[r * k + c] == 0){
+      r++;
+    }
+    if(r == k){
+      ERR("EC decoding matrix is singular");
+    }
+    if(r != c){
+      for(int j = 0; j < k; j++){
+        unsigned char t = a[r * k + j]; a[r * k + j] = a[c * k + j]; a[c * k + j] = t;
+        t = inv[r * k + j]; inv[r * k + j] = inv[c * k + j]; inv[c * k + j] = t;
+      }
+    }
+    unsigned char f = gf_inv(a[c * k + c]);
+    for(int j = 0; j < k; j++){
+      a[c * k + j] = gf_mul(a[c * k + j], f);
+      inv[c * k + j] = gf_mul(inv[c * k + j], f);
+    }
+    for(r = 0; r < k; r++){
+      unsigned char e = a[r * k + c];
+      if(r == c || e == 0){
+        continue;
+      }
+      for(int j = 0; j < k; j++){
+        a[r * k + j] ^= gf_mul(e, a[c * k + j]);
+        inv[r * k + j] ^= gf_mul(e, inv[c * k + j]);
+      }
+    }
+  }
+}
+
+static int ec_check_params(aiori_mod_opt_t * param){
+  ec_options_t * o = (ec_options_t*) param;
+  o->backend = aiori_select(o->backend_name);
+  if(o->backend == NULL){
+    ERRF("Unknown EC backend %s", o->backend_name);
+  }
+  if(o->backend == & ec_aiori){
+    ERR("EC cannot use itself as the backend of the targets");
+  }
+  if(! o->backend->create || ! o->backend->open || ! o->backend->xfer || ! o->backend->close || ! o->backend->remove || ! o->backend->get_file_size){
+    ERRF("EC backend %s does not support files", o->backend->name);
+  }
+  backend = o->backend;
+  o->backend_options = aiori_module_options(backend);
+  if(backend->xfer_hints && hints != NULL){
+    backend->xfer_hints(hints);
+  }
+  if(backend->check_params){
+    backend->check_params(o->backend_options);
+  }
+  if(o->k < 1 || o->m < 1){
+    ERRF("EC k = %d and m = %d must be at least 1", o->k, o->m);
+  }
+  if(o->k + o->m > 256){
+    ERRF("EC supports up to 256 targets, k + m = %d", o->k + o->m);
+  }
+  if(o->stripe_unit < 1){
+    ERR("EC stripeUnit must be positive");
+  }
+  if(strcmp(o->code, "xor") == 0){
+    if(o->m != 1){
+      ERR("EC xor code supports m = 1 only, use rs");
+    }
+  }else if(strcmp(o->code, "rs") != 0){
+    ERRF("Unknown EC code %s, use xor or rs", o->code);
+  }
+  if(hints != NULL && hints->transferSize % ((IOR_offset_t) o->k * o->stripe_unit) != 0){
+    ERRF("EC transfer size %lld must be a multiple of k * stripeUnit = %lld", (long long) hints->transferSize, (long long) o->k * o->stripe_unit);
+  }
+  o->n = o->k + o->m;
+
+  /* check_params runs for every test with the same options */
+  free(o->dirs);
+  free(o->dirs_buf);
+  free(o->is_failed);
+  free(o->matrix);
+  o->dirs = NULL;
+  o->dirs_buf = NULL;
+  if(o->targets != NULL && o->targets[0] != 0){
+    char * saveptr = NULL;
+    int count = 0;
+    o->dirs_buf = strdup(o->targets);
+    o->dirs = safeMalloc(sizeof(char*) * o->n);
+    for(char * d = strtok_r(o->dirs_buf, "@", & saveptr); d != NULL; d = strtok_r(NULL, "@", & saveptr)){
+      if(count == o->n){
+        ERRF("EC needs k + m = %d target directories, got more", o->n);
+      }
+      o->dirs[count++] = d;
+    }
+    if(count != o->n){
+      ERRF("EC needs k + m = %d target directories, got %d", o->n, count);
+    }
+  }
+
+  o->is_failed = safeMalloc(sizeof(int) * o->n);
+  memset(o->is_failed, 0, sizeof(int) * o->n);
+  if(o->failed != NULL && o->failed[0] != 0){
+    char * tmp = strdup(o->failed);
+    char * saveptr = NULL;
+    int count = 0;
+    for(char * t = strtok_r(tmp, ",", & saveptr); t != NULL; t = strtok_r(NULL, ",", & saveptr)){
+      int target = atoi(t);
+      if(target < 0 || target >= o->n){
+        ERRF("EC failed target %s is not in 0 to %d", t, o->n - 1);
+      }
+      if(! o->is_failed[target]){
+        count++;
+      }
+      o->is_failed[target] = 1;
+    }
+    free(tmp);
+    if(count > o->m){
+      ERRF("EC can tolerate at most m = %d failed targets, got %d", o->m, count);
+    }
+  }
+
+  gf_init();
+  /* the Cauchy matrix 1 / (x_i + y_j) with x_i = i, y_j = m + j, any k rows of [I; C] are invertible */
+  o->matrix = safeMalloc(o->m * o->k);
+  for(int i = 0; i < o->m; i++){
+    for(int j = 0; j < o->k; j++){
+      o->matrix[i * o->k + j] = o->code[0] == 'x' ? 1 : gf_inv(i ^ (o->m + j));
+    }
+  }
+#ifdef EC_X86
+  use_avx2 = ! o->scalar && __builtin_cpu_supports("avx2");
+#endif
+  return 0;
+}
+
+static char * ec_target_name(ec_options_t * o, char * testFileName, int target){
+  char * name = safeMalloc(strlen(testFileName) + (o->dirs ? strlen(o->dirs[target]) + 1 : 0) + 16);
+  if(o->dirs){
+    char * base = strrchr(testFileName, '/');
+    sprintf(name, "%s/%s.ec%d", o->dirs[target], base ? base + 1 : testFileName, target);
+  }else{
+    sprintf(name, "%s.ec%d", testFileName, target);
+  }
+  return name;
+}
+
+/* the first target that is not failed */
+static int ec_first_target(ec_options_t * o){
+  int t = 0;
+  while(o->is_failed[t]){
+    t++;
+  }
+  return t;
+}
+
+static void ec_initialize(aiori_mod_opt_t * param){
+  ec_options_t * o = (ec_options_t*) param;
+  if(o->backend->initialize){
+    o->backend->initialize(o->backend_options);
+  }
+}
+
+static void ec_finalize(aiori_mod_opt_t * param){
+  ec_options_t * o = (ec_options_t*) param;
+  if(o->backend->finalize){
+    o->backend->finalize(o->backend_options);
+  }
+}
+
+static ec_fd_t * ec_open(char *testFileName, int flags, ec_options_t * o, int create){
+  ec_fd_t * fd = safeMalloc(sizeof(ec_fd_t));
+  fd->pfd = safeMalloc(sizeof(aiori_fd_t*) * o->n);
+  for(int t = 0; t < o->n; t++){
+    fd->pfd[t] = NULL;
+    if(o->is_failed[t]){
+      continue;
+    }
+    char * name = ec_target_name(o, testFileName, t);
+    fd->pfd[t] = create ? o->backend->create(name, flags, o->backend_options) : o->backend->open(name, flags, o->backend_options);
+    free(name);
+  }
+  fd->parity = safeMalloc(sizeof(unsigned char*) * o->m);
+  for(int i = 0; i < o->m; i++){
+    fd->parity[i] = aligned_buffer_alloc(o->stripe_unit, IOR_MEMORY_TYPE_CPU);
+  }
+  return fd;
+}
+
+static aiori_fd_t *ec_Open(char *testFileName, int flags, aiori_mod_opt_t * param){
+  return (aiori_fd_t*) ec_open(testFileName, flags, (ec_options_t*) param, 0);
+}
+
+static aiori_fd_t *ec_Create(char *testFileName, int flags, aiori_mod_opt_t * param){
+  return (aiori_fd_t*) ec_open(testFileName, flags, (ec_options_t*) param, 1);
+}
+
+static void ec_io(int access, ec_fd_t * fd, int target, unsigned char * ptr, IOR_offset_t offset, ec_options_t * o){
+  IOR_offset_t ret = o->backend->xfer(access, fd->pfd[target], (IOR_size_t*) ptr, o->stripe_unit, offset, o->backend_options);
+  if(ret != o->stripe_unit){
+    ERRF("EC %s of %d bytes at offset %lld of target %d returned %lld", access == WRITE ? "write" : "read", o->stripe_unit, (long long) offset, target, (long long) ret);
+  }
+}
+
+/* reconstruct the missing data columns of a stripe from the parity columns that were read, rows are their parity rows */
+static void ec_decode(ec_options_t * o, ec_fd_t * fd, unsigned char * data, int * missing, int * rows){
+  int k = o->k;
+  unsigned char a[k * k];
+  unsigned char inv[k * k];
+  unsigned char * src[k];
+  int p = 0;
+
+  for(int r = 0; r < k; r++){
+    if(! missing[r]){
+      memset(& a[r * k], 0, k);
+      a[r * k + r] = 1;
+      src[r] = data + (size_t) r * o->stripe_unit;
+    }else{
+      memcpy(& a[r * k], & o->matrix[rows[p] * k], k);
+      src[r] = fd->parity[p];
+      p++;
+    }
+  }
+  gf_invert(a, inv, k);
+  for(int j = 0; j < k; j++){
+    if(! missing[j]){
+      continue;
+    }
+    unsigned char * dst = data + (size_t) j * o->stripe_unit;
+    memset(dst, 0, o->stripe_unit);
+    for(int r = 0; r < k; r++){
+      ec_mul_add(dst, src[r], inv[j * k + r], o->stripe_unit);
+    }
+  }
+}
+
+static IOR_offset_t ec_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer,
+                               IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param){
+  ec_options_t * o = (ec_options_t*) param;
+  ec_fd_t * fd = (ec_fd_t*) file;
+  IOR_offset_t u = o->stripe_unit;
+  IOR_offset_t width = o->k * u;
+
+  if(hints->dryRun)
+    return length;
+  if(offset % width != 0 || length % width != 0){
+    ERRF("EC access of %lld bytes at offset %lld is not aligned to k * stripeUnit = %lld", (long long) length, (long long) offset, (long long) width);
+  }
+
+  for(IOR_offset_t i = 0; i < length / width; i++){
+    IOR_offset_t stripe = offset / width + i;
+    unsigned char * data = (unsigned char*) buffer + i * width;
+    /* column c of the stripe is stored on target (c + stripe) % n */
+    if(access == WRITE){
+      double start = GetTimeStamp();
+      for(int p = 0; p < o->m; p++){
+        memset(fd->parity[p], 0, u);
+        for(int j = 0; j < o->k; j++){
+          ec_mul_add(fd->parity[p], data + j * u, o->matrix[p * o->k + j], u);
+        }
+      }
+      stats.encode_time += GetTimeStamp() - start;
+      stats.encoded += width;
+      for(int c = 0; c < o->n; c++){
+        int target = (c + stripe) % o->n;
+        if(fd->pfd[target] != NULL){
+          ec_io(WRITE, fd, target, c < o->k ? data + c * u : fd->parity[c - o->k], stripe * u, o);
+        }
+      }
+    }else{
+      int missing[o->k];
+      int missing_count = 0;
+      for(int j = 0; j < o->k; j++){
+        int target = (j + stripe) % o->n;
+        missing[j] = fd->pfd[target] == NULL;
+        if(missing[j]){
+          missing_count++;
+        }else{
+          ec_io(READ, fd, target, data + j * u, stripe * u, o);
+        }
+      }
+      if(missing_count == 0){
+        continue;
+      }
+      /* read as many parity columns as data columns are missing */
+      int rows[o->m];
+      int p = 0;
+      for(int c = o->k; c < o->n && p < missing_count; c++){
+        int target = (c + stripe) % o->n;
+        if(fd->pfd[target] == NULL){
+          continue;
+        }
+        ec_io(READ, fd, target, fd->parity[p], stripe * u, o);
+        rows[p++] = c - o->k;
+      }
+      double start = GetTimeStamp();
+      ec_decode(o, fd, data, missing, rows);
+      stats.decode_time += GetTimeStamp() - start;
+      stats.decoded += missing_count * u;
+    }
+  }
+  return length;
+}
+
+static void ec_Close(aiori_fd_t *file, aiori_mod_opt_t * param){
+  ec_options_t * o = (ec_options_t*) param;
+  ec_fd_t * fd = (ec_fd_t*) file;
+  for(int t = 0; t < o->n; t++){
+    if(fd->pfd[t] != NULL){
+      o->backend->close(fd->pfd[t], o->backend_options);
+    }
+  }
+  for(int i = 0; i < o->m; i++){
+    aligned_buffer_free(fd->parity[i], IOR_MEMORY_TYPE_CPU);
+  }
+  free(fd->parity);
+  free(fd->pfd);
+  free(fd);
+
+  if(rank == 0 && (stats.encoded > 0 || stats.decoded > 0)){
+    fprintf(out_logfile, "EC %d+%d %s%s: encode %.3f s (%.1f MiB/s), decode %.3f s (%.1f MiB/s) on rank 0\n",
+            o->k, o->m, o->code, use_avx2 ? " avx2" : "",
+            stats.encode_time, stats.encode_time > 0 ? stats.encoded / stats.encode_time / MEBIBYTE : 0.0,
+            stats.decode_time, stats.decode_time > 0 ? stats.decoded / stats.decode_time / MEBIBYTE : 0.0);
+  }
+  memset(& stats, 0, sizeof(stats));
+}
+
+static void ec_Fsync(aiori_fd_t *file, aiori_mod_opt_t * param){
+  ec_options_t * o = (ec_options_t*) param;
+  ec_fd_t * fd = (ec_fd_t*) file;
+  for(int t = 0; t < o->n; t++){
+    if(fd->pfd[t] != NULL && o->backend->fsync){
+      o->backend->fsync(fd->pfd[t], o->backend_options);
+    }
+  }
+}
+
+static void ec_Sync(aiori_mod_opt_t * param){
+  ec_options_t * o = (ec_options_t*) param;
+  if(o->backend->sync){
+    o->backend->sync(o->backend_options);
+  }
+}
+
+static void ec_Delete(char *testFileName, aiori_mod_opt_t * param){
+  ec_options_t * o = (ec_options_t*) param;
+  for(int t = 0; t < o->n; t++){
+    char * name = ec_target_name(o, testFileName, t);
+    if(! o->is_failed[t]){
+      o->backend->remove(name, o->backend_options);
+    }else if(! hints->dryRun && o->backend->access && o->backend->access(name, F_OK, o->backend_options) == 0){
+      /* the target may have been written before it was marked as failed */
+      o->backend->remove(name, o->backend_options);
+    }
+    free(name);
+  }
+}
+
+static IOR_offset_t ec_GetFileSize(aiori_mod_opt_t * param, char *testFileName){
+  ec_options_t * o = (ec_options_t*) param;
+  char * name = ec_target_name(o, testFileName, ec_first_target(o));
+  /* every target stores one stripe unit per stripe */
+  IOR_offset_t size = o->backend->get_file_size(o->backend_options, name) * o->k;
+  free(name);
+  return size;
+}
+
+static int ec_access(const char *path, int mode, aiori_mod_opt_t * param){
+  ec_options_t * o = (ec_options_t*) param;
+  char * name = ec_target_name(o, (char*) path, ec_first_target(o));
+  int ret = o->backend->access ? o->backend->access(name, mode, o->backend_options) : access(name, mode);
+  free(name);
+  return ret;
+}
+
+static int ec_stat(const char *path, struct stat *buf, aiori_mod_opt_t * param){
+  ec_options_t * o = (ec_options_t*) param;
+  char * name = ec_target_name(o, (char*) path, ec_first_target(o));
+  int ret = o->backend->stat ? o->backend->stat(name, buf, o->backend_options) : stat(name, buf);
+  free(name);
+  if(ret == 0){
+    buf->st_size *= o->k;
+  }
+  return ret;
+}
+
+ior_aiori_t ec_aiori = {
+        .name = "EC",
+        .name_legacy = NULL,
+        .initialize = ec_initialize,
+        .finalize = ec_finalize,
+        .create = ec_Create,
+        .get_options = ec_options,
+        .xfer_hints = ec_xfer_hints,
+        .fsync = ec_Fsync,
+        .open = ec_Open,
+        .xfer = ec_Xfer,
+        .close = ec_Close,
+        .sync = ec_Sync,
+        .check_params = ec_check_params,
+        .remove = ec_Delete,
+        .get_version = aiori_get_version,
+        .get_file_size = ec_GetFileSize,
+        .statfs = aiori_posix_statfs,
+        .mkdir = aiori_posix_mkdir,
+        .rmdir = aiori_posix_rmdir,
+        .access = ec_access,
+        .stat = ec_stat,
+        .enable_mdtest = false
+};
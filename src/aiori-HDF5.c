@@ -18,7 +18,10 @@
 
 #include <stdio.h>              /* only for fprintf() */
 #include <stdlib.h>
+#include <string.h>
+#include <strings.h>
 #include <sys/stat.h>
+#include <time.h>
 /* HDF5 routines here still use the old 1.6 style.  Nothing wrong with that but
  * save users the trouble of  passing this flag through configure */
 #define H5_USE_16_API
@@ -111,6 +114,12 @@ typedef struct{
   int noFill;                      /* no fill in file creation */
   IOR_offset_t setAlignment;       /* alignment in bytes */
   int chunk_size;
+  int batchSize;                   /* number of transfers per H5Dwrite/H5Dread */
+  int async;                       /* use H5Dwrite_async with an event set */
+  int asyncDepth;                  /* number of outstanding asynchronous writes */
+  char *filters;                   /* filter pipeline of the data sets */
+  IOR_offset_t chunkCacheSize;     /* chunk cache in bytes per data set */
+  int chunkCacheSlots;             /* hash slots of the chunk cache */
 } HDF5_options_t;
 /***************************** F U N C T I O N S ******************************/
 
@@ -125,6 +134,8 @@ static option_help * HDF5_options(aiori_mod_opt_t ** init_backend_options, aiori
     o->collective_md = 0;
     o->setAlignment = 1;
     o->chunk_size = 0;
+    o->batchSize = 1;
+    o->asyncDepth = 4;
     o->mpio.hintsFileName = NULL;
   }
 
@@ -139,7 +150,13 @@ static option_help * HDF5_options(aiori_mod_opt_t ** init_backend_options, aiori
     {0, "hdf5.individualDataSets",        "Datasets not shared by all procs [not working]", OPTION_FLAG, 'd', & o->individualDataSets},
     {0, "hdf5.setAlignment",        "HDF5 alignment in bytes (e.g.: 8, 4k, 2m, 1g)", OPTION_OPTIONAL_ARGUMENT, 'd', & o->setAlignment},
     {0, "hdf5.noFill", "No fill in HDF5 file creation", OPTION_FLAG, 'd', & o->noFill},
-    {0, "hdf5.chunkSize", "Chunk size (in terms of dataset elements) to use for I/O", OPTION_FLAG, 'd', & o->chunk_size},
+    {0, "hdf5.chunkSize", "Chunk size (in terms of dataset elements) to use for I/O", OPTION_OPTIONAL_ARGUMENT, 'd', & o->chunk_size},
+    {0, "hdf5.chunkCacheSize", "Chunk cache size in bytes per data set (H5Pset_chunk_cache)", OPTION_OPTIONAL_ARGUMENT, 'l', & o->chunkCacheSize},
+    {0, "hdf5.chunkCacheSlots", "Number of hash slots of the chunk cache, preferably a prime", OPTION_OPTIONAL_ARGUMENT, 'd', & o->chunkCacheSlots},
+    {0, "hdf5.filters", "Comma separated filter pipeline for chunked data sets: shuffle,deflate[:level],szip[:pixels],nbit,fletcher32; the compression ratio and the CPU time in H5Dwrite/H5Dread are reported", OPTION_OPTIONAL_ARGUMENT, 's', & o->filters},
+    {0, "hdf5.batchSize", "Number of transfers combined into one multi-block hyperslab selection per H5Dwrite/H5Dread, writes span segment datasets with H5Dwrite_multi (HDF5 >= 1.14)", OPTION_OPTIONAL_ARGUMENT, 'd', & o->batchSize},
+    {0, "hdf5.async", "Use H5Dwrite_async/H5Dread_async with an event set, asynchronous with the async VOL connector (HDF5 >= 1.13)", OPTION_FLAG, 'd', & o->async},
+    {0, "hdf5.asyncDepth", "Number of outstanding asynchronous writes before waiting for the event set", OPTION_OPTIONAL_ARGUMENT, 'd', & o->asyncDepth},
     LAST_OPTION
   };
   option_help * help = malloc(sizeof(h));
@@ -182,6 +199,28 @@ typedef struct{
   int newlyOpenedFile;            /* newly opened file */  
   int firstReadCheck;
   int startNewDataSet;
+
+  /* batched and asynchronous mode, the batch holds references to its data sets */
+  char *batchBuf;                 /* batchSize transfers */
+  int batchCount;                 /* pending transfers */
+  int batchSets;                  /* data sets in the batch */
+  hid_t *batchDataSet;
+  hid_t *batchFileSpace;          /* union of the selected blocks per data set */
+  int *batchSetCount;             /* transfers per data set */
+  hsize_t readStart;              /* element range of the data set in batchBuf */
+  hsize_t readCount;
+  hid_t es;                       /* event set or H5I_INVALID_HID */
+  char **asyncBufs;               /* buffers handed to asynchronous writes */
+  int asyncCur;
+  int asyncPending;
+  long long calls;
+  double callTime;                /* time until the calls returned */
+  double waitTime;                /* time waiting for the completion */
+
+  /* filter accounting */
+  IOR_offset_t logicalBytes;      /* size of the created data sets */
+  clock_t dataCpu;                /* CPU time in H5Dwrite/H5Dread */
+  char *name;                     /* to stat the file after closing it */
 } aiori_h5fd_t;
 
 static void SetupDataSet(aiori_h5fd_t *, int flags, aiori_mod_opt_t *);
@@ -195,12 +234,87 @@ static void HDF5_init_xfer_options(aiori_xfer_hint_t * params){
   MPIIO_xfer_hints(params);
 }
 
+/*
+ * Add the comma separated filters to the data set creation property list.
+ */
+static void HDF5_SetFilters(hid_t dataSetPropList, const char *filters)
+{
+        char *list = strdup(filters);
+        char *saveptr = NULL;
+
+        for (char *f = strtok_r(list, ",", &saveptr); f != NULL; f = strtok_r(NULL, ",", &saveptr)) {
+                char *arg = strchr(f, ':');
+                H5Z_filter_t filter;
+
+                if (arg != NULL)
+                        *arg++ = '\0';
+                if (strcasecmp(f, "shuffle") == 0)
+                        filter = H5Z_FILTER_SHUFFLE;
+                else if (strcasecmp(f, "deflate") == 0)
+                        filter = H5Z_FILTER_DEFLATE;
+                else if (strcasecmp(f, "szip") == 0)
+                        filter = H5Z_FILTER_SZIP;
+                else if (strcasecmp(f, "nbit") == 0)
+                        filter = H5Z_FILTER_NBIT;
+                else if (strcasecmp(f, "fletcher32") == 0)
+                        filter = H5Z_FILTER_FLETCHER32;
+                else
+                        ERRF("unknown HDF5 filter \"%s\"", f);
+                if (H5Zfilter_avail(filter) <= 0)
+                        ERRF("HDF5 filter \"%s\" is not available", f);
+
+                switch (filter) {
+                case H5Z_FILTER_SHUFFLE:
+                        HDF5_CHECK(H5Pset_shuffle(dataSetPropList), "cannot set shuffle filter");
+                        break;
+                case H5Z_FILTER_DEFLATE:
+                        HDF5_CHECK(H5Pset_deflate(dataSetPropList, arg ? atoi(arg) : 6), "cannot set deflate filter");
+                        break;
+                case H5Z_FILTER_SZIP:
+                        HDF5_CHECK(H5Pset_szip(dataSetPropList, H5_SZIP_NN_OPTION_MASK, arg ? atoi(arg) : 32),
+                                   "cannot set szip filter");
+                        break;
+                case H5Z_FILTER_NBIT:
+                        HDF5_CHECK(H5Pset_nbit(dataSetPropList), "cannot set n-bit filter");
+                        break;
+                default:
+                        HDF5_CHECK(H5Pset_fletcher32(dataSetPropList), "cannot set fletcher32 filter");
+                }
+        }
+        free(list);
+}
+
 static int HDF5_check_params(aiori_mod_opt_t * options){
   HDF5_options_t *o = (HDF5_options_t*) options;
   if (o->setAlignment < 0)
       ERR("alignment must be non-negative integer");
   if (o->individualDataSets)
       ERR("individual data sets not implemented");
+  if (o->batchSize < 1)
+      ERR("the batch size must be at least 1");
+  if (o->batchSize > 1 && hints && hints->randomOffset)
+      ERR("batching requires sequential transfers");
+  if (o->async && o->asyncDepth < 1)
+      ERR("the async depth must be at least 1");
+#ifndef HAVE_H5ESWAIT
+  if (o->async)
+      ERR("asynchronous I/O requires HDF5 event sets (HDF5 >= 1.13)");
+#endif
+  if (o->chunkCacheSize < 0 || o->chunkCacheSlots < 0)
+      ERR("the chunk cache size and slots must be non-negative");
+  if (o->filters != NULL && o->filters[0] != '\0') {
+      hid_t dataSetPropList;
+
+      if (o->chunk_size <= 0)
+          ERR("filters require chunked data sets (--hdf5.chunkSize)");
+      if (hints && ! hints->collective && ! hints->filePerProc && hints->numTasks > 1)
+          ERR("parallel writes to filtered data sets require collective I/O");
+      /* validate the pipeline */
+      dataSetPropList = H5Pcreate(H5P_DATASET_CREATE);
+      HDF5_CHECK(dataSetPropList, "cannot create data set property list");
+      HDF5_SetFilters(dataSetPropList, o->filters);
+      HDF5_CHECK(H5Pclose(dataSetPropList), "cannot close data set property list");
+  }
   return 0;
 }
 
@@ -395,17 +509,228 @@ static aiori_fd_t *HDF5_Open(char *testFileName, int flags, aiori_mod_opt_t * pa
         if (mpiHints != MPI_INFO_NULL)
                 MPI_Info_free(&mpiHints);
 
+        fd->batchSets = fd->batchCount = 0;
+        fd->readCount = 0;
+        fd->es = H5I_INVALID_HID;
+        fd->calls = 0;
+        fd->callTime = fd->waitTime = 0;
+        fd->logicalBytes = 0;
+        fd->dataCpu = 0;
+        fd->name = strdup(testFileName);
+        if (o->batchSize > 1 || o->async) {
+                fd->batchDataSet = safeMalloc(sizeof(hid_t) * o->batchSize);
+                fd->batchFileSpace = safeMalloc(sizeof(hid_t) * o->batchSize);
+                fd->batchSetCount = safeMalloc(sizeof(int) * o->batchSize);
+                if (o->async) {
+                        fd->asyncBufs = safeMalloc(sizeof(char *) * o->asyncDepth);
+                        for (int i = 0; i < o->asyncDepth; i++)
+                                fd->asyncBufs[i] = safeMalloc(o->batchSize * hints->transferSize);
+                        fd->asyncCur = fd->asyncPending = 0;
+                        fd->batchBuf = fd->asyncBufs[0];
+#ifdef HAVE_H5ESWAIT
+                        fd->es = H5EScreate();
+                        HDF5_CHECK(fd->es, "cannot create event set");
+#endif
+                } else {
+                        fd->batchBuf = safeMalloc(o->batchSize * hints->transferSize);
+                }
+        }
+
         return (aiori_fd_t*)(fd);
 }
 
+/*
+ * Wait for the completion of all asynchronous operations.
+ */
+static void HDF5_WaitAsync(aiori_h5fd_t * fd)
+{
+#ifdef HAVE_H5ESWAIT
+        size_t inProgress;
+        hbool_t errorOccurred;
+        double start;
+
+        if (fd->es == H5I_INVALID_HID)
+                return;
+        start = GetTimeStamp();
+        HDF5_CHECK(H5ESwait(fd->es, H5ES_WAIT_FOREVER, &inProgress, &errorOccurred),
+                   "cannot wait for event set");
+        if (errorOccurred)
+                ERR("asynchronous HDF5 operation failed");
+        fd->waitTime += GetTimeStamp() - start;
+        fd->asyncPending = 0;
+#endif
+}
+
+/*
+ * Write the pending transfers of the batch with one call, a batch spanning data sets
+ * requires H5Dwrite_multi.
+ */
+static void HDF5_FlushBatch(aiori_h5fd_t * fd, aiori_mod_opt_t * param)
+{
+        HDF5_options_t *o = (HDF5_options_t*) param;
+#ifdef HAVE_H5DWRITE_MULTI
+        hid_t memTypes[fd->batchSets];
+#endif
+        hid_t memSpaces[fd->batchSets];
+        const void *bufs[fd->batchSets];
+        IOR_offset_t pos = 0;
+        double start;
+
+        if (fd->batchCount == 0)
+                return;
+        for (int i = 0; i < fd->batchSets; i++) {
+                hsize_t dims[NUM_DIMS];
+                dims[0] = (hsize_t) fd->batchSetCount[i] * (hints->transferSize / sizeof(IOR_size_t));
+#ifdef HAVE_H5DWRITE_MULTI
+                memTypes[i] = H5T_NATIVE_LLONG;
+#endif
+                memSpaces[i] = H5Screate_simple(NUM_DIMS, dims, NULL);
+                HDF5_CHECK(memSpaces[i], "cannot create simple memory data space");
+                bufs[i] = fd->batchBuf + pos;
+                pos += fd->batchSetCount[i] * hints->transferSize;
+        }
+
+        start = GetTimeStamp();
+        if (fd->batchSets == 1) {
+#ifdef HAVE_H5ESWAIT
+                if (o->async)
+                        HDF5_CHECK(H5Dwrite_async(fd->batchDataSet[0], H5T_NATIVE_LLONG, memSpaces[0],
+                                                  fd->batchFileSpace[0], fd->xferPropList, bufs[0], fd->es),
+                                   "cannot write to data set");
+                else
+#endif
+                HDF5_CHECK(H5Dwrite(fd->batchDataSet[0], H5T_NATIVE_LLONG, memSpaces[0],
+                                    fd->batchFileSpace[0], fd->xferPropList, bufs[0]),
+                           "cannot write to data set");
+        } else {
+#ifdef HAVE_H5DWRITE_MULTI
+#ifdef HAVE_H5ESWAIT
+                if (o->async)
+                        HDF5_CHECK(H5Dwrite_multi_async(fd->batchSets, fd->batchDataSet, memTypes, memSpaces,
+                                                        fd->batchFileSpace, fd->xferPropList, bufs, fd->es),
+                                   "cannot write to data sets");
+                else
+#endif
+                HDF5_CHECK(H5Dwrite_multi(fd->batchSets, fd->batchDataSet, memTypes, memSpaces,
+                                          fd->batchFileSpace, fd->xferPropList, bufs),
+                           "cannot write to data sets");
+#else
+                ERR("a batch spanning data sets requires H5Dwrite_multi");
+#endif
+        }
+        fd->callTime += GetTimeStamp() - start;
+        fd->calls++;
+
+        for (int i = 0; i < fd->batchSets; i++) {
+                HDF5_CHECK(H5Sclose(memSpaces[i]), "cannot close memory data space");
+                HDF5_CHECK(H5Sclose(fd->batchFileSpace[i]), "cannot close file data space");
+                HDF5_CHECK(H5Dclose(fd->batchDataSet[i]), "cannot close data set");
+        }
+        fd->batchSets = fd->batchCount = 0;
+
+        if (o->async) {
+                /* the buffer belongs to the operation until the event set completes */
+                if (++fd->asyncPending == o->asyncDepth)
+                        HDF5_WaitAsync(fd);
+                fd->asyncCur = (fd->asyncCur + 1) % o->asyncDepth;
+                fd->batchBuf = fd->asyncBufs[fd->asyncCur];
+        }
+}
+
+/*
+ * Add a write to the batch, the hyperslab of the transfer is selected in the file data space.
+ */
+static void HDF5_BatchWrite(aiori_h5fd_t * fd, IOR_size_t * buffer, IOR_offset_t length, aiori_mod_opt_t * param)
+{
+        HDF5_options_t *o = (HDF5_options_t*) param;
+        hsize_t hsStart[NUM_DIMS], hsStride[NUM_DIMS], hsCount[NUM_DIMS], hsBlock[NUM_DIMS];
+        int set = fd->batchSets - 1;
+
+        if (set < 0 || fd->batchDataSet[set] != fd->dataSet) {
+                /* the transfer starts a new data set in the batch, its reference keeps it open */
+                set = ++fd->batchSets - 1;
+                HDF5_CHECK(H5Iinc_ref(fd->dataSet), "cannot reference data set");
+                fd->batchDataSet[set] = fd->dataSet;
+                fd->batchFileSpace[set] = H5Scopy(fd->fileDataSpace);
+                HDF5_CHECK(fd->batchFileSpace[set], "cannot copy file data space");
+                HDF5_CHECK(H5Sselect_none(fd->batchFileSpace[set]), "cannot reset selection");
+                fd->batchSetCount[set] = 0;
+        }
+        HDF5_CHECK(H5Sget_select_bounds(fd->fileDataSpace, hsStart, hsBlock), "cannot get selection");
+        hsStride[0] = hsBlock[0] = (hsize_t) (length / sizeof(IOR_size_t));
+        hsCount[0] = 1;
+        HDF5_CHECK(H5Sselect_hyperslab(fd->batchFileSpace[set], H5S_SELECT_OR, hsStart, hsStride, hsCount, hsBlock),
+                   "cannot select hyperslab");
+        memcpy(fd->batchBuf + fd->batchCount * hints->transferSize, buffer, length);
+        fd->batchSetCount[set]++;
+        fd->batchCount++;
+        if (fd->batchCount == o->batchSize)
+                HDF5_FlushBatch(fd, param);
+}
+
+/*
+ * Read the transfer from the batch buffer, on a miss read ahead up to batchSize transfers
+ * within the block of the rank in the current data set.
+ */
+static void HDF5_BatchRead(aiori_h5fd_t * fd, IOR_size_t * buffer, IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param)
+{
+        HDF5_options_t *o = (HDF5_options_t*) param;
+        hsize_t hsStart[NUM_DIMS], hsEnd[NUM_DIMS], hsStride[NUM_DIMS], hsCount[NUM_DIMS], hsBlock[NUM_DIMS];
+        hsize_t elements = length / sizeof(IOR_size_t);
+
+        HDF5_CHECK(H5Sget_select_bounds(fd->fileDataSpace, hsStart, hsEnd), "cannot get selection");
+        if (fd->readCount == 0 || hsStart[0] < fd->readStart || hsStart[0] + elements > fd->readStart + fd->readCount) {
+                hsize_t blockElements = hints->blockSize / sizeof(IOR_size_t);
+                hsize_t inBlock = (offset % hints->blockSize) / sizeof(IOR_size_t);
+                hsize_t count = (hsize_t) o->batchSize * (hints->transferSize / sizeof(IOR_size_t));
+                hsize_t dims[NUM_DIMS];
+                hid_t memSpace;
+                double start;
+
+                if (count > blockElements - inBlock)
+                        count = blockElements - inBlock;
+                hsStride[0] = hsBlock[0] = count;
+                hsCount[0] = 1;
+                HDF5_CHECK(H5Sselect_hyperslab(fd->fileDataSpace, H5S_SELECT_SET, hsStart, hsStride, hsCount, hsBlock),
+                           "cannot select hyperslab");
+                dims[0] = count;
+                memSpace = H5Screate_simple(NUM_DIMS, dims, NULL);
+                HDF5_CHECK(memSpace, "cannot create simple memory data space");
+                start = GetTimeStamp();
+#ifdef HAVE_H5ESWAIT
+                if (o->async) {
+                        HDF5_CHECK(H5Dread_async(fd->dataSet, H5T_NATIVE_LLONG, memSpace, fd->fileDataSpace,
+                                                 fd->xferPropList, fd->batchBuf, fd->es),
+                                   "cannot read from data set");
+                        fd->callTime += GetTimeStamp() - start;
+                        HDF5_WaitAsync(fd);
+                } else
+#endif
+                {
+                        HDF5_CHECK(H5Dread(fd->dataSet, H5T_NATIVE_LLONG, memSpace, fd->fileDataSpace,
+                                           fd->xferPropList, fd->batchBuf),
+                                   "cannot read from data set");
+                        fd->callTime += GetTimeStamp() - start;
+                }
+                fd->calls++;
+                HDF5_CHECK(H5Sclose(memSpace), "cannot close memory data space");
+                fd->readStart = hsStart[0];
+                fd->readCount = count;
+        }
+        memcpy(buffer, fd->batchBuf + (hsStart[0] - fd->readStart) * sizeof(IOR_size_t), length);
+}
+
 /*
  * Write or read access to file using the HDF5 interface.
  */
 static IOR_offset_t HDF5_Xfer(int access, aiori_fd_t *afd, IOR_size_t * buffer,
                               IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param)
 {
+        HDF5_options_t *o = (HDF5_options_t*) param;
         IOR_offset_t segmentPosition, segmentSize;
         aiori_h5fd_t * fd = (aiori_h5fd_t *) afd;
+        int batched = o->batchSize > 1 || o->async;
+        clock_t start;
 
         /*
          * this toggle is for the read check operation, which passes through
@@ -449,11 +774,17 @@ static IOR_offset_t HDF5_Xfer(int access, aiori_fd_t *afd, IOR_size_t * buffer,
         if (fd->startNewDataSet == TRUE) {
                 /* if just opened this file, no data set to close yet */
                 if (fd->newlyOpenedFile != TRUE) {
+#ifndef HAVE_H5DWRITE_MULTI
+                        /* a batch cannot span data sets */
+                        if (batched)
+                                HDF5_FlushBatch(fd, param);
+#endif
                         HDF5_CHECK(H5Dclose(fd->dataSet), "cannot close data set");
                         HDF5_CHECK(H5Sclose(fd->fileDataSpace),
                                    "cannot close file data space");
                 }
                 SetupDataSet(fd, access == WRITE ? IOR_CREAT : IOR_RDWR, param);
+                fd->readCount = 0;
         }
 
         SeekOffset(fd, offset, param);
@@ -462,8 +793,13 @@ static IOR_offset_t HDF5_Xfer(int access, aiori_fd_t *afd, IOR_size_t * buffer,
         fd->startNewDataSet = FALSE;
         fd->newlyOpenedFile = FALSE;
 
-        /* access the file */
-        if (access == WRITE) {  /* WRITE */
+        start = clock();
+        if (batched) {
+                if (access == WRITE)
+                        HDF5_BatchWrite(fd, buffer, length, param);
+                else
+                        HDF5_BatchRead(fd, buffer, length, offset, param);
+        } else if (access == WRITE) {  /* WRITE */
                 HDF5_CHECK(H5Dwrite(fd->dataSet, H5T_NATIVE_LLONG,
                                     fd->memDataSpace, fd->fileDataSpace,
                                     fd->xferPropList, buffer),
@@ -474,6 +810,7 @@ static IOR_offset_t HDF5_Xfer(int access, aiori_fd_t *afd, IOR_size_t * buffer,
                                    fd->xferPropList, buffer),
                            "cannot read from data set");
         }
+        fd->dataCpu += clock() - start;
         return (length);
 }
 
@@ -483,6 +820,11 @@ static IOR_offset_t HDF5_Xfer(int access, aiori_fd_t *afd, IOR_size_t * buffer,
 static void HDF5_Fsync(aiori_fd_t *afd, aiori_mod_opt_t * param)
 {
   aiori_h5fd_t * fd = (aiori_h5fd_t *) afd;
+  HDF5_options_t *o = (HDF5_options_t*) param;
+  if (o->batchSize > 1 || o->async) {
+    HDF5_FlushBatch(fd, param);
+    HDF5_WaitAsync(fd);
+  }
   HDF5_CHECK(H5Fflush(fd->fd, H5F_SCOPE_LOCAL), "cannot flush file to disk");
 }
 
@@ -492,8 +834,33 @@ static void HDF5_Fsync(aiori_fd_t *afd, aiori_mod_opt_t * param)
 static void HDF5_Close(aiori_fd_t *afd, aiori_mod_opt_t * param)
 {
     aiori_h5fd_t * fd = (aiori_h5fd_t *) afd;
+    HDF5_options_t *o = (HDF5_options_t*) param;
     if(hints->dryRun)
       return;
+    if (o->batchSize > 1 || o->async) {
+            clock_t start = clock();
+            HDF5_FlushBatch(fd, param);
+            HDF5_WaitAsync(fd);
+            fd->dataCpu += clock() - start;
+            if (rank == 0 && fd->calls > 0) {
+                    fprintf(out_logfile, "HDF5 batched: %lld calls, %.4f s to return, %.4f s to completion on rank 0\n",
+                            fd->calls, fd->callTime, fd->callTime + fd->waitTime);
+            }
+#ifdef HAVE_H5ESWAIT
+            if (fd->es != H5I_INVALID_HID)
+                    HDF5_CHECK(H5ESclose(fd->es), "cannot close event set");
+#endif
+            if (o->async) {
+                    for (int i = 0; i < o->asyncDepth; i++)
+                            free(fd->asyncBufs[i]);
+                    free(fd->asyncBufs);
+            } else {
+                    free(fd->batchBuf);
+            }
+            free(fd->batchDataSet);
+            free(fd->batchFileSpace);
+            free(fd->batchSetCount);
+    }
     //if (hints->fd_fppReadCheck == NULL) {
             HDF5_CHECK(H5Dclose(fd->dataSet), "cannot close data set");
             HDF5_CHECK(H5Sclose(fd->dataSpace), "cannot close data space");
@@ -505,6 +872,18 @@ static void HDF5_Close(aiori_fd_t *afd, aiori_mod_opt_t * param)
                        " cannot close transfer property list");
     //}
     HDF5_CHECK(H5Fclose(fd->fd), "cannot close file");
+    if (o->filters != NULL && o->filters[0] != '\0' && rank == 0) {
+            struct stat st;
+            /* H5Fclose() is collective, the file including its metadata is complete now */
+            if (stat(fd->name, &st) == 0 && fd->logicalBytes > 0 && st.st_size > 0)
+                    fprintf(out_logfile, "HDF5 filters %s: compression ratio %.3f (%.2f MiB data, %.2f MiB file), ",
+                            o->filters, (double) fd->logicalBytes / st.st_size,
+                            (double) fd->logicalBytes / MEBIBYTE, (double) st.st_size / MEBIBYTE);
+            else
+                    fprintf(out_logfile, "HDF5 filters %s: ", o->filters);
+            fprintf(out_logfile, "%.4f s CPU in H5Dwrite/H5Dread on rank 0\n", (double) fd->dataCpu / CLOCKS_PER_SEC);
+    }
+    free(fd->name);
     free(fd);
 }
 
@@ -608,7 +987,7 @@ static void SetupDataSet(aiori_h5fd_t *fd, int flags, aiori_mod_opt_t * param)
   
         HDF5_options_t *o = (HDF5_options_t*) param;
         char dataSetName[MAX_STR];
-        hid_t dataSetPropList;
+        hid_t dataSetPropList, dataSetAccessPropList;
         int dataSetID;
         static int dataSetSuffix = 0;
 
@@ -628,6 +1007,16 @@ static void SetupDataSet(aiori_h5fd_t *fd, int flags, aiori_mod_opt_t * param)
         sprintf(dataSetName, "%s-%04d.%04d", "Dataset", dataSetID,
                 dataSetSuffix++);
 
+        dataSetAccessPropList = H5Pcreate(H5P_DATASET_ACCESS);
+        HDF5_CHECK(dataSetAccessPropList, "cannot create data set access property list");
+        if (o->chunkCacheSize > 0 || o->chunkCacheSlots > 0) {
+                HDF5_CHECK(H5Pset_chunk_cache(dataSetAccessPropList,
+                                              o->chunkCacheSlots > 0 ? (size_t) o->chunkCacheSlots : H5D_CHUNK_CACHE_NSLOTS_DEFAULT,
+                                              o->chunkCacheSize > 0 ? (size_t) o->chunkCacheSize : H5D_CHUNK_CACHE_NBYTES_DEFAULT,
+                                              H5D_CHUNK_CACHE_W0_DEFAULT),
+                           "cannot set chunk cache");
+        }
+
         if (flags & IOR_CREAT) {     /* WRITE */
                 hsize_t chunk_dims[NUM_DIMS];
 
@@ -645,6 +1034,9 @@ static void SetupDataSet(aiori_h5fd_t *fd, int flags, aiori_mod_opt_t * param)
                         "cannot set chunk size");
                 }
 
+                if (o->filters != NULL && o->filters[0] != '\0')
+                        HDF5_SetFilters(dataSetPropList, o->filters);
+
                 if (o->noFill == TRUE) {
                         if (rank == 0 && verbose >= VERBOSE_1) {
                                 fprintf(stdout, "\nusing 'no fill' option\n");
@@ -653,12 +1045,16 @@ static void SetupDataSet(aiori_h5fd_t *fd, int flags, aiori_mod_opt_t * param)
                                                     H5D_FILL_TIME_NEVER),
                                    "cannot set fill time for property list");
                 }
-                fd->dataSet = H5Dcreate(fd->fd, dataSetName, H5T_NATIVE_LLONG, fd->dataSpace, dataSetPropList);
+                fd->dataSet = H5Dcreate2(fd->fd, dataSetName, H5T_NATIVE_LLONG, fd->dataSpace,
+                                         H5P_DEFAULT, dataSetPropList, dataSetAccessPropList);
                 HDF5_CHECK(fd->dataSet, "cannot create data set");
+                HDF5_CHECK(H5Pclose(dataSetPropList), "cannot close data set property list");
+                fd->logicalBytes += H5Sget_simple_extent_npoints(fd->dataSpace) * sizeof(IOR_size_t);
         } else {                /* READ or CHECK */
-                fd->dataSet = H5Dopen(*(hid_t *) fd, dataSetName);
+                fd->dataSet = H5Dopen2(*(hid_t *) fd, dataSetName, dataSetAccessPropList);
                 HDF5_CHECK(fd->dataSet, "cannot open data set");
         }
+        HDF5_CHECK(H5Pclose(dataSetAccessPropList), "cannot close data set access property list");
 
         /* retrieve data space from data set for hyperslab */
         fd->fileDataSpace = H5Dget_space(fd->dataSet);
@@ -6,20 +6,52 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <inttypes.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <poll.h>
 #include <nfsc/libnfs.h>
 #include "aiori-LIBNFS.h"
 #include "aiori.h"
 #include "aiori-debug.h"
+#include "utilities.h"
 
 static struct nfs_context *nfs_context;
 
+/* all contexts of the rank, nfs_context is the first one and used for metadata */
+static struct nfs_context **nfs_contexts;
+
+static int nfs_connections;
+
 static struct nfs_url *nfs_url;
 
 static struct aiori_xfer_hint_t *hint_parameter;
 
+/* a read or write RPC of the pipeline */
+typedef struct {
+    int busy;
+    int access;
+    int result;         /* bytes transferred or a negative error */
+    size_t length;
+    char *buffer;       /* copy of the data of a write, reads use the transfer buffer */
+    size_t buffer_size;
+    struct nfs_context *context;
+    double start;
+} libnfs_rpc_t;
+
+typedef struct {
+    struct nfsfh **fh;  /* the file handle of every connection */
+    libnfs_rpc_t *rpcs; /* the window, NULL if synchronous */
+    int rpc_count;
+    int inflight;
+    int max_inflight;
+    int next_connection;
+    uint64_t completed;
+    double latency;
+    double max_latency;
+} libnfs_fd_t;
+
 /******************************************************************************\
 *
 *  Helper Functions
@@ -55,6 +87,160 @@ int Map_IOR_Open_Flags_To_LIBNFS_Flags(int ior_open_flags) {
     return libnfs_flags;
 }
 
+static libnfs_fd_t *Create_File_Descriptor(const char *file_path, struct nfsfh *first_fh, int libnfs_flags, libnfs_options_t *options) {
+    libnfs_fd_t *fd = calloc(1, sizeof(libnfs_fd_t));
+    if (fd == NULL) {
+        ERR("Error while allocating the file descriptor");
+    }
+
+    fd->fh = calloc(nfs_connections, sizeof(struct nfsfh *));
+    fd->fh[0] = first_fh;
+    // the file exists now, the other connections only open it
+    libnfs_flags &= ~(O_CREAT | O_TRUNC | O_EXCL);
+    for (int i = 1; i < nfs_connections; i++) {
+        if (nfs_open(nfs_contexts[i], file_path, libnfs_flags, &fd->fh[i])) {
+            ERRF("Error while opening the file %s on connection %d \n nfs error: %s\n", file_path, i, nfs_get_error(nfs_contexts[i]));
+        }
+    }
+
+    if (options->rpcs > 1) {
+        fd->rpc_count = options->rpcs;
+        fd->rpcs = calloc(fd->rpc_count, sizeof(libnfs_rpc_t));
+    }
+
+    return fd;
+}
+
+/*
+ * Runs the event loop of all connections once: waits until one of them can make
+ * progress and lets libnfs process the replies, which invokes the callbacks.
+ */
+static void Service_Connections(void) {
+    struct pollfd pfds[nfs_connections];
+    for (int i = 0; i < nfs_connections; i++) {
+        pfds[i].fd = nfs_get_fd(nfs_contexts[i]);
+        pfds[i].events = nfs_which_events(nfs_contexts[i]);
+        pfds[i].revents = 0;
+    }
+
+    if (poll(pfds, nfs_connections, 100) < 0 && errno != EINTR) {
+        ERR("Error while polling the nfs connections");
+    }
+
+    // also called without events so libnfs can handle timeouts
+    for (int i = 0; i < nfs_connections; i++) {
+        if (nfs_service(nfs_contexts[i], pfds[i].revents) < 0) {
+            ERRF("Error while servicing the nfs connection %d \n nfs error: %s\n", i, nfs_get_error(nfs_contexts[i]));
+        }
+    }
+}
+
+static void Rpc_Callback(int err, struct nfs_context *context, void *data, void *private_data) {
+    libnfs_rpc_t *rpc = (libnfs_rpc_t *)private_data;
+    rpc->result = err;
+    rpc->busy = 0;
+}
+
+/* waits for the RPC and checks its result */
+static void Complete_Rpc(libnfs_fd_t *fd, libnfs_rpc_t *rpc) {
+    while (rpc->busy) {
+        Service_Connections();
+    }
+
+    double latency = GetTimeStamp() - rpc->start;
+    fd->latency += latency;
+    if (latency > fd->max_latency) {
+        fd->max_latency = latency;
+    }
+    fd->completed++;
+    fd->inflight--;
+    rpc->context = NULL;
+    if (rpc->result < 0) {
+        ERRF("Error while %s file \n nfs error: %s\n", rpc->access == WRITE ? "writing to" : "reading from", strerror(-rpc->result));
+    }
+
+    if ((size_t)rpc->result != rpc->length) {
+        ERRF("Error while %s file: %d of %zu bytes transferred\n", rpc->access == WRITE ? "writing to" : "reading from", rpc->result, rpc->length);
+    }
+}
+
+/* returns an idle RPC of the window, processes replies until one completes if necessary */
+static libnfs_rpc_t *Idle_Rpc(libnfs_fd_t *fd) {
+    for (;;) {
+        for (int i = 0; i < fd->rpc_count; i++) {
+            libnfs_rpc_t *rpc = &fd->rpcs[i];
+            if (rpc->context != NULL && !rpc->busy) {
+                Complete_Rpc(fd, rpc);
+            }
+            if (rpc->context == NULL) {
+                return rpc;
+            }
+        }
+        Service_Connections();
+    }
+}
+
+static void Complete_All_Rpcs(libnfs_fd_t *fd) {
+    for (int i = 0; i < fd->rpc_count; i++) {
+        if (fd->rpcs[i].context != NULL) {
+            Complete_Rpc(fd, &fd->rpcs[i]);
+        }
+    }
+}
+
+/*
+ * The transfer is split into RPCs of at most rsize/wsize bytes, which are sent
+ * round robin over the connections with up to libnfs.rpcs in flight. Writes
+ * return as soon as their RPCs are queued, reads (including the check reads)
+ * once all their RPCs completed.
+ */
+static IOR_offset_t Pipelined_Xfer(int access, libnfs_fd_t *fd, char *buffer, IOR_offset_t size, IOR_offset_t offset) {
+    IOR_offset_t pos = 0;
+    while (pos < size) {
+        libnfs_rpc_t *rpc = Idle_Rpc(fd);
+        int connection = fd->next_connection;
+        struct nfs_context *context = nfs_contexts[connection];
+        size_t max = access == WRITE ? nfs_get_writemax(context) : nfs_get_readmax(context);
+        size_t length = (size_t)(size - pos) < max ? (size_t)(size - pos) : max;
+        int result;
+
+        fd->next_connection = (connection + 1) % nfs_connections;
+        rpc->access = access;
+        rpc->length = length;
+        rpc->result = 0;
+        rpc->busy = 1;
+        rpc->context = context;
+        rpc->start = GetTimeStamp();
+        if (access == WRITE) {
+            if (rpc->buffer_size < length) {
+                free(rpc->buffer);
+                rpc->buffer = safeMalloc(length);
+                rpc->buffer_size = length;
+            }
+            memcpy(rpc->buffer, buffer + pos, length);
+            result = nfs_pwrite_async(context, fd->fh[connection], rpc->buffer, length, offset + pos, Rpc_Callback, rpc);
+        } else {
+            result = nfs_pread_async(context, fd->fh[connection], buffer + pos, length, offset + pos, Rpc_Callback, rpc);
+        }
+        if (result) {
+            ERRF("Error while queuing a %s RPC \n nfs error: %s\n", access == WRITE ? "write" : "read", nfs_get_error(context));
+        }
+
+        fd->inflight++;
+        if (fd->inflight > fd->max_inflight) {
+            fd->max_inflight = fd->inflight;
+        }
+        pos += length;
+    }
+
+    if (access != WRITE) {
+        // the buffer of a read or check read is only valid until the transfer returns
+        Complete_All_Rpcs(fd);
+    }
+
+    return size;
+}
+
 /******************************************************************************\
 *
 *  Implementation of the Backend-Interface.
@@ -65,7 +251,7 @@ char *LIBNFS_GetVersion(){
     return "Version 1.0";
 }
 
-aiori_fd_t *LIBNFS_Open(char *file_path, int ior_flags, aiori_mod_opt_t *) {
+aiori_fd_t *LIBNFS_Open(char *file_path, int ior_flags, aiori_mod_opt_t *module_options) {
     struct nfsfh *newFileFh;
     int libnfs_flags = Map_IOR_Open_Flags_To_LIBNFS_Flags(ior_flags);
     int open_result = nfs_open(nfs_context, file_path, libnfs_flags, &newFileFh);
@@ -73,18 +259,35 @@ aiori_fd_t *LIBNFS_Open(char *file_path, int ior_flags, aiori_mod_opt_t *) {
         ERRF("Error while opening the file %s \n nfs error: %s\n", file_path, nfs_get_error(nfs_context));
     }
 
-    return (aiori_fd_t *)newFileFh;
+    return (aiori_fd_t *)Create_File_Descriptor(file_path, newFileFh, libnfs_flags, (libnfs_options_t *)module_options);
 }
 
 void LIBNFS_Close(aiori_fd_t * file_descriptor, aiori_mod_opt_t * module_options) {
-    struct nfsfh *file = (struct nfsfh *)file_descriptor;
-    int close_result = nfs_close(nfs_context, file);
-    if (close_result) {
-        ERRF("Error while closing a file \n nfs error: %s\n", nfs_get_error(nfs_context));        
+    libnfs_fd_t *fd = (libnfs_fd_t *)file_descriptor;
+    if (fd->rpcs) {
+        Complete_All_Rpcs(fd);
+        if (rank == 0 && fd->completed > 0) {
+            fprintf(out_logfile, "LIBNFS pipeline: %" PRIu64 " RPCs over %d connections, up to %d in flight, latency mean %.3f ms max %.3f ms on rank 0\n",
+                    fd->completed, nfs_connections, fd->max_inflight, fd->latency * 1e3 / fd->completed, fd->max_latency * 1e3);
+        }
+        for (int i = 0; i < fd->rpc_count; i++) {
+            free(fd->rpcs[i].buffer);
+        }
+        free(fd->rpcs);
+    }
+
+    for (int i = 0; i < nfs_connections; i++) {
+        int close_result = nfs_close(nfs_contexts[i], fd->fh[i]);
+        if (close_result) {
+            ERRF("Error while closing a file \n nfs error: %s\n", nfs_get_error(nfs_contexts[i]));        
+        }
     }
+
+    free(fd->fh);
+    free(fd);
 }
 
-aiori_fd_t *LIBNFS_Create(char *file_path, int ior_flags, aiori_mod_opt_t *)
+aiori_fd_t *LIBNFS_Create(char *file_path, int ior_flags, aiori_mod_opt_t *module_options)
 {
     struct nfsfh *newFileFh;
     int libnfs_flags = Map_IOR_Open_Flags_To_LIBNFS_Flags(ior_flags);
@@ -95,7 +298,7 @@ aiori_fd_t *LIBNFS_Create(char *file_path, int ior_flags, aiori_mod_opt_t *)
         ERRF("Error while creating the file %s \n nfs error: %s\n", file_path, nfs_get_error(nfs_context));
     }
 
-    return (aiori_fd_t *)newFileFh;
+    return (aiori_fd_t *)Create_File_Descriptor(file_path, newFileFh, libnfs_flags, (libnfs_options_t *)module_options);
 }
 
 void LIBNFS_Remove(char* file_path, aiori_mod_opt_t * module_options) {
@@ -113,15 +316,15 @@ IOR_offset_t LIBNFS_Xfer(
     IOR_offset_t offset,
     aiori_mod_opt_t * module_options) {
     
-    struct nfsfh *file = (struct nfsfh *)file_descriptor;
-    uint64_t current_offset;    
-    nfs_lseek(nfs_context, file, offset, SEEK_SET, &current_offset);
-    if (current_offset != offset) {
-        ERRF("Error while calling lseek... expected offset: %lld but current offset: %" PRIu64 "\n nfs error: %s\n", offset, current_offset, nfs_get_error(nfs_context));
+    libnfs_fd_t *fd = (libnfs_fd_t *)file_descriptor;
+    if (fd->rpcs) {
+        return Pipelined_Xfer(access, fd, (char *)buffer, size, offset);
     }
 
+    // positional I/O saves the lseek per transfer
+    struct nfsfh *file = fd->fh[0];
     if (access == WRITE) {
-        int write_result = nfs_write(nfs_context, file, (void *)buffer, (uint64_t)size);
+        int write_result = nfs_pwrite(nfs_context, file, (void *)buffer, (size_t)size, (uint64_t)offset);
         if (write_result < 0) {
             ERRF("Error while writing to file \n nfs error: %s\n", nfs_get_error(nfs_context));
         }
@@ -130,7 +333,7 @@ IOR_offset_t LIBNFS_Xfer(
     }
 
     if (access == READ) {
-        int read_result = nfs_read(nfs_context, file, (void*)buffer, (size_t)size);
+        int read_result = nfs_pread(nfs_context, file, (void*)buffer, (size_t)size, (uint64_t)offset);
         if (read_result < 0) {
             ERRF("Error while reading to file \n nfs error: %s\n", nfs_get_error(nfs_context));
         }
@@ -207,9 +410,16 @@ int LIBNFS_StatFS(const char *path, ior_aiori_statfs_t *stat, aiori_mod_opt_t *
 }
 
 void LIBNFS_FSync(aiori_fd_t *file_descriptor, aiori_mod_opt_t * module_options) {
-    struct nfsfh *file = (struct nfsfh *)file_descriptor; 
-    if (nfs_fsync(nfs_context, file)) {
-        ERRF("Error while calling fsync \n nfs error: %s\n", nfs_get_error(nfs_context));
+    libnfs_fd_t *fd = (libnfs_fd_t *)file_descriptor; 
+    if (fd->rpcs) {
+        Complete_All_Rpcs(fd);
+    }
+
+    // writes of every connection must be committed
+    for (int i = 0; i < nfs_connections; i++) {
+        if (nfs_fsync(nfs_contexts[i], fd->fh[i])) {
+            ERRF("Error while calling fsync \n nfs error: %s\n", nfs_get_error(nfs_contexts[i]));
+        }
     }
 }
 
@@ -233,12 +443,16 @@ option_help *LIBNFS_GetOptions(aiori_mod_opt_t ** init_backend_options, aiori_mo
         memcpy(libnfs_options, init_values, sizeof(libnfs_options_t));
     } else {
         memset(libnfs_options, 0, sizeof(libnfs_options_t));
+        libnfs_options->rpcs = 1;
+        libnfs_options->connections = 1;
     }
 
     *init_backend_options = (aiori_mod_opt_t *) libnfs_options;
 
     option_help h [] = {
         {0, "libnfs.url", "The URL (RFC2224) specifing the server, path and options", OPTION_REQUIRED_ARGUMENT, 's', &libnfs_options->url},
+        {0, "libnfs.rpcs", "Number of read/write RPCs in flight per rank using the asynchronous API, 1 is synchronous", OPTION_OPTIONAL_ARGUMENT, 'd', &libnfs_options->rpcs},
+        {0, "libnfs.connections", "Number of connections (nfs contexts) per rank, RPCs are distributed round robin like with nconnect", OPTION_OPTIONAL_ARGUMENT, 'd', &libnfs_options->connections},
         LAST_OPTION
     };
 
@@ -247,6 +461,19 @@ option_help *LIBNFS_GetOptions(aiori_mod_opt_t ** init_backend_options, aiori_mo
     return help;
 }
 
+int LIBNFS_CheckParams(aiori_mod_opt_t * options) {
+    libnfs_options_t *libnfs_options = (libnfs_options_t *)options;
+    if (libnfs_options->rpcs < 1) {
+        ERR("The number of RPCs in flight (libnfs.rpcs) must be at least 1");
+    }
+
+    if (libnfs_options->connections < 1) {
+        ERR("The number of connections (libnfs.connections) must be at least 1");
+    }
+
+    return 0;
+}
+
 void LIBNFS_Initialize(aiori_mod_opt_t * options) {
     if (nfs_context || nfs_url)
     {
@@ -254,26 +481,39 @@ void LIBNFS_Initialize(aiori_mod_opt_t * options) {
     }
 
     libnfs_options_t *libnfs_options = (libnfs_options_t *)options;
-    nfs_context = nfs_init_context();
-    if (!nfs_context) {
-        ERRF("Error while creating the nfs context \n nfs error: %s\n", nfs_get_error(nfs_context));
+    nfs_connections = libnfs_options->connections > 1 ? libnfs_options->connections : 1;
+    nfs_contexts = calloc(nfs_connections, sizeof(struct nfs_context *));
+    for (int i = 0; i < nfs_connections; i++) {
+        nfs_contexts[i] = nfs_init_context();
+        if (!nfs_contexts[i]) {
+            ERRF("Error while creating the nfs context \n nfs error: %s\n", nfs_get_error(nfs_contexts[i]));
+        }
     }
+    nfs_context = nfs_contexts[0];
 
     nfs_url = nfs_parse_url_full(nfs_context, libnfs_options->url);
     if (!nfs_url) {
         ERRF("Error while parsing the argument libnfs.url \n nfs error: %s\n", nfs_get_error(nfs_context));
     }
 
-    int mount_result = nfs_mount(nfs_context, nfs_url->server, nfs_url->path);
-    if (mount_result) {
-        ERRF("Error while mounting nfs server: %s, path: %s \n nfs error: %s\n", nfs_url->server, nfs_url->path, nfs_get_error(nfs_context));
+    // every context mounts separately and therefore uses its own connection
+    for (int i = 0; i < nfs_connections; i++) {
+        int mount_result = nfs_mount(nfs_contexts[i], nfs_url->server, nfs_url->path);
+        if (mount_result) {
+            ERRF("Error while mounting nfs server: %s, path: %s \n nfs error: %s\n", nfs_url->server, nfs_url->path, nfs_get_error(nfs_contexts[i]));
+        }
     }
 }
 
 void LIBNFS_Finalize(aiori_mod_opt_t * options) {
-    if (nfs_context) {
-        nfs_destroy_context(nfs_context);
+    if (nfs_contexts) {
+        for (int i = 0; i < nfs_connections; i++) {
+            nfs_destroy_context(nfs_contexts[i]);
+        }
+        free(nfs_contexts);
+        nfs_contexts = NULL;
         nfs_context = NULL;
+        nfs_connections = 0;
     }
 
     if (nfs_url) {
@@ -301,7 +541,7 @@ ior_aiori_t libnfs_aiori = {
                                .access = LIBNFS_Access,
                                .get_file_size = LIBNFS_GetFileSize,
                                .get_options = LIBNFS_GetOptions,
-                               .check_params = NULL,
+                               .check_params = LIBNFS_CheckParams,
                                .initialize = LIBNFS_Initialize,
                                .finalize = LIBNFS_Finalize,
                                .enable_mdtest = true,
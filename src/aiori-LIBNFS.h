@@ -5,6 +5,8 @@
 
 typedef struct {
     char *url;
+    int rpcs;           /* number of read/write RPCs in flight per rank, 1 is synchronous */
+    int connections;    /* number of nfs contexts (TCP connections) per rank */
 } libnfs_options_t;
 
-#endif
\ No newline at end of file
+#endif
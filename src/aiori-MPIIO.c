@@ -18,6 +18,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 
 #include "ior.h"
@@ -49,6 +50,33 @@ typedef struct{
   MPI_Datatype transferType;       /* datatype for transfer */
   MPI_Datatype contigType;         /* elem datatype */
   MPI_Datatype fileType;           /* filetype for file view */
+
+  /* request window of the non-blocking mode */
+  int          window;
+  MPI_Request *requests;           /* MPI_REQUEST_NULL if the slot is free */
+  MPI_Status  *statuses;
+  int         *indices;
+  int         *freeSlots;          /* stack of free slots */
+  int          freeCount;
+  IOR_offset_t *expected;          /* bytes expected per slot */
+  char        *writeBuffers;       /* one transfer per slot */
+  long long    posted;
+  double       postTime;           /* time spent posting requests */
+  double       waitTime;           /* time spent waiting for completions */
+
+  /* whole-phase mode: ring of two buffers, one is filled/consumed while the other is in flight */
+  int          tasksPerFile;
+  int          offsetFactor;
+  IOR_offset_t phaseBufSize;
+  IOR_offset_t phaseTotal;         /* bytes of the rank in the file view */
+  IOR_offset_t phaseNext;          /* next expected position in the file view */
+  char        *phaseBuf[2];
+  MPI_Request  phaseReq[2];
+  IOR_offset_t phaseStart[2];      /* position in the file view */
+  IOR_offset_t phaseLen[2];
+  int          phaseCur;
+  int          phaseAccess;        /* -1 until the first transfer */
+  long long    phaseCalls;
 } mpiio_fd_t;
 
 static option_help * MPIIO_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t * init_values){
@@ -57,6 +85,8 @@ static option_help * MPIIO_options(aiori_mod_opt_t ** init_backend_options, aior
     memcpy(o, init_values, sizeof(mpiio_options_t));
   }else{
     memset(o, 0, sizeof(mpiio_options_t));
+    o->requestWindow = 16;
+    o->phaseBufferSize = 64 * MEBIBYTE;
   }
   *init_backend_options = (aiori_mod_opt_t*) o;
 
@@ -67,6 +97,10 @@ static option_help * MPIIO_options(aiori_mod_opt_t ** init_backend_options, aior
     {0, "mpiio.useStridedDatatype", "put strided access into datatype", OPTION_FLAG, 'd', & o->useStridedDatatype},
     //{'P', NULL,        "useSharedFilePointer -- use shared file pointer [not working]", OPTION_FLAG, 'd', & params->useSharedFilePointer},
     {0, "mpiio.useFileView",  "Use MPI_File_set_view", OPTION_FLAG, 'd', & o->useFileView},
+    {0, "mpiio.nonBlocking",  "Use non-blocking transfers MPI_File_iwrite_at/iread_at (or the _all variants with -c), completed with MPI_Waitsome", OPTION_FLAG, 'd', & o->nonBlocking},
+    {0, "mpiio.requestWindow", "Max number of outstanding non-blocking requests per file", OPTION_OPTIONAL_ARGUMENT, 'd', & o->requestWindow},
+    {0, "mpiio.wholePhase", "Set one file view for the whole segment x block pattern of the rank at open and move the data of the phase with few large calls through a ring of two buffers", OPTION_FLAG, 'd', & o->wholePhase},
+    {0, "mpiio.phaseBufferSize", "Size of each of the two buffers of the whole-phase mode, rounded down to a multiple of the transfer size", OPTION_OPTIONAL_ARGUMENT, 'l', & o->phaseBufferSize},
       LAST_OPTION
   };
   option_help * help = malloc(sizeof(h));
@@ -120,6 +154,22 @@ static int MPIIO_check_params(aiori_mod_opt_t * module_options){
           ERR("random offset not available with collective MPIIO");
   if (hints->randomOffset && param->useFileView)
           ERR("random offset not available with MPIIO fileviews");
+  if (param->nonBlocking && param->useFileView)
+          ERR("non-blocking transfers not available with MPIIO fileviews");
+  if (param->nonBlocking && param->requestWindow < 1)
+          ERR("the request window must be at least 1");
+  if (param->wholePhase && (param->useFileView || param->nonBlocking))
+          ERR("the whole-phase mode cannot be combined with MPIIO fileviews or non-blocking transfers");
+  if (param->wholePhase && hints->randomOffset)
+          ERR("random offset not available with the MPIIO whole-phase mode");
+  if (param->wholePhase && param->phaseBufferSize < hints->transferSize)
+          ERR("the MPIIO phase buffer must be at least one transfer");
+  if (param->wholePhase && hints->transferSize > INT_MAX)
+          ERR("the transfer size must be < 2GiB in the MPIIO whole-phase mode");
+#ifndef HAVE_MPI_FILE_IWRITE_AT_ALL
+  if (param->nonBlocking && hints->collective)
+          ERR("non-blocking collective transfers require MPI_File_iwrite_at_all (MPI-3.1)");
+#endif
 
   return 0;
 }
@@ -164,6 +214,48 @@ static aiori_fd_t *MPIIO_Create(char *testFileName, int iorflags, aiori_mod_opt_
   return MPIIO_Open(testFileName, iorflags, module_options);
 }
 
+/*
+ * Whole-phase mode: the file view contains the blocks of the rank in all segments, so the data
+ * of the rank is contiguous in the view and can be accessed with few large calls. This lets
+ * the collective buffering of the MPI-IO implementation see the access pattern of the phase.
+ */
+static void MPIIO_PhaseOpen(mpiio_fd_t * mfd, mpiio_options_t * param)
+{
+        MPI_Datatype xferType, blockType;
+
+        if (hints->filePerProc) {
+                mfd->offsetFactor = 0;
+                mfd->tasksPerFile = 1;
+        } else {
+                mfd->offsetFactor = (rank + rankOffset) % hints->numTasks;
+                mfd->tasksPerFile = hints->numTasks;
+        }
+        mfd->phaseTotal = hints->segmentCount * hints->blockSize;
+        mfd->phaseBufSize = param->phaseBufferSize / hints->transferSize * hints->transferSize;
+        if (mfd->phaseBufSize > mfd->phaseTotal)
+                mfd->phaseBufSize = mfd->phaseTotal;
+        mfd->phaseReq[0] = mfd->phaseReq[1] = MPI_REQUEST_NULL;
+        mfd->phaseAccess = -1;
+        if (hints->dryRun)
+                return;
+        mfd->phaseBuf[0] = safeMalloc(mfd->phaseBufSize);
+        mfd->phaseBuf[1] = safeMalloc(mfd->phaseBufSize);
+
+        /* the block of the rank, the extent covers the blocks of all tasks of a segment */
+        MPI_CHECK(MPI_Type_contiguous(hints->transferSize, MPI_BYTE, &xferType),
+                  "cannot create contiguous datatype");
+        MPI_CHECK(MPI_Type_contiguous(hints->blockSize / hints->transferSize, xferType, &blockType),
+                  "cannot create contiguous datatype");
+        MPI_CHECK(MPI_Type_create_resized(blockType, 0, (MPI_Aint) mfd->tasksPerFile * hints->blockSize,
+                                          &mfd->fileType), "cannot create resized type");
+        MPI_CHECK(MPI_Type_commit(&mfd->fileType), "cannot commit datatype");
+        MPI_CHECK(MPI_Type_free(&blockType), "cannot free datatype");
+        MPI_CHECK(MPI_Type_free(&xferType), "cannot free datatype");
+        MPI_CHECK(MPI_File_set_view(mfd->fd, (MPI_Offset) mfd->offsetFactor * hints->blockSize,
+                                    MPI_BYTE, mfd->fileType, "native", MPI_INFO_NULL),
+                  "cannot set file view");
+}
+
 /*
  * Open a file through the MPIIO interface.  Setup file view.
  */
@@ -314,6 +406,22 @@ static aiori_fd_t *MPIIO_Open(char *testFileName, int flags, aiori_mod_opt_t * m
                   }
                 }
         }
+        if (param->wholePhase) {
+                MPIIO_PhaseOpen(mfd, param);
+        }
+        if (param->nonBlocking) {
+                mfd->window = param->requestWindow;
+                mfd->requests = safeMalloc(sizeof(MPI_Request) * mfd->window);
+                mfd->statuses = safeMalloc(sizeof(MPI_Status) * mfd->window);
+                mfd->indices = safeMalloc(sizeof(int) * mfd->window);
+                mfd->freeSlots = safeMalloc(sizeof(int) * mfd->window);
+                mfd->expected = safeMalloc(sizeof(IOR_offset_t) * mfd->window);
+                for (int i = 0; i < mfd->window; i++) {
+                        mfd->requests[i] = MPI_REQUEST_NULL;
+                        mfd->freeSlots[i] = mfd->window - 1 - i;
+                }
+                mfd->freeCount = mfd->window;
+        }
         if (mpiHints != MPI_INFO_NULL)
                 MPI_CHECK(MPI_Info_free(&mpiHints), "MPI_Info_free failed");
         return ((void *) mfd);
@@ -387,8 +495,274 @@ static int MPI_File_write_at_all_c(MPI_File f, MPI_Offset off, const void * buf,
                 ERR("count too large for this MPI implementation");
         return MPI_File_write_at_all(f, off, buf, c, t, s);
 }
+
+static int MPI_File_iread_at_c(MPI_File f, MPI_Offset off, void * buf, MPI_Count c,
+                MPI_Datatype t, MPI_Request *r)
+{
+        if (c > INT_MAX)
+                ERR("count too large for this MPI implementation");
+        return MPI_File_iread_at(f, off, buf, c, t, r);
+}
+
+static int MPI_File_iwrite_at_c(MPI_File f, MPI_Offset off, const void * buf, MPI_Count c,
+                MPI_Datatype t, MPI_Request *r)
+{
+        if (c > INT_MAX)
+                ERR("count too large for this MPI implementation");
+        return MPI_File_iwrite_at(f, off, buf, c, t, r);
+}
+
+#ifdef HAVE_MPI_FILE_IWRITE_AT_ALL
+static int MPI_File_iread_at_all_c(MPI_File f, MPI_Offset off, void * buf, MPI_Count c,
+                MPI_Datatype t, MPI_Request *r)
+{
+        if (c > INT_MAX)
+                ERR("count too large for this MPI implementation");
+        return MPI_File_iread_at_all(f, off, buf, c, t, r);
+}
+
+static int MPI_File_iwrite_at_all_c(MPI_File f, MPI_Offset off, const void * buf, MPI_Count c,
+                MPI_Datatype t, MPI_Request *r)
+{
+        if (c > INT_MAX)
+                ERR("count too large for this MPI implementation");
+        return MPI_File_iwrite_at_all(f, off, buf, c, t, r);
+}
+#endif
 #endif
 
+/*
+ * Wait for outstanding non-blocking requests, for at least one if all is false.
+ */
+static void MPIIO_WaitRequests(mpiio_fd_t * mfd, int all)
+{
+        double start = GetTimeStamp();
+        while (mfd->freeCount < mfd->window) {
+                int outcount;
+                MPI_CHECK(MPI_Waitsome(mfd->window, mfd->requests, &outcount,
+                                       mfd->indices, mfd->statuses),
+                          "cannot wait for non-blocking requests");
+                for (int i = 0; i < outcount; i++) {
+                        int slot = mfd->indices[i];
+                        MPI_Count elementsAccessed;
+                        MPI_CHECK(MPI_Get_elements_x(&mfd->statuses[i], MPI_BYTE, &elementsAccessed),
+                                  "can't get elements accessed");
+                        /* the transfer was already reported as complete, it cannot be retried */
+                        if (elementsAccessed != mfd->expected[slot])
+                                ERRF("task %d, partial non-blocking transfer, %lld of %lld bytes",
+                                     rank, (long long) elementsAccessed, (long long) mfd->expected[slot]);
+                        mfd->freeSlots[mfd->freeCount++] = slot;
+                }
+                if (! all)
+                        break;
+        }
+        mfd->waitTime += GetTimeStamp() - start;
+}
+
+/*
+ * Post a non-blocking transfer, at most requestWindow requests are outstanding per file.
+ * IOR reuses its buffer for every transfer, so the data of a write is copied into the
+ * buffer of the request slot. The check phases compare the data after the call, hence
+ * they wait for the completion.
+ */
+static IOR_offset_t MPIIO_XferNonBlocking(int access, mpiio_fd_t * mfd, IOR_size_t * buffer,
+                                          IOR_offset_t length, IOR_offset_t offset)
+{
+        void *buf = buffer;
+        int slot;
+
+        if (mfd->freeCount == 0)
+                MPIIO_WaitRequests(mfd, FALSE);
+        double start = GetTimeStamp();
+        slot = mfd->freeSlots[--mfd->freeCount];
+        mfd->expected[slot] = length;
+        if (access == WRITE) {
+                if (mfd->writeBuffers == NULL)
+                        mfd->writeBuffers = safeMalloc((size_t) mfd->window * hints->transferSize);
+                buf = mfd->writeBuffers + (size_t) slot * hints->transferSize;
+                memcpy(buf, buffer, length);
+                if (hints->collective) {
+#ifdef HAVE_MPI_FILE_IWRITE_AT_ALL
+                        MPI_CHECK(MPI_File_iwrite_at_all_c(mfd->fd, offset, buf, length,
+                                                           MPI_BYTE, &mfd->requests[slot]),
+                                  "cannot post explicit, collective");
+#endif
+                } else {
+                        MPI_CHECK(MPI_File_iwrite_at_c(mfd->fd, offset, buf, length,
+                                                       MPI_BYTE, &mfd->requests[slot]),
+                                  "cannot post explicit, noncollective");
+                }
+        } else {
+                if (hints->collective) {
+#ifdef HAVE_MPI_FILE_IWRITE_AT_ALL
+                        MPI_CHECK(MPI_File_iread_at_all_c(mfd->fd, offset, buf, length,
+                                                          MPI_BYTE, &mfd->requests[slot]),
+                                  "cannot post explicit, collective");
+#endif
+                } else {
+                        MPI_CHECK(MPI_File_iread_at_c(mfd->fd, offset, buf, length,
+                                                      MPI_BYTE, &mfd->requests[slot]),
+                                  "cannot post explicit, noncollective");
+                }
+        }
+        mfd->posted++;
+        mfd->postTime += GetTimeStamp() - start;
+        if (access == WRITECHECK || access == READCHECK)
+                MPIIO_WaitRequests(mfd, TRUE);
+        return length;
+}
+
+static void MPIIO_PhaseWait(mpiio_fd_t * mfd, int slot)
+{
+        MPI_Status status;
+        MPI_Count elementsAccessed;
+
+        if (mfd->phaseReq[slot] == MPI_REQUEST_NULL)
+                return;
+        MPI_CHECK(MPI_Wait(&mfd->phaseReq[slot], &status), "cannot wait for phase buffer");
+        MPI_CHECK(MPI_Get_elements_x(&status, MPI_BYTE, &elementsAccessed),
+                  "can't get elements accessed");
+        if (elementsAccessed != mfd->phaseLen[slot])
+                ERRF("task %d, partial access of the phase buffer, %lld of %lld bytes",
+                     rank, (long long) elementsAccessed, (long long) mfd->phaseLen[slot]);
+}
+
+/*
+ * Start the access of a phase buffer, it is non-blocking if supported for the access mode.
+ */
+static void MPIIO_PhasePost(mpiio_fd_t * mfd, int access, int slot)
+{
+        void *buf = mfd->phaseBuf[slot];
+        MPI_Offset offset = mfd->phaseStart[slot];
+        MPI_Count length = mfd->phaseLen[slot];
+        MPI_Request *req = &mfd->phaseReq[slot];
+
+        mfd->phaseCalls++;
+        if (hints->collective) {
+#ifdef HAVE_MPI_FILE_IWRITE_AT_ALL
+                if (access == WRITE)
+                        MPI_CHECK(MPI_File_iwrite_at_all_c(mfd->fd, offset, buf, length, MPI_BYTE, req),
+                                  "cannot access phase buffer, collective");
+                else
+                        MPI_CHECK(MPI_File_iread_at_all_c(mfd->fd, offset, buf, length, MPI_BYTE, req),
+                                  "cannot access phase buffer, collective");
+#else
+                MPI_Status status;
+                MPI_Count elementsAccessed;
+                if (access == WRITE)
+                        MPI_CHECK(MPI_File_write_at_all_c(mfd->fd, offset, buf, length, MPI_BYTE, &status),
+                                  "cannot access phase buffer, collective");
+                else
+                        MPI_CHECK(MPI_File_read_at_all_c(mfd->fd, offset, buf, length, MPI_BYTE, &status),
+                                  "cannot access phase buffer, collective");
+                MPI_CHECK(MPI_Get_elements_x(&status, MPI_BYTE, &elementsAccessed),
+                          "can't get elements accessed");
+                if (elementsAccessed != length)
+                        ERRF("task %d, partial access of the phase buffer, %lld of %lld bytes",
+                             rank, (long long) elementsAccessed, (long long) length);
+                *req = MPI_REQUEST_NULL;
+#endif
+        } else {
+                if (access == WRITE)
+                        MPI_CHECK(MPI_File_iwrite_at_c(mfd->fd, offset, buf, length, MPI_BYTE, req),
+                                  "cannot access phase buffer, noncollective");
+                else
+                        MPI_CHECK(MPI_File_iread_at_c(mfd->fd, offset, buf, length, MPI_BYTE, req),
+                                  "cannot access phase buffer, noncollective");
+        }
+}
+
+/* write the filled part of the current buffer and switch to the other one */
+static void MPIIO_PhaseFlush(mpiio_fd_t * mfd)
+{
+        int cur = mfd->phaseCur;
+        if (mfd->phaseAccess != WRITE || mfd->phaseLen[cur] == 0)
+                return;
+        MPIIO_PhasePost(mfd, WRITE, cur);
+        mfd->phaseCur = 1 - cur;
+        MPIIO_PhaseWait(mfd, mfd->phaseCur);
+        mfd->phaseLen[mfd->phaseCur] = 0;
+}
+
+/* complete all outstanding accesses of the phase buffers */
+static void MPIIO_PhaseComplete(mpiio_fd_t * mfd)
+{
+        MPIIO_PhaseFlush(mfd);
+        MPIIO_PhaseWait(mfd, 0);
+        MPIIO_PhaseWait(mfd, 1);
+        if (mfd->phaseAccess == WRITE)
+                mfd->phaseLen[0] = mfd->phaseLen[1] = 0;
+}
+
+/*
+ * Copy a transfer into or out of the phase buffers. The transfers of a rank must be
+ * sequential, as all ranks move the same amount of data, they perform the same
+ * sequence of (collective) calls.
+ */
+static IOR_offset_t MPIIO_XferPhase(int access, mpiio_fd_t * mfd, IOR_size_t * buffer,
+                                    IOR_offset_t length, IOR_offset_t offset)
+{
+        IOR_offset_t segmentSize = (IOR_offset_t) mfd->tasksPerFile * hints->blockSize;
+        IOR_offset_t segment = offset / segmentSize;
+        IOR_offset_t inBlock = offset - segment * segmentSize - (IOR_offset_t) mfd->offsetFactor * hints->blockSize;
+        IOR_offset_t pos = segment * hints->blockSize + inBlock;
+        int cur;
+
+        if (inBlock < 0 || inBlock + length > hints->blockSize)
+                ERRF("task %d, offset %lld is outside of the blocks of the rank in the whole-phase mode", rank, offset);
+        access = (access == WRITE) ? WRITE : READ;
+        if (mfd->phaseAccess != access) {
+                MPIIO_PhaseComplete(mfd);
+                mfd->phaseAccess = access;
+                mfd->phaseNext = pos;
+                mfd->phaseLen[0] = mfd->phaseLen[1] = 0;
+        }
+        if (pos != mfd->phaseNext)
+                ERRF("task %d, the whole-phase mode requires sequential transfers, expected %lld got %lld",
+                     rank, (long long) mfd->phaseNext, (long long) pos);
+        mfd->phaseNext = pos + length;
+
+        if (access == WRITE) {
+                cur = mfd->phaseCur;
+                if (mfd->phaseLen[cur] == 0)
+                        mfd->phaseStart[cur] = pos;
+                memcpy(mfd->phaseBuf[cur] + mfd->phaseLen[cur], buffer, length);
+                mfd->phaseLen[cur] += length;
+                if (mfd->phaseLen[cur] + length > mfd->phaseBufSize)
+                        MPIIO_PhaseFlush(mfd);
+                return length;
+        }
+
+        cur = mfd->phaseCur;
+        if (mfd->phaseLen[cur] == 0 || pos < mfd->phaseStart[cur]
+            || pos + length > mfd->phaseStart[cur] + mfd->phaseLen[cur]) {
+                int other = 1 - cur;
+                MPIIO_PhaseWait(mfd, other);
+                if (mfd->phaseLen[other] > 0 && mfd->phaseStart[other] == pos) {
+                        /* the prefetched buffer */
+                        cur = other;
+                } else {
+                        MPIIO_PhaseWait(mfd, cur);
+                        mfd->phaseStart[cur] = pos;
+                        mfd->phaseLen[cur] = mfd->phaseTotal - pos < mfd->phaseBufSize ? mfd->phaseTotal - pos : mfd->phaseBufSize;
+                        MPIIO_PhasePost(mfd, READ, cur);
+                        MPIIO_PhaseWait(mfd, cur);
+                }
+                mfd->phaseCur = cur;
+                /* prefetch the following data into the other buffer */
+                other = 1 - cur;
+                IOR_offset_t next = mfd->phaseStart[cur] + mfd->phaseLen[cur];
+                mfd->phaseLen[other] = 0;
+                if (next < mfd->phaseTotal) {
+                        mfd->phaseStart[other] = next;
+                        mfd->phaseLen[other] = mfd->phaseTotal - next < mfd->phaseBufSize ? mfd->phaseTotal - next : mfd->phaseBufSize;
+                        MPIIO_PhasePost(mfd, READ, other);
+                }
+        }
+        memcpy(buffer, mfd->phaseBuf[cur] + (pos - mfd->phaseStart[cur]), length);
+        return length;
+}
+
 static IOR_offset_t MPIIO_Xfer(int access, aiori_fd_t * fdp, IOR_size_t * buffer,
                                IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * module_options)
 {
@@ -400,6 +774,10 @@ static IOR_offset_t MPIIO_Xfer(int access, aiori_fd_t * fdp, IOR_size_t * buffer
         if(hints->dryRun)
           return length;
         mpiio_fd_t * mfd = (mpiio_fd_t*) fdp;
+        if (param->nonBlocking)
+                return MPIIO_XferNonBlocking(access, mfd, buffer, length, offset);
+        if (param->wholePhase)
+                return MPIIO_XferPhase(access, mfd, buffer, length, offset);
 
         int (MPIAPI * Access) (MPI_File, void *, MPI_Count,
                                MPI_Datatype, MPI_Status *);
@@ -593,6 +971,10 @@ static void MPIIO_Fsync(aiori_fd_t *fdp, aiori_mod_opt_t * module_options)
   if(hints->dryRun)
     return;
   mpiio_fd_t * mfd = (mpiio_fd_t*) fdp;
+  if (param->nonBlocking)
+      MPIIO_WaitRequests(mfd, TRUE);
+  if (param->wholePhase)
+      MPIIO_PhaseComplete(mfd);
   if (MPI_File_sync(mfd->fd) != MPI_SUCCESS)
       WARN("fsync() failed");
 }
@@ -604,6 +986,29 @@ static void MPIIO_Close(aiori_fd_t *fdp, aiori_mod_opt_t * module_options)
 {
         mpiio_options_t * param = (mpiio_options_t*) module_options;
         mpiio_fd_t * mfd = (mpiio_fd_t*) fdp;
+        if (param->nonBlocking) {
+                MPIIO_WaitRequests(mfd, TRUE);
+                if (rank == 0 && mfd->posted > 0) {
+                        fprintf(out_logfile, "MPIIO non-blocking: %lld requests, %.4f s posting, %.4f s waiting on rank 0\n",
+                                mfd->posted, mfd->postTime, mfd->waitTime);
+                }
+                free(mfd->requests);
+                free(mfd->statuses);
+                free(mfd->indices);
+                free(mfd->freeSlots);
+                free(mfd->expected);
+                free(mfd->writeBuffers);
+        }
+        if (param->wholePhase && ! hints->dryRun) {
+                MPIIO_PhaseComplete(mfd);
+                if (rank == 0 && mfd->phaseCalls > 0) {
+                        fprintf(out_logfile, "MPIIO whole-phase: %lld calls with up to %lld bytes on rank 0\n",
+                                mfd->phaseCalls, (long long) mfd->phaseBufSize);
+                }
+                free(mfd->phaseBuf[0]);
+                free(mfd->phaseBuf[1]);
+                MPI_CHECK(MPI_Type_free(&mfd->fileType), "cannot free MPI file datatype");
+        }
         if(! hints->dryRun){
               MPI_CHECK(MPI_File_close(& mfd->fd), "cannot close file");
         }
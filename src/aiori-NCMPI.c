@@ -18,6 +18,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <pnetcdf.h>
 
@@ -58,6 +59,7 @@ static char *NCMPI_GetVersion();
 static void NCMPI_Fsync(aiori_fd_t *, aiori_mod_opt_t *);
 static IOR_offset_t NCMPI_GetFileSize(aiori_mod_opt_t *, char *);
 static int NCMPI_Access(const char *, int, aiori_mod_opt_t *);
+static int NCMPI_check_params(aiori_mod_opt_t *);
 
 /************************** D E C L A R A T I O N S ***************************/
 static aiori_xfer_hint_t * hints = NULL;
@@ -71,10 +73,29 @@ static void NCMPI_xfer_hints(aiori_xfer_hint_t * params){
 typedef struct {
   mpiio_options_t mpio;
 
+  int aggregate;                   /* non-blocking transfers per ncmpi_wait_all */
+  int aggregateSegment;            /* aggregate all transfers of a segment */
+  int bput;                        /* buffered ncmpi_bput_vara for writes */
+  IOR_offset_t attachBufferSize;   /* size of the attached buffer for bput */
+
   /* runtime variables */
   int var_id;                      /* variable id handle for data set */
   int firstReadCheck;
   int startDataSet;
+
+  /* aggregation */
+  int window;                      /* transfers per wait */
+  int *requests;
+  int *statuses;
+  int pending;                     /* posted requests */
+  char *staging;                   /* window of transfers for iput/iget */
+  MPI_Offset attached;             /* size of the attached bput buffer */
+  int readSegment;                 /* segment and transfers in staging for reads */
+  int readFirst;
+  int readCount;
+  long long waits;
+  long long waitBytes;
+  IOR_offset_t postedBytes;
 } ncmpi_options_t;
 
 
@@ -93,6 +114,10 @@ static option_help * NCMPI_options(aiori_mod_opt_t ** init_backend_options, aior
     {0, "ncmpi.preallocate",   "Preallocate file size", OPTION_FLAG, 'd', & o->mpio.preallocate},
     {0, "ncmpi.useStridedDatatype", "put strided access into datatype", OPTION_FLAG, 'd', & o->mpio.useStridedDatatype},
     {0, "ncmpi.useFileView",  "Use MPI_File_set_view", OPTION_FLAG, 'd', & o->mpio.useFileView},
+    {0, "ncmpi.aggregate",    "Post N transfers as non-blocking ncmpi_iput_vara/ncmpi_iget_vara and complete them with one ncmpi_wait_all", OPTION_OPTIONAL_ARGUMENT, 'd', & o->aggregate},
+    {0, "ncmpi.aggregateSegment", "Aggregate all transfers of a segment", OPTION_FLAG, 'd', & o->aggregateSegment},
+    {0, "ncmpi.bput",         "Write with ncmpi_bput_vara into an attached buffer instead of ncmpi_iput_vara", OPTION_FLAG, 'd', & o->bput},
+    {0, "ncmpi.attachBufferSize", "Size of the buffer attached for bput, default is the aggregated transfers", OPTION_OPTIONAL_ARGUMENT, 'l', & o->attachBufferSize},
     LAST_OPTION
   };
   option_help * help = malloc(sizeof(h));
@@ -118,10 +143,156 @@ ior_aiori_t ncmpi_aiori = {
         .stat = aiori_posix_stat,
         .get_options = NCMPI_options,
         .xfer_hints = NCMPI_xfer_hints,
+        .check_params = NCMPI_check_params,
 };
 
 /***************************** F U N C T I O N S ******************************/
 
+static int NCMPI_check_params(aiori_mod_opt_t * param)
+{
+        ncmpi_options_t * o = (ncmpi_options_t*) param;
+
+        if (o->aggregate < 0)
+                ERR("the number of aggregated transfers must be non-negative");
+        if (o->attachBufferSize < 0)
+                ERR("the attached buffer size must be non-negative");
+        if ((o->bput || o->attachBufferSize) && o->aggregate <= 1 && ! o->aggregateSegment)
+                ERR("bput requires aggregation (--ncmpi.aggregate or --ncmpi.aggregateSegment)");
+        if (o->attachBufferSize > 0 && hints && o->attachBufferSize < hints->transferSize)
+                ERR("the attached buffer must hold at least one transfer");
+        if ((o->aggregate > 1 || o->aggregateSegment) && hints && hints->randomOffset)
+                ERR("aggregation requires sequential transfers");
+        return 0;
+}
+
+/*
+ * Complete the posted requests with ncmpi_wait_all in collective data mode.
+ */
+static void NCMPI_WaitRequests(int ncid, ncmpi_options_t * o)
+{
+        if (o->pending == 0)
+                return;
+        if (hints->collective) {
+                NCMPI_CHECK(ncmpi_wait_all(ncid, o->pending, o->requests, o->statuses),
+                            "cannot wait for requests");
+        } else {
+                NCMPI_CHECK(ncmpi_wait(ncid, o->pending, o->requests, o->statuses),
+                            "cannot wait for requests");
+        }
+        for (int i = 0; i < o->pending; i++)
+                NCMPI_CHECK(o->statuses[i], "non-blocking request failed");
+        o->waits++;
+        o->waitBytes += o->postedBytes;
+        o->pending = 0;
+        o->postedBytes = 0;
+}
+
+/*
+ * Set up the aggregation of non-blocking requests for a file.
+ */
+static void NCMPI_InitAggregation(ncmpi_options_t * o)
+{
+        IOR_offset_t transfers = hints->blockSize / hints->transferSize;
+
+        o->window = o->aggregateSegment ? (int) transfers : o->aggregate;
+        o->pending = 0;
+        o->postedBytes = 0;
+        o->waits = o->waitBytes = 0;
+        o->attached = 0;
+        o->readCount = 0;
+        o->staging = NULL;
+        if (o->window <= 1 && ! o->aggregateSegment)
+                return;
+        o->requests = safeMalloc(sizeof(int) * o->window);
+        o->statuses = safeMalloc(sizeof(int) * o->window);
+        o->staging = safeMalloc(o->window * hints->transferSize);
+}
+
+/*
+ * Complete the requests, detach the buffer and report the aggregated request size.
+ */
+static void NCMPI_FinalizeAggregation(int ncid, ncmpi_options_t * o)
+{
+        long long local[2], sum[2];
+
+        if (o->staging == NULL)
+                return;
+        NCMPI_WaitRequests(ncid, o);
+        if (o->attached) {
+                NCMPI_CHECK(ncmpi_buffer_detach(ncid), "cannot detach buffer");
+                o->attached = 0;
+        }
+        local[0] = o->waits;
+        local[1] = o->waitBytes;
+        MPI_CHECK(MPI_Reduce(local, sum, 2, MPI_LONG_LONG, MPI_SUM, 0, testComm), "cannot reduce aggregation statistics");
+        if (rank == 0 && o->waits > 0) {
+                fprintf(out_logfile, "NCMPI aggregation: %lld waits, %.0f bytes per wait on rank 0, %.0f bytes per wait across ranks\n",
+                        o->waits, (double) o->waitBytes / o->waits,
+                        hints->collective ? (double) sum[1] / o->waits : (double) sum[1] / sum[0]);
+        }
+        free(o->requests);
+        free(o->statuses);
+        free(o->staging);
+        o->staging = NULL;
+}
+
+/*
+ * Post a non-blocking write, the data is copied into the staging window or the attached buffer.
+ */
+static void NCMPI_PostWrite(int ncid, ncmpi_options_t * o, MPI_Offset * offsets, MPI_Offset * bufSize, signed char * buffer)
+{
+        if (o->bput) {
+                if (! o->attached) {
+                        o->attached = o->attachBufferSize > 0 ? o->attachBufferSize : (MPI_Offset) o->window * hints->transferSize;
+                        NCMPI_CHECK(ncmpi_buffer_attach(ncid, o->attached), "cannot attach buffer");
+                }
+                /* a smaller attached buffer limits the aggregation */
+                if (o->postedBytes + bufSize[2] > o->attached)
+                        NCMPI_WaitRequests(ncid, o);
+                NCMPI_CHECK(ncmpi_bput_vara_schar(ncid, o->var_id, offsets, bufSize, buffer, & o->requests[o->pending]),
+                            "cannot post buffered write");
+        } else {
+                signed char * staged = (signed char *) o->staging + o->pending * hints->transferSize;
+                memcpy(staged, buffer, bufSize[2]);
+                NCMPI_CHECK(ncmpi_iput_vara_schar(ncid, o->var_id, offsets, bufSize, staged, & o->requests[o->pending]),
+                            "cannot post write");
+        }
+        o->pending++;
+        o->postedBytes += bufSize[2];
+        if (o->pending == o->window)
+                NCMPI_WaitRequests(ncid, o);
+}
+
+/*
+ * Serve a read from the staging window, on a miss read the next window of the block with
+ * non-blocking requests.
+ */
+static void NCMPI_AggregatedRead(int ncid, ncmpi_options_t * o, int segmentNum, int transferNum, MPI_Offset * offsets, MPI_Offset * bufSize, signed char * buffer)
+{
+        if (o->readCount == 0 || segmentNum != o->readSegment ||
+            transferNum < o->readFirst || transferNum >= o->readFirst + o->readCount) {
+                int transfers = hints->blockSize / hints->transferSize;
+                int count = o->window;
+
+                if (count > transfers - transferNum)
+                        count = transfers - transferNum;
+                for (int i = 0; i < count; i++) {
+                        MPI_Offset start[NUM_DIMS] = {offsets[0], offsets[1] + i, 0};
+                        NCMPI_CHECK(ncmpi_iget_vara_schar(ncid, o->var_id, start, bufSize,
+                                                          (signed char *) o->staging + i * hints->transferSize,
+                                                          & o->requests[o->pending]),
+                                    "cannot post read");
+                        o->pending++;
+                        o->postedBytes += bufSize[2];
+                }
+                NCMPI_WaitRequests(ncid, o);
+                o->readSegment = segmentNum;
+                o->readFirst = transferNum;
+                o->readCount = count;
+        }
+        memcpy(buffer, o->staging + (transferNum - o->readFirst) * hints->transferSize, bufSize[2]);
+}
+
 /*
  * Create and open a file through the NCMPI interface.
  */
@@ -165,6 +336,7 @@ static aiori_fd_t *NCMPI_Create(char *testFileName, int iorflags, aiori_mod_opt_
         }
 #endif
 
+        NCMPI_InitAggregation(o);
         return (aiori_fd_t*)(fd);
 }
 
@@ -212,6 +384,7 @@ static aiori_fd_t *NCMPI_Open(char *testFileName, int iorflags, aiori_mod_opt_t
         }
 #endif
 
+        NCMPI_InitAggregation(o);
         return (aiori_fd_t*)(fd);
 }
 
@@ -306,6 +479,15 @@ static IOR_offset_t NCMPI_Xfer(int access, aiori_fd_t *fd, IOR_size_t * buffer,
         offsets[1] = transferNum;
         offsets[2] = 0;
 
+        /* aggregate non-blocking requests */
+        if (o->staging != NULL) {
+                if (access == WRITE)
+                        NCMPI_PostWrite(*(int *)fd, o, offsets, bufSize, bufferPtr);
+                else
+                        NCMPI_AggregatedRead(*(int *)fd, o, segmentNum, transferNum, offsets, bufSize, bufferPtr);
+                return (transferSize);
+        }
+
         /* access the file */
         if (access == WRITE) {  /* WRITE */
                 if (hints->collective) {
@@ -337,6 +519,10 @@ static IOR_offset_t NCMPI_Xfer(int access, aiori_fd_t *fd, IOR_size_t * buffer,
  */
 static void NCMPI_Fsync(aiori_fd_t *fd, aiori_mod_opt_t * param)
 {
+        ncmpi_options_t * o = (ncmpi_options_t*) param;
+
+        if (o->staging != NULL)
+                NCMPI_WaitRequests(*(int *)fd, o);
         NCMPI_CHECK(ncmpi_sync(*(int *)fd), "cannot sync file");
 }
 
@@ -345,6 +531,7 @@ static void NCMPI_Fsync(aiori_fd_t *fd, aiori_mod_opt_t * param)
  */
 static void NCMPI_Close(aiori_fd_t *fd, aiori_mod_opt_t * param)
 {
+        NCMPI_FinalizeAggregation(*(int *)fd, (ncmpi_options_t*) param);
         NCMPI_CHECK(ncmpi_close(*(int *)fd), "cannot close file");
         free(fd);
 }
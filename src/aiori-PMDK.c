@@ -15,15 +15,60 @@
 #include <errno.h>                                  /* sys_errlist */
 #include <stdio.h>                                  /* only for fprintf() */
 #include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
 #include <sys/stat.h>
 #include <libpmem.h>
+#include "utilities.h"
 
+enum { PMDK_PERSIST = 0, PMDK_DRAIN, PMDK_SEGMENT, PMDK_FLUSH };
 
+static const char * policy_names[] = {"persist", "drain", "segment", "flush"};
+
+static struct {
+  char * policy;
+  int drain_every;
+  int nontemporal;
+  int temporal;
+  int emulate;
+} o = {
+  .policy = "persist",
+  .drain_every = 1,
+};
 
 static option_help options [] = {
+      {0, "pmdk.policy", "When writes are made persistent: persist (every transfer), drain (every pmdk.drainEvery transfers), segment (once per block of a segment), flush (pmem_flush per transfer, drain with fsync and close)", OPTION_OPTIONAL_ARGUMENT, 's', & o.policy},
+      {0, "pmdk.drainEvery", "Number of transfers per drain with the drain policy", OPTION_OPTIONAL_ARGUMENT, 'd', & o.drain_every},
+      {0, "pmdk.nontemporal", "Copy with non-temporal stores (PMEM_F_MEM_NONTEMPORAL), the copy flushes, so the flush policy only drains", OPTION_FLAG, 'd', & o.nontemporal},
+      {0, "pmdk.temporal", "Copy with temporal stores (PMEM_F_MEM_TEMPORAL), the copy flushes, so the flush policy only drains", OPTION_FLAG, 'd', & o.temporal},
+      {0, "pmdk.emulate", "Accept files that are not on persistent memory (without DAX), persistence falls back to msync", OPTION_FLAG, 'd', & o.emulate},
       LAST_OPTION
 };
 
+/*
+ * The mapped file of the rank (only file per process is supported) and the
+ * writes that are not persistent yet. Copy and persistence are timed separately;
+ * the latency to persistence of a transfer spans from the start of its copy to
+ * the end of the drain that made it persistent.
+ */
+static struct {
+  int policy;
+  int is_pmem;
+  size_t mapped_len;
+  int transfers_per_segment;
+  int pending;                  /* transfers since the last drain */
+  double pending_first;         /* start of the oldest of them */
+  double pending_start_sum;
+  size_t dirty_start;           /* range written since the last drain, for msync */
+  size_t dirty_end;
+  uint64_t transfers;
+  uint64_t drains;
+  double copy_time;
+  double persist_time;
+  double latency_sum;
+  double latency_max;
+} pm;
+
 
 /**************************** P R O T O T Y P E S *****************************/
 
@@ -35,6 +80,7 @@ static void PMDK_Fsync(aiori_fd_t *, aiori_mod_opt_t *);
 static void PMDK_Close(aiori_fd_t *, aiori_mod_opt_t *);
 static void PMDK_Delete(char *, aiori_mod_opt_t *);
 static IOR_offset_t PMDK_GetFileSize(aiori_mod_opt_t *, char *);
+static int PMDK_check_params(aiori_mod_opt_t *);
 
 static aiori_xfer_hint_t * hints = NULL;
 
@@ -68,6 +114,7 @@ ior_aiori_t pmdk_aiori = {
         .access = aiori_posix_access,
         .stat = aiori_posix_stat,
         .get_options = PMDK_options,
+        .check_params = PMDK_check_params,
         .enable_mdtest = false,
 };
 
@@ -80,6 +127,133 @@ static option_help * PMDK_options(){
 	return options;
 }
 
+static int PMDK_check_params(aiori_mod_opt_t * param){
+  int i;
+  pm.policy = -1;
+  for(i = 0; i < (int) (sizeof(policy_names) / sizeof(char*)); i++){
+    if(strcmp(o.policy, policy_names[i]) == 0){
+      pm.policy = i;
+    }
+  }
+  if(pm.policy < 0){
+    ERRF("Unknown PMDK policy %s, use persist, drain, segment or flush", o.policy);
+  }
+  if(o.drain_every < 1){
+    ERR("PMDK drainEvery must be at least 1");
+  }
+  if(o.temporal && o.nontemporal){
+    ERR("PMDK temporal and nontemporal are mutually exclusive");
+  }
+#ifndef PMEM_F_MEM_NONTEMPORAL
+  if(o.temporal || o.nontemporal){
+    ERR("PMDK temporal and nontemporal require pmem_memcpy() of PMDK 1.5 or later");
+  }
+#endif
+  return 0;
+}
+
+/* records the mapping of a created or opened file */
+static void PMDK_Mapped(char * testFileName, size_t mapped_len, int is_pmem){
+    if(!is_pmem && !o.emulate){
+      fprintf(stdout, "\npmem_map_file thinks the hardware being used for %s is not pmem, use --pmdk.emulate to continue with msync\n", testFileName);
+      MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, -1), "MPI_Abort() error");
+    }
+    int policy = pm.policy;
+    memset(& pm, 0, sizeof(pm));
+    pm.policy = policy;
+    pm.is_pmem = is_pmem;
+    pm.mapped_len = mapped_len;
+    pm.transfers_per_segment = hints->blockSize / hints->transferSize;
+}
+
+/* makes the pending writes persistent */
+static void PMDK_Drain(char * addr){
+    double start, end;
+    if(pm.pending == 0){
+      return;
+    }
+    start = GetTimeStamp();
+    if(pm.is_pmem){
+      pmem_drain();
+    }else if(pmem_msync(addr + pm.dirty_start, pm.dirty_end - pm.dirty_start) != 0){
+      ERR("pmem_msync failed");
+    }
+    end = GetTimeStamp();
+    pm.persist_time += end - start;
+    pm.drains++;
+    pm.latency_sum += pm.pending * end - pm.pending_start_sum;
+    if(end - pm.pending_first > pm.latency_max){
+      pm.latency_max = end - pm.pending_first;
+    }
+    pm.pending = 0;
+    pm.pending_start_sum = 0;
+}
+
+static void PMDK_Write(char * addr, char * ptr, size_t length, size_t offset){
+    double start = GetTimeStamp();
+    double flush_start;
+    int flushed = 0; /* by the copy, only the drain remains */
+
+    if(!pm.is_pmem){
+      memcpy(&addr[offset], ptr, length);
+    }else{
+#ifdef PMEM_F_MEM_NONTEMPORAL
+      if(o.nontemporal || o.temporal){
+        unsigned flags = PMEM_F_MEM_NODRAIN | (o.nontemporal ? PMEM_F_MEM_NONTEMPORAL : PMEM_F_MEM_TEMPORAL);
+        pmem_memcpy(&addr[offset], ptr, length, flags);
+        flushed = 1;
+      }else
+#endif
+      if(pm.policy == PMDK_FLUSH){
+        memcpy(&addr[offset], ptr, length);
+      }else{
+        pmem_memcpy_nodrain(&addr[offset], ptr, length);
+      }
+    }
+    flush_start = GetTimeStamp();
+    pm.copy_time += flush_start - start;
+    pm.transfers++;
+
+    if(pm.pending == 0){
+      pm.pending_first = start;
+      pm.dirty_start = offset;
+      pm.dirty_end = offset + length;
+    }
+    pm.pending++;
+    pm.pending_start_sum += start;
+    if(offset < pm.dirty_start){
+      pm.dirty_start = offset;
+    }
+    if(offset + length > pm.dirty_end){
+      pm.dirty_end = offset + length;
+    }
+
+    switch(pm.policy){
+    case PMDK_PERSIST:
+      /* with fsyncPerWrite, the fsync drains */
+      if(!hints->fsyncPerWrite){
+        PMDK_Drain(addr);
+      }
+      break;
+    case PMDK_DRAIN:
+      if(pm.pending >= o.drain_every){
+        PMDK_Drain(addr);
+      }
+      break;
+    case PMDK_SEGMENT:
+      if(pm.pending >= pm.transfers_per_segment){
+        PMDK_Drain(addr);
+      }
+      break;
+    case PMDK_FLUSH:
+      if(pm.is_pmem && !flushed){
+        pmem_flush(&addr[offset], length);
+        pm.persist_time += GetTimeStamp() - flush_start;
+      }
+      break;
+    }
+}
+
 
 /*
  * Create and open a memory space through the PMDK interface.
@@ -105,11 +279,7 @@ static aiori_fd_t *PMDK_Create(char * testFileName, int iorflags, aiori_mod_opt_
       MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, -1), "MPI_Abort() error");
     }
 
-    if(!is_pmem){
-      fprintf(stdout, "\n is_pmem is %d\n",is_pmem);
-      fprintf(stdout, "\npmem_map_file thinks the hardware being used is not pmem\n");
-      MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, -1), "MPI_Abort() error");
-    }
+    PMDK_Mapped(testFileName, mapped_len, is_pmem);
 
 
 
@@ -144,10 +314,7 @@ static aiori_fd_t *PMDK_Open(char * testFileName,int iorflags, aiori_mod_opt_t *
       MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, -1), "MPI_Abort() error");
     }
 
-    if(!is_pmem){
-      fprintf(stdout, "pmem_map_file thinks the hardware being used is not pmem\n");
-      MPI_CHECK(MPI_Abort(MPI_COMM_WORLD, -1), "MPI_Abort() error");
-    }
+    PMDK_Mapped(testFileName, mapped_len, is_pmem);
 
     return((void *)pmemaddr);
 } /* PMDK_Open() */
@@ -155,7 +322,7 @@ static aiori_fd_t *PMDK_Open(char * testFileName,int iorflags, aiori_mod_opt_t *
 
 /******************************************************************************/
 /*
- * Write or read access to a memory space created with PMDK. Include drain/flush functionality.
+ * Write or read access to a memory space created with PMDK. Writes are made persistent according to the policy.
  */
 
 static IOR_offset_t PMDK_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer,
@@ -170,11 +337,7 @@ static IOR_offset_t PMDK_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer,
     offset_size = offset;
 
     if(access == WRITE){
-      if(hints->fsyncPerWrite){
-	      pmem_memcpy_nodrain(&file[offset_size], ptr, length);
-      }else{
-        pmem_memcpy_persist(&file[offset_size], ptr, length);
-      }
+      PMDK_Write((char *)file, ptr, length, offset_size);
     }else{
       memcpy(ptr, &file[offset_size], length);
     }
@@ -190,19 +353,23 @@ static IOR_offset_t PMDK_Xfer(int access, aiori_fd_t *file, IOR_size_t * buffer,
 
 static void PMDK_Fsync(aiori_fd_t *fd, aiori_mod_opt_t * param)
 {
-  pmem_drain();
+  PMDK_Drain((char *)fd);
 } /* PMDK_Fsync() */
 
 
 /******************************************************************************/
 /*
- * Stub for close functionality that is not required for PMDK
+ * Make pending writes persistent, report the persistence statistics and unmap the file
  */
 
 static void PMDK_Close(aiori_fd_t *fd, aiori_mod_opt_t * param){
-  size_t open_length;
-  open_length = hints->transferSize;
-  pmem_unmap(fd, open_length);
+  PMDK_Drain((char *)fd);
+  if(rank == 0 && pm.transfers > 0){
+    fprintf(out_logfile, "PMDK %s%s: %" PRIu64 " transfers, copy %.3f s, persistence %.3f s in %" PRIu64 " drains, latency to persistence mean %.1f us max %.1f us on rank 0\n",
+            policy_names[pm.policy], pm.is_pmem ? "" : " (msync)", pm.transfers, pm.copy_time, pm.persist_time,
+            pm.drains, pm.latency_sum * 1e6 / pm.transfers, pm.latency_max * 1e6);
+  }
+  pmem_unmap(fd, pm.mapped_len);
 } /* PMDK_Close() */
 
 
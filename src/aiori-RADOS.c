@@ -19,6 +19,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
 #include <sys/stat.h>
 #include <errno.h>
 #include <rados/librados.h>
@@ -51,12 +53,19 @@ static int RADOS_RmDir(const char *, aiori_mod_opt_t *);
 static int RADOS_Access(const char *, int, aiori_mod_opt_t *);
 static int RADOS_Stat(const char *, struct stat *, aiori_mod_opt_t *);
 static int RADOS_check_params(aiori_mod_opt_t * options);
+static int RADOS_PutBatch(int, char **, IOR_size_t **, IOR_offset_t *, int *, aiori_mod_opt_t *);
+static int RADOS_GetBatch(int, char **, IOR_size_t **, IOR_offset_t *, int *, aiori_mod_opt_t *);
+static int RADOS_RemoveBatch(int, char **, int *, aiori_mod_opt_t *);
+static void RADOS_xfer_hints(aiori_xfer_hint_t *);
 
 /************************** O P T I O N S *****************************/
 typedef struct {
   char * user;
   char * conf;
   char * pool;
+  int async;
+  int window;
+  IOR_offset_t object_size;
 } RADOS_options_t;
 /***************************** F U N C T I O N S ******************************/
 
@@ -71,6 +80,7 @@ static option_help * RADOS_options(aiori_mod_opt_t ** init_backend_options, aior
     o->user = NULL;
     o->conf = NULL;
     o->pool = NULL;
+    o->window = 16;
   }
 
   *init_backend_options = (aiori_mod_opt_t*) o;
@@ -79,6 +89,9 @@ static option_help * RADOS_options(aiori_mod_opt_t ** init_backend_options, aior
     {0, "rados.user", "Username for the RADOS cluster", OPTION_OPTIONAL_ARGUMENT, 's', & o->user},
     {0, "rados.conf", "Config file for the RADOS cluster", OPTION_OPTIONAL_ARGUMENT, 's', & o->conf},
     {0, "rados.pool", "RADOS pool to use for I/O", OPTION_OPTIONAL_ARGUMENT, 's', & o->pool},
+    {0, "rados.async", "Use asynchronous I/O with up to rados.window operations in flight, writes return once their data is copied, sequential reads are fetched ahead within the block", OPTION_FLAG, 'd', & o->async},
+    {0, "rados.window", "Number of asynchronous operations in flight per rank", OPTION_OPTIONAL_ARGUMENT, 'd', & o->window},
+    {0, "rados.objectSize", "Stripe each file across RADOS objects of this size named <file>.<index>, 0 stores each file in one object", OPTION_OPTIONAL_ARGUMENT, 'l', & o->object_size},
     LAST_OPTION
   };
   option_help * help = malloc(sizeof(h));
@@ -106,14 +119,57 @@ ior_aiori_t rados_aiori = {
         .access = RADOS_Access,
         .stat = RADOS_Stat,
         .get_options = RADOS_options,
-        .check_params = RADOS_check_params
+        .check_params = RADOS_check_params,
+        .xfer_hints = RADOS_xfer_hints,
+        .put_batch = RADOS_PutBatch,
+        .get_batch = RADOS_GetBatch,
+        .remove_batch = RADOS_RemoveBatch
 };
 
 static rados_t       rados_cluster;     /* RADOS cluster handle */
 static rados_ioctx_t rados_ioctx;       /* I/O context for our pool in the RADOS cluster */
+static aiori_xfer_hint_t *hints = NULL;
+
+/*
+ * An asynchronous operation on one object; the completion callback records the
+ * return value and the completion time. Writes copy their data into the buffer
+ * of the slot, reads fill it and are copied out once the transfer is requested.
+ */
+typedef struct {
+        rados_completion_t comp;        /* NULL if the slot is free */
+        char *buf;
+        IOR_offset_t size;              /* of buf */
+        IOR_offset_t offset;            /* in the file */
+        IOR_offset_t length;
+        int access;
+        int ret;
+        double start;
+        double end;
+} RADOS_slot_t;
+
+typedef struct {
+        char *oid;
+        RADOS_slot_t *slots;            /* the window in async mode, NULL otherwise */
+        int inflight;
+        int max_inflight;
+        uint64_t ops;
+        double latency;
+        double max_latency;
+        uint64_t ahead_hits;            /* reads completed before they were requested */
+        uint64_t objects;               /* highest index of the objects written + 1 */
+} RADOS_fd_t;
+
+/* prefix of the xattrs of the first object of a striped file recording the objects written per rank */
+#define RADOS_OBJECTS_XATTR "ior.objects."
+
 
 /***************************** F U N C T I O N S ******************************/
 
+static void RADOS_xfer_hints(aiori_xfer_hint_t * params)
+{
+        hints = params;
+}
+
 static int RADOS_check_params(aiori_mod_opt_t * options){
   RADOS_options_t *o = (RADOS_options_t*) options;
   if (!(o->user))
@@ -122,9 +178,116 @@ static int RADOS_check_params(aiori_mod_opt_t * options){
       ERR("RADOS conf must be specified");
   if (!(o->pool))
       ERR("RADOS pool must be specified");
+  if (o->window < 1)
+      ERR("RADOS window must be at least 1");
+  if (o->object_size < 0)
+      ERR("RADOS object size must not be negative");
   return 0;
 }
 
+/* name of the object with the given index of a (striped) file */
+static void RADOS_ObjName(char *out, const char *oid, uint64_t idx, RADOS_options_t *o)
+{
+        if (o->object_size == 0)
+                strcpy(out, oid);
+        else
+                sprintf(out, "%s.%016" PRIx64, oid, idx);
+}
+
+/*
+ * Maps the file range starting at offset to the object holding its beginning,
+ * returns the length of the range within that object.
+ */
+static IOR_offset_t RADOS_Piece(RADOS_options_t *o, const char *oid, IOR_offset_t offset,
+                                IOR_offset_t length, char *name, IOR_offset_t *obj_offset)
+{
+        if (o->object_size == 0) {
+                RADOS_ObjName(name, oid, 0, o);
+                *obj_offset = offset;
+                return length;
+        }
+        RADOS_ObjName(name, oid, offset / o->object_size, o);
+        *obj_offset = offset % o->object_size;
+        if (length > o->object_size - *obj_offset)
+                return o->object_size - *obj_offset;
+        return length;
+}
+
+/* size of the object or -1 if it does not exist */
+static int64_t RADOS_ObjSize(const char *name)
+{
+        rados_read_op_t stat_op;
+        uint64_t size;
+        int stat_ret;
+        int ret;
+
+        stat_op = rados_create_read_op();
+        rados_read_op_stat(stat_op, &size, NULL, &stat_ret);
+        ret = rados_read_op_operate(stat_op, rados_ioctx, name, 0);
+        rados_release_read_op(stat_op);
+        if (ret || stat_ret)
+                return -1;
+        return size;
+}
+
+/*
+ * Number of objects of a striped file: the writers record the highest object they
+ * wrote in xattrs of the first object, objects below it may be missing. Files
+ * without these xattrs are assumed to be written without gaps, so the last
+ * object is found by an exponential and a binary search over the indices.
+ */
+static uint64_t RADOS_ObjCount(const char *oid, RADOS_options_t *o)
+{
+        char name[MAX_PATHLEN];
+        uint64_t lo = 0, hi = 1;
+        rados_xattrs_iter_t iter;
+        int found = 0;
+
+        RADOS_ObjName(name, oid, 0, o);
+        if (RADOS_ObjSize(name) < 0)
+                return 0;
+        if (rados_getxattrs(rados_ioctx, name, &iter) == 0) {
+                const char *key;
+                const char *val;
+                size_t len;
+
+                while (rados_getxattrs_next(iter, &key, &val, &len) == 0 && key != NULL) {
+                        char buf[32];
+                        uint64_t count;
+
+                        if (strncmp(key, RADOS_OBJECTS_XATTR, strlen(RADOS_OBJECTS_XATTR)) != 0 ||
+                            len >= sizeof(buf))
+                                continue;
+                        memcpy(buf, val, len);
+                        buf[len] = 0;
+                        count = strtoull(buf, NULL, 10);
+                        if (count > lo)
+                                lo = count;
+                        found = 1;
+                }
+                rados_getxattrs_end(iter);
+        }
+        if (found)
+                return lo > 0 ? lo : 1;
+        for (;;) {
+                RADOS_ObjName(name, oid, hi, o);
+                if (RADOS_ObjSize(name) < 0)
+                        break;
+                lo = hi;
+                hi *= 2;
+        }
+        /* lo exists, hi does not */
+        while (hi - lo > 1) {
+                uint64_t mid = lo + (hi - lo) / 2;
+                RADOS_ObjName(name, oid, mid, o);
+                if (RADOS_ObjSize(name) < 0)
+                        hi = mid;
+                else
+                        lo = mid;
+        }
+        return hi;
+}
+
 static void RADOS_Initialize(aiori_mod_opt_t * options)
 {
         RADOS_options_t *o = (RADOS_options_t*) options;
@@ -164,27 +327,35 @@ static void RADOS_Finalize(aiori_mod_opt_t * options)
 
 static aiori_fd_t *RADOS_Create_Or_Open(char *testFileName, int flags, aiori_mod_opt_t *param)
 {
+        RADOS_options_t *o = (RADOS_options_t *)param;
+        RADOS_fd_t *fd;
         int ret;
-        char *oid;
 
-        oid = strdup(testFileName);
-        if (!oid)
+        fd = calloc(1, sizeof(RADOS_fd_t));
+        if (!fd)
+                ERR("unable to allocate RADOS file descriptor");
+        fd->oid = strdup(testFileName);
+        if (!fd->oid)
                 ERR("unable to allocate RADOS oid");
 
         if (flags & IOR_CREAT)
         {
                 rados_write_op_t create_op;
                 int rados_create_flag;
+                char name[MAX_PATHLEN];
 
                 if (flags & IOR_EXCL)
                         rados_create_flag = LIBRADOS_CREATE_EXCLUSIVE;
                 else
                         rados_create_flag = LIBRADOS_CREATE_IDEMPOTENT;
 
+                /* a striped file exists once its first object exists */
+                RADOS_ObjName(name, fd->oid, 0, o);
+
                 /* create a RADOS "write op" for creating the object */
                 create_op = rados_create_write_op();
                 rados_write_op_create(create_op, rados_create_flag, NULL);
-                ret = rados_write_op_operate(create_op, rados_ioctx, oid,
+                ret = rados_write_op_operate(create_op, rados_ioctx, name,
                                        NULL, 0);
                 rados_release_write_op(create_op);
                 if (ret)
@@ -195,7 +366,13 @@ static aiori_fd_t *RADOS_Create_Or_Open(char *testFileName, int flags, aiori_mod
                 /* XXX actually, we should probably assert oid existence here? */
         }
 
-        return (aiori_fd_t *)oid;
+        if (o->async) {
+                fd->slots = calloc(o->window, sizeof(RADOS_slot_t));
+                if (!fd->slots)
+                        ERR("unable to allocate RADOS window");
+        }
+
+        return (aiori_fd_t *)fd;
 }
 
 static aiori_fd_t *RADOS_Create(char *testFileName, int flags, aiori_mod_opt_t *param)
@@ -208,11 +385,11 @@ static aiori_fd_t *RADOS_Open(char *testFileName, int flags, aiori_mod_opt_t *pa
         return RADOS_Create_Or_Open(testFileName, flags, param);
 }
 
-static IOR_offset_t RADOS_Xfer(int access, aiori_fd_t *fd, IOR_size_t * buffer,
-                               IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param)
+/* synchronous I/O of a range within one object */
+static void RADOS_SyncXfer(int access, const char *name, char *buffer,
+                           IOR_offset_t length, IOR_offset_t offset)
 {
         int ret;
-        char *oid = (char *)fd;
 
         if (access == WRITE)
         {
@@ -222,7 +399,7 @@ static IOR_offset_t RADOS_Xfer(int access, aiori_fd_t *fd, IOR_size_t * buffer,
                 rados_write_op_write(write_op, (const char *)buffer,
                                      length, offset);
                 ret = rados_write_op_operate(write_op, rados_ioctx,
-                                             oid, NULL, 0);
+                                             name, NULL, 0);
                 rados_release_write_op(write_op);
                 if (ret)
                         RADOS_ERR("unable to write RADOS object", ret);
@@ -234,43 +411,318 @@ static IOR_offset_t RADOS_Xfer(int access, aiori_fd_t *fd, IOR_size_t * buffer,
                 rados_read_op_t read_op;
 
                 read_op = rados_create_read_op();
-                rados_read_op_read(read_op, offset, length, (char *)buffer,
+                rados_read_op_read(read_op, offset, length, buffer,
                                    &bytes_read, &read_ret);
-                ret = rados_read_op_operate(read_op, rados_ioctx, oid, 0);
+                ret = rados_read_op_operate(read_op, rados_ioctx, name, 0);
                 rados_release_read_op(read_op);
                 if (ret || read_ret || ((IOR_offset_t)bytes_read != length))
                         RADOS_ERR("unable to read RADOS object", ret);
         }
+}
+
+static void RADOS_Complete(rados_completion_t comp, void *arg)
+{
+        RADOS_slot_t *slot = (RADOS_slot_t *)arg;
+
+        slot->ret = rados_aio_get_return_value(comp);
+        slot->end = GetTimeStamp();
+}
+
+/* waits for the operation of the slot, checks its result and frees the slot */
+static void RADOS_Reap(RADOS_fd_t *fd, RADOS_slot_t *slot)
+{
+        double latency;
+
+        rados_aio_wait_for_complete_and_cb(slot->comp);
+        rados_aio_release(slot->comp);
+        slot->comp = NULL;
+        fd->inflight--;
+        latency = slot->end - slot->start;
+        fd->ops++;
+        fd->latency += latency;
+        if (latency > fd->max_latency)
+                fd->max_latency = latency;
+        if (slot->ret < 0)
+                RADOS_ERR(slot->access == WRITE ? "unable to write RADOS object" :
+                          "unable to read RADOS object", slot->ret);
+        /* reads return the number of bytes read */
+        if (slot->access == READ && slot->ret != slot->length)
+                ERR("unable to read RADOS object");
+}
+
+/*
+ * Returns a free slot; if the window is full, a completed write or else the
+ * oldest operation is reaped. Reads ahead stay until they are requested.
+ */
+static RADOS_slot_t *RADOS_FreeSlot(RADOS_fd_t *fd, RADOS_options_t *o)
+{
+        RADOS_slot_t *oldest = NULL;
+        int i;
+
+        for (i = 0; i < o->window; i++) {
+                if (fd->slots[i].comp == NULL)
+                        return &fd->slots[i];
+        }
+        for (i = 0; i < o->window; i++) {
+                RADOS_slot_t *slot = &fd->slots[i];
+                if (slot->access == WRITE && rados_aio_is_complete_and_cb(slot->comp)) {
+                        RADOS_Reap(fd, slot);
+                        return slot;
+                }
+                if (oldest == NULL || slot->start < oldest->start)
+                        oldest = slot;
+        }
+        RADOS_Reap(fd, oldest);
+        return oldest;
+}
+
+/* issues the asynchronous I/O of a range within one object */
+static void RADOS_Post(RADOS_fd_t *fd, RADOS_options_t *o, int access, const char *name,
+                       const char *data, IOR_offset_t length, IOR_offset_t obj_offset,
+                       IOR_offset_t offset)
+{
+        RADOS_slot_t *slot = RADOS_FreeSlot(fd, o);
+        int ret;
+
+        if (slot->size < length) {
+                free(slot->buf);
+                slot->buf = safeMalloc(length);
+                slot->size = length;
+        }
+        slot->access = access;
+        slot->offset = offset;
+        slot->length = length;
+        slot->ret = 0;
+        slot->start = GetTimeStamp();
+        slot->end = slot->start;
+        ret = rados_aio_create_completion(slot, RADOS_Complete, NULL, &slot->comp);
+        if (ret)
+                RADOS_ERR("unable to create RADOS completion", ret);
+        if (access == WRITE) {
+                memcpy(slot->buf, data, length);
+                ret = rados_aio_write(rados_ioctx, name, slot->comp, slot->buf,
+                                      length, obj_offset);
+        } else {
+                ret = rados_aio_read(rados_ioctx, name, slot->comp, slot->buf,
+                                     length, obj_offset);
+        }
+        if (ret)
+                RADOS_ERR("unable to submit RADOS operation", ret);
+        fd->inflight++;
+        if (fd->inflight > fd->max_inflight)
+                fd->max_inflight = fd->inflight;
+}
+
+/* the slot reading the file range or NULL */
+static RADOS_slot_t *RADOS_FindRead(RADOS_fd_t *fd, RADOS_options_t *o,
+                                    IOR_offset_t offset, IOR_offset_t length)
+{
+        int i;
+
+        for (i = 0; i < o->window; i++) {
+                RADOS_slot_t *slot = &fd->slots[i];
+                if (slot->comp != NULL && slot->access == READ &&
+                    slot->offset == offset && slot->length == length)
+                        return slot;
+        }
+        return NULL;
+}
+
+/* posts the reads of the file range that are not in flight yet */
+static void RADOS_PostReads(RADOS_fd_t *fd, RADOS_options_t *o,
+                            IOR_offset_t offset, IOR_offset_t length)
+{
+        char name[MAX_PATHLEN];
+        IOR_offset_t obj_offset;
+        IOR_offset_t pos, len;
+
+        for (pos = 0; pos < length; pos += len) {
+                len = RADOS_Piece(o, fd->oid, offset + pos, length - pos, name, &obj_offset);
+                if (RADOS_FindRead(fd, o, offset + pos, len) == NULL)
+                        RADOS_Post(fd, o, READ, name, NULL, len, obj_offset, offset + pos);
+        }
+}
+
+/*
+ * Asynchronous reads: the objects of the requested transfer are read concurrently
+ * and, with sequential offsets, the following transfers of the block are fetched
+ * ahead into the free slots of the window.
+ */
+static void RADOS_AsyncRead(RADOS_fd_t *fd, RADOS_options_t *o, char *buffer,
+                            IOR_offset_t length, IOR_offset_t offset)
+{
+        char name[MAX_PATHLEN];
+        IOR_offset_t obj_offset;
+        IOR_offset_t pos, len;
+        int i;
+
+        /* reads ahead of other offsets are stale */
+        for (i = 0; i < o->window; i++) {
+                RADOS_slot_t *slot = &fd->slots[i];
+                if (slot->comp != NULL && slot->access == READ &&
+                    (slot->offset < offset || slot->offset >= offset + length * o->window))
+                        RADOS_Reap(fd, slot);
+        }
+
+        RADOS_PostReads(fd, o, offset, length);
+        if (hints != NULL && !hints->randomOffset && hints->blockSize > 0) {
+                IOR_offset_t block_end = offset - offset % hints->blockSize + hints->blockSize;
+                IOR_offset_t pieces = o->object_size ? length / o->object_size + 2 : 1;
+                IOR_offset_t ahead;
+
+                for (ahead = offset + length; ahead + length <= block_end &&
+                     fd->inflight + pieces <= o->window; ahead += length)
+                        RADOS_PostReads(fd, o, ahead, length);
+        }
+
+        for (pos = 0; pos < length; pos += len) {
+                RADOS_slot_t *slot;
+
+                len = RADOS_Piece(o, fd->oid, offset + pos, length - pos, name, &obj_offset);
+                slot = RADOS_FindRead(fd, o, offset + pos, len);
+                if (slot == NULL) {
+                        /* reaped to make room if the transfer spans more objects than the window */
+                        RADOS_SyncXfer(READ, name, buffer + pos, len, obj_offset);
+                        continue;
+                }
+                if (rados_aio_is_complete_and_cb(slot->comp))
+                        fd->ahead_hits++;
+                RADOS_Reap(fd, slot);
+                memcpy(buffer + pos, slot->buf, len);
+        }
+}
+
+/* waits for all operations in flight */
+static void RADOS_Drain(RADOS_fd_t *fd, RADOS_options_t *o)
+{
+        int i;
+
+        if (fd->slots == NULL)
+                return;
+        for (i = 0; i < o->window; i++) {
+                if (fd->slots[i].comp != NULL)
+                        RADOS_Reap(fd, &fd->slots[i]);
+        }
+}
+
+static IOR_offset_t RADOS_Xfer(int access, aiori_fd_t *afd, IOR_size_t * buffer,
+                               IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * param)
+{
+        RADOS_options_t *o = (RADOS_options_t *)param;
+        RADOS_fd_t *fd = (RADOS_fd_t *)afd;
+        char name[MAX_PATHLEN];
+        IOR_offset_t obj_offset;
+        IOR_offset_t pos, len;
+
+        /* the checks of -W and -R read as well */
+        if (fd->slots != NULL && access != WRITE) {
+                RADOS_AsyncRead(fd, o, (char *)buffer, length, offset);
+                if (access != READ)
+                        RADOS_Drain(fd, o);
+                return length;
+        }
+
+        /* a transfer may span several objects of a striped file */
+        for (pos = 0; pos < length; pos += len) {
+                len = RADOS_Piece(o, fd->oid, offset + pos, length - pos, name, &obj_offset);
+                if (access == WRITE && o->object_size > 0 &&
+                    (uint64_t)((offset + pos) / o->object_size) >= fd->objects)
+                        fd->objects = (offset + pos) / o->object_size + 1;
+                if (fd->slots != NULL)
+                        RADOS_Post(fd, o, WRITE, name, (char *)buffer + pos, len, obj_offset, offset + pos);
+                else
+                        RADOS_SyncXfer(access, name, (char *)buffer + pos, len, obj_offset);
+        }
 
         return length;
 }
 
 static void RADOS_Fsync(aiori_fd_t *fd, aiori_mod_opt_t * param)
 {
+        RADOS_Drain((RADOS_fd_t *)fd, (RADOS_options_t *)param);
         return;
 }
 
-static void RADOS_Close(aiori_fd_t *fd, aiori_mod_opt_t * param)
+static void RADOS_Close(aiori_fd_t *afd, aiori_mod_opt_t * param)
 {
-        char *oid = (char *)fd;
+        RADOS_options_t *o = (RADOS_options_t *)param;
+        RADOS_fd_t *fd = (RADOS_fd_t *)afd;
+        int i;
+
+        /* record the objects written by this rank for RADOS_ObjCount() */
+        if (fd->objects > 0) {
+                char name[MAX_PATHLEN];
+                char key[64];
+                char val[32];
+                int ret;
+
+                RADOS_ObjName(name, fd->oid, 0, o);
+                sprintf(key, RADOS_OBJECTS_XATTR "%d", rank);
+                sprintf(val, "%" PRIu64, fd->objects);
+                ret = rados_setxattr(rados_ioctx, name, key, val, strlen(val));
+                if (ret)
+                        RADOS_ERR("unable to set RADOS xattr", ret);
+        }
 
-        /* object does not need to be "closed" */
-        free(oid);
+        /* object does not need to be "closed", but the operations in flight must complete */
+        if (fd->slots != NULL) {
+                RADOS_Drain(fd, o);
+                if (rank == 0 && fd->ops > 0)
+                        fprintf(out_logfile, "RADOS async: %" PRIu64 " ops, up to %d in flight, latency mean %.3f ms max %.3f ms, %" PRIu64 " reads completed ahead on rank 0\n",
+                                fd->ops, fd->max_inflight, fd->latency * 1e3 / fd->ops,
+                                fd->max_latency * 1e3, fd->ahead_hits);
+                for (i = 0; i < o->window; i++)
+                        free(fd->slots[i].buf);
+                free(fd->slots);
+        }
+        free(fd->oid);
+        free(fd);
 
         return;
 }
 
 static void RADOS_Delete(char *testFileName, aiori_mod_opt_t * param)
 {
+        RADOS_options_t *o = (RADOS_options_t *)param;
         int ret;
         char *oid = testFileName;
+        char name[MAX_PATHLEN];
         rados_write_op_t remove_op;
+        uint64_t count = 1;
+
+        if (o->object_size > 0)
+                count = RADOS_ObjCount(oid, o);
+
+        /* the objects of a striped file are removed concurrently */
+        if (count > 1) {
+                char **names = safeMalloc(sizeof(char *) * count);
+                char *name_buf = safeMalloc(MAX_PATHLEN * count);
+                int *status = safeMalloc(sizeof(int) * count);
+                uint64_t i;
+
+                for (i = 0; i < count; i++) {
+                        names[i] = name_buf + MAX_PATHLEN * i;
+                        RADOS_ObjName(names[i], oid, i, o);
+                }
+                /* objects in gaps of the file do not exist */
+                if (RADOS_RemoveBatch(count, names, status, param) != (int)count) {
+                        for (i = 0; i < count; i++) {
+                                if (status[i] != 0 && RADOS_ObjSize(names[i]) >= 0)
+                                        ERR("unable to remove RADOS object");
+                        }
+                }
+                free(status);
+                free(name_buf);
+                free(names);
+                return;
+        }
+        RADOS_ObjName(name, oid, 0, o);
 
         /* remove the object */
         remove_op = rados_create_write_op();
         rados_write_op_remove(remove_op);
         ret = rados_write_op_operate(remove_op, rados_ioctx,
-                                     oid, NULL, 0);
+                                     name, NULL, 0);
         rados_release_write_op(remove_op);
         if (ret)
                 RADOS_ERR("unable to remove RADOS object", ret);
@@ -280,23 +732,27 @@ static void RADOS_Delete(char *testFileName, aiori_mod_opt_t * param)
 
 static IOR_offset_t RADOS_GetFileSize(aiori_mod_opt_t *param, char *testFileName)
 {
-        int ret;
-        char *oid = testFileName;
-        rados_read_op_t stat_op;
-        uint64_t oid_size;
-        int stat_ret;
-        IOR_offset_t aggSizeFromStat, tmpMin, tmpMax, tmpSum;
-
-        /* stat the object */
-        stat_op = rados_create_read_op();
-        rados_read_op_stat(stat_op, &oid_size, NULL, &stat_ret);
-        ret = rados_read_op_operate(stat_op, rados_ioctx, oid, 0);
-        rados_release_read_op(stat_op);
-        if (ret || stat_ret)
-                RADOS_ERR("unable to stat RADOS object", stat_ret);
-        aggSizeFromStat = oid_size;
+        RADOS_options_t *o = (RADOS_options_t *)param;
+        char name[MAX_PATHLEN];
+        uint64_t count = 1;
+        int64_t oid_size;
+
+        /* the size is given by the last object of a striped file that exists */
+        if (o->object_size > 0)
+                count = RADOS_ObjCount(testFileName, o);
+        if (count == 0)
+                count = 1;
+        for (;;) {
+                RADOS_ObjName(name, testFileName, count - 1, o);
+                oid_size = RADOS_ObjSize(name);
+                if (oid_size >= 0 || count == 1)
+                        break;
+                count--;
+        }
+        if (oid_size < 0)
+                RADOS_ERR("unable to stat RADOS object", -ENOENT);
 
-        return aggSizeFromStat;
+        return (IOR_offset_t)(count - 1) * o->object_size + oid_size;
 }
 
 static int RADOS_StatFS(const char *oid, ior_aiori_statfs_t *stat_buf,
@@ -320,18 +776,11 @@ static int RADOS_RmDir(const char *oid, aiori_mod_opt_t * param)
 
 static int RADOS_Access(const char *oid, int mode, aiori_mod_opt_t * param)
 {
-        rados_read_op_t read_op;
-        int ret;
-        int prval;
-        uint64_t oid_size;
-
-        /* use read_op stat to check for oid existence */
-        read_op = rados_create_read_op();
-        rados_read_op_stat(read_op, &oid_size, NULL, &prval);
-        ret = rados_read_op_operate(read_op, rados_ioctx, oid, 0);
-        rados_release_read_op(read_op);
+        char name[MAX_PATHLEN];
 
-        if (ret | prval)
+        /* use a stat of the (first) object to check for oid existence */
+        RADOS_ObjName(name, oid, 0, (RADOS_options_t *)param);
+        if (RADOS_ObjSize(name) < 0)
                 return -1;
         else
                 return 0;
@@ -342,3 +791,94 @@ static int RADOS_Stat(const char *oid, struct stat *buf, aiori_mod_opt_t * param
         WARN("stat not supported in RADOS backend!");
         return -1;
 }
+
+/*
+ * Batch operations issue one asynchronous operation per object and wait for
+ * all of them, so the whole batch costs a single round trip.
+ */
+static int RADOS_WaitBatch(int count, rados_completion_t *comps, IOR_offset_t *sizes,
+                           int *status)
+{
+        int i;
+        int success = 0;
+
+        for (i = 0; i < count; i++) {
+                int ret;
+
+                if (comps[i] == NULL) {
+                        status[i] = -1;
+                        continue;
+                }
+                rados_aio_wait_for_complete(comps[i]);
+                ret = rados_aio_get_return_value(comps[i]);
+                rados_aio_release(comps[i]);
+                /* reads return the number of bytes read */
+                if (ret < 0 || (sizes != NULL && ret != sizes[i])) {
+                        status[i] = -1;
+                } else {
+                        status[i] = 0;
+                        success++;
+                }
+        }
+        free(comps);
+        return success;
+}
+
+static int RADOS_PutBatch(int count, char **names, IOR_size_t **buffers,
+                          IOR_offset_t *sizes, int *status, aiori_mod_opt_t *param)
+{
+        int i;
+        rados_completion_t *comps = safeMalloc(sizeof(rados_completion_t) * count);
+
+        for (i = 0; i < count; i++) {
+                int ret = rados_aio_create_completion(NULL, NULL, NULL, &comps[i]);
+                if (ret)
+                        RADOS_ERR("unable to create RADOS completion", ret);
+                ret = rados_aio_write_full(rados_ioctx, names[i], comps[i],
+                                           (const char *)buffers[i], sizes[i]);
+                if (ret) {
+                        rados_aio_release(comps[i]);
+                        comps[i] = NULL;
+                }
+        }
+        return RADOS_WaitBatch(count, comps, NULL, status);
+}
+
+static int RADOS_GetBatch(int count, char **names, IOR_size_t **buffers,
+                          IOR_offset_t *sizes, int *status, aiori_mod_opt_t *param)
+{
+        int i;
+        rados_completion_t *comps = safeMalloc(sizeof(rados_completion_t) * count);
+
+        for (i = 0; i < count; i++) {
+                int ret = rados_aio_create_completion(NULL, NULL, NULL, &comps[i]);
+                if (ret)
+                        RADOS_ERR("unable to create RADOS completion", ret);
+                ret = rados_aio_read(rados_ioctx, names[i], comps[i],
+                                     (char *)buffers[i], sizes[i], 0);
+                if (ret) {
+                        rados_aio_release(comps[i]);
+                        comps[i] = NULL;
+                }
+        }
+        return RADOS_WaitBatch(count, comps, sizes, status);
+}
+
+static int RADOS_RemoveBatch(int count, char **names, int *status,
+                             aiori_mod_opt_t *param)
+{
+        int i;
+        rados_completion_t *comps = safeMalloc(sizeof(rados_completion_t) * count);
+
+        for (i = 0; i < count; i++) {
+                int ret = rados_aio_create_completion(NULL, NULL, NULL, &comps[i]);
+                if (ret)
+                        RADOS_ERR("unable to create RADOS completion", ret);
+                ret = rados_aio_remove(rados_ioctx, names[i], comps[i]);
+                if (ret) {
+                        rados_aio_release(comps[i]);
+                        comps[i] = NULL;
+                }
+        }
+        return RADOS_WaitBatch(count, comps, NULL, status);
+}
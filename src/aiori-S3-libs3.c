@@ -12,8 +12,13 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <time.h>
+#include <sys/select.h>
 
 #include <libs3.h>
+#if defined(HAVE_S3_CREATE_REQUEST_CONTEXT_EX) && defined(HAVE_CURL_CURL_H)
+#  include <curl/curl.h>
+#  define S3_HTTP_TIMING
+#endif
 
 #include "ior.h"
 #include "aiori.h"
@@ -42,6 +47,13 @@ typedef struct {
   int dont_suffix;
   int s3_compatible;
   int use_ssl;
+  int multipart;
+  int parallel_parts;
+  IOR_offset_t range_size;
+  int parallel_ranges;
+  int read_ahead;
+  int http_timing;
+  int list_stat;
   S3BucketContext bucket_context;
   S3Protocol s3_protocol;
 } s3_options_t;
@@ -57,6 +69,12 @@ static option_help * S3_options(aiori_mod_opt_t ** init_backend_options, aiori_m
   *init_backend_options = (aiori_mod_opt_t*) o;
   o->bucket_prefix = "ior";
   o->bucket_prefix_cur = "b";
+  if(o->parallel_parts == 0){
+    o->parallel_parts = 1;
+  }
+  if(o->parallel_ranges == 0){
+    o->parallel_ranges = 1;
+  }
 
   option_help h [] = {
   {0, "S3-libs3.bucket-per-file", "Use one bucket to map one file/directory, otherwise one bucket is used to store all dirs/files.", OPTION_FLAG, 'd', & o->bucket_per_file},
@@ -69,6 +87,13 @@ static option_help * S3_options(aiori_mod_opt_t ** init_backend_options, aiori_m
   {0, "S3-libs3.access-key", "The access key.", OPTION_OPTIONAL_ARGUMENT, 's', & o->access_key},
   {0, "S3-libs3.region", "The region used for the authorization signature.", OPTION_OPTIONAL_ARGUMENT, 's', & o->authRegion},
   {0, "S3-libs3.location", "The bucket geographic location.", OPTION_OPTIONAL_ARGUMENT, 's', & o->locationConstraint},
+  {0, "S3-libs3.multipart", "Write each file as one object with a multipart upload, every transfer is one part (at most 10000 parts of at least 5 MiB except the last one); reads use byte ranges of the object.", OPTION_FLAG, 'd', & o->multipart},
+  {0, "S3-libs3.range-size", "Split reads into GET requests of this many bytes, 0 reads each transfer with one request.", OPTION_OPTIONAL_ARGUMENT, 'l', & o->range_size},
+  {0, "S3-libs3.parallel-ranges", "Number of concurrent range requests per rank.", OPTION_OPTIONAL_ARGUMENT, 'd', & o->parallel_ranges},
+  {0, "S3-libs3.read-ahead", "In multipart mode, read the object in windows of parallel-ranges * range-size bytes and fetch the next window ahead.", OPTION_FLAG, 'd', & o->read_ahead},
+  {0, "S3-libs3.http-timing", "Collect the DNS, connect, TLS, time to first byte and transfer times and the connection reuse of all requests from libcurl, summed over the ranks per file with several transfers per rank and at the end.", OPTION_FLAG, 'd', & o->http_timing},
+  {0, "S3-libs3.list-stat", "Stat a batch of objects by listing the bucket with the common prefix of their keys instead of one HEAD request per object.", OPTION_FLAG, 'd', & o->list_stat},
+  {0, "S3-libs3.parallel-parts", "Number of parts each rank uploads concurrently in multipart mode, each needs a buffer of the transfer size.", OPTION_OPTIONAL_ARGUMENT, 'd', & o->parallel_parts},
   LAST_OPTION
   };
   option_help * help = malloc(sizeof(h));
@@ -136,12 +161,132 @@ struct data_handling{
 static S3Status s3status = S3StatusInterrupted;
 static S3ErrorDetails s3error = {NULL};
 
+/*
+ * HTTP timing: requests are issued in request contexts whose setup callback captures the curl
+ * handle, the timing of libcurl is read when the request completes. Blocking requests run in
+ * s3_sync_ctx, which is NULL if timing is disabled.
+ */
+typedef struct{
+  long long requests;
+  long long new_connections;
+  double dns;
+  double connect;
+  double tls;
+  double ttfb;
+  double transfer;
+  double total;
+  double total_max;
+} s3_http_stats_t;
+
+static s3_http_stats_t http_stats;
+static int http_timing = 0;
+static S3RequestContext * s3_sync_ctx = NULL;
+static void ** s3_setup_target = NULL; /* receives the curl handle of the next request */
+static void * s3_last_easy = NULL;     /* curl handle of the last blocking request */
+
+#ifdef S3_HTTP_TIMING
+static S3Status s3_setup_curl(void * curl_multi, void * curl_easy, void * data){
+  if(s3_setup_target != NULL){
+    *s3_setup_target = curl_easy;
+  }else{
+    s3_last_easy = curl_easy;
+  }
+  return S3StatusOK;
+}
+#endif
+
+static void s3_http_record(void * easy){
+#ifdef S3_HTTP_TIMING
+  double dns = 0, connect = 0, tls = 0, pretransfer = 0, ttfb = 0, total = 0;
+  long connects = 0;
+  if(! http_timing || easy == NULL){
+    return;
+  }
+  curl_easy_getinfo(easy, CURLINFO_NAMELOOKUP_TIME, & dns);
+  curl_easy_getinfo(easy, CURLINFO_CONNECT_TIME, & connect);
+  curl_easy_getinfo(easy, CURLINFO_APPCONNECT_TIME, & tls);
+  curl_easy_getinfo(easy, CURLINFO_PRETRANSFER_TIME, & pretransfer);
+  curl_easy_getinfo(easy, CURLINFO_STARTTRANSFER_TIME, & ttfb);
+  curl_easy_getinfo(easy, CURLINFO_TOTAL_TIME, & total);
+  curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, & connects);
+  /* the times are cumulative since the start of the request */
+  http_stats.requests++;
+  http_stats.new_connections += connects;
+  http_stats.dns += dns;
+  http_stats.connect += connect > dns ? connect - dns : 0;
+  http_stats.tls += tls > connect ? tls - connect : 0;
+  http_stats.ttfb += ttfb;
+  http_stats.transfer += total > ttfb ? total - ttfb : 0;
+  http_stats.total += total;
+  if(total > http_stats.total_max){
+    http_stats.total_max = total;
+  }
+#endif
+}
+
+/* collective on testComm, prints the sums of all ranks and the min/mean/max of the per-rank average on rank 0 */
+static void s3_http_report(const char * what){
+  s3_http_stats_t * s = & http_stats;
+  MPI_Comm com = testComm == MPI_COMM_NULL ? MPI_COMM_WORLD : testComm;
+  /* the average request time of ranks without requests does not count */
+  double avg = s->requests > 0 ? s->total / s->requests : 0;
+  double local[9] = {s->requests, s->new_connections, s->dns, s->connect, s->tls, s->ttfb, s->transfer, s->total, avg};
+  double sum[9];
+  double avg_min, avg_max, max;
+  int active = s->requests > 0, active_sum;
+  int com_rank;
+  MPI_CHECK(MPI_Comm_rank(com, & com_rank), "MPI_Comm_rank() error");
+  MPI_CHECK(MPI_Reduce(local, sum, 9, MPI_DOUBLE, MPI_SUM, 0, com), "MPI_Reduce() error");
+  MPI_CHECK(MPI_Reduce(& s->total_max, & max, 1, MPI_DOUBLE, MPI_MAX, 0, com), "MPI_Reduce() error");
+  MPI_CHECK(MPI_Reduce(& avg, & avg_max, 1, MPI_DOUBLE, MPI_MAX, 0, com), "MPI_Reduce() error");
+  MPI_CHECK(MPI_Reduce(& active, & active_sum, 1, MPI_INT, MPI_SUM, 0, com), "MPI_Reduce() error");
+  if(! active){
+    avg = 1e300;
+  }
+  MPI_CHECK(MPI_Reduce(& avg, & avg_min, 1, MPI_DOUBLE, MPI_MIN, 0, com), "MPI_Reduce() error");
+  memset(s, 0, sizeof(s3_http_stats_t));
+  if(com_rank != 0 || sum[0] == 0){
+    return;
+  }
+  double n = sum[0];
+  fprintf(out_logfile, "S3 HTTP %s: %.0f requests, %.0f new connections (%.1f%% reused), avg ms: DNS %.3f connect %.3f TLS %.3f TTFB %.3f transfer %.3f total %.3f, per rank avg total ms: min %.3f mean %.3f max %.3f, max total %.3f\n",
+    what, n, sum[1], 100.0 * (n - sum[1]) / n,
+    sum[2] / n * 1e3, sum[3] / n * 1e3, sum[4] / n * 1e3, sum[5] / n * 1e3,
+    sum[6] / n * 1e3, sum[7] / n * 1e3, avg_min * 1e3, sum[8] / active_sum * 1e3, avg_max * 1e3, max * 1e3);
+}
+
+static void s3_create_context(S3RequestContext ** ctx){
+  S3Status ret;
+#ifdef S3_HTTP_TIMING
+  if(http_timing){
+    ret = S3_create_request_context_ex(ctx, NULL, s3_setup_curl, NULL);
+  }else
+#endif
+  ret = S3_create_request_context(ctx);
+  if(ret != S3StatusOK){
+    FAIL("Could not create S3 request context");
+  }
+}
+
+/* complete a blocking request issued in s3_sync_ctx */
+static void s3_sync_run(void){
+  if(s3_sync_ctx == NULL){
+    return;
+  }
+  S3Status ret = S3_runall_request_context(s3_sync_ctx);
+  if(ret != S3StatusOK && s3status == S3StatusOK){
+    s3status = ret;
+  }
+}
+
 static S3Status responsePropertiesCallback(const S3ResponseProperties *properties, void *callbackData){
   s3status = S3StatusOK;
   return s3status;
 }
 
 static void responseCompleteCallback(S3Status status, const S3ErrorDetails *error, void *callbackData) {
+  s3_http_record(s3_last_easy);
+  s3_last_easy = NULL;
   s3status = status;
   if (error == NULL){
     s3error.message = NULL;
@@ -201,17 +346,140 @@ static int S3_statfs (const char * path, ior_aiori_statfs_t * stat, aiori_mod_op
   return 0;
 }
 
+#define S3_MPU_ID_SIZE 1024
+#define S3_ETAG_SIZE 128
+/* limits of a multipart upload, the last part may be smaller */
+#define S3_MPU_MAX_PARTS 10000
+#define S3_MPU_MIN_PART_SIZE (5 * 1024 * 1024)
+
 static S3Status S3multipart_handler(const char *upload_id, void *callbackData){
-  *((char const**)(callbackData)) = upload_id;
+  /* the upload id is only valid during the callback */
+  snprintf((char*) callbackData, S3_MPU_ID_SIZE, "%s", upload_id);
   return S3StatusOK;
 }
 
 static S3MultipartInitialHandler multipart_handler = { {&responsePropertiesCallback, &responseCompleteCallback }, & S3multipart_handler};
 
+/*
+ * Multipart upload: each transfer is one part with the part number offset / transferSize + 1.
+ * A rank keeps up to parallel-parts uploads in flight in one libs3 request context, each with
+ * its own copy of the data. For a shared file, rank 0 initiates the upload and completes it
+ * with the ETags of all ranks ordered by part number.
+ */
+typedef struct{
+  int number;
+  char etag[S3_ETAG_SIZE];
+} s3_part_t;
+
+struct s3_mpu;
+
+typedef struct{
+  struct data_handling dh; // do not reorder, the data callbacks use it
+  struct s3_mpu * mpu;
+  char * buf;
+  int busy;
+  int number;
+  double start;
+  S3Status status;
+  char etag[S3_ETAG_SIZE];
+  void * easy;
+} s3_part_slot_t;
+
+typedef struct s3_mpu{
+  char upload_id[S3_MPU_ID_SIZE];
+  S3RequestContext * ctx;
+  s3_part_slot_t * slots;
+  int slot_count;
+  int busy;
+  s3_part_t * parts;        /* completed parts */
+  int part_count;
+  int part_capacity;
+  int failed;
+  double latency_sum;
+  double latency_min;
+  double latency_max;
+} s3_mpu_t;
+
+/*
+ * Ranged reads: a read is split into GETs of range-size bytes with up to parallel-ranges of them
+ * in flight in one request context. With read-ahead, the object is read in windows of
+ * parallel-ranges * range-size bytes into two buffers; while one window is consumed, the next
+ * one is fetched.
+ */
+typedef struct{
+  struct data_handling dh; // do not reorder, the data callbacks use it
+  struct s3_reader * reader;
+  int * counter;            /* outstanding requests of the owner */
+  int busy;
+  double start;
+  double first;             /* time of the first byte */
+  void * easy;
+} s3_range_slot_t;
+
+typedef struct{
+  char * buf;
+  IOR_offset_t start;       /* -1 if unused */
+  IOR_offset_t len;
+  int busy;
+} s3_window_t;
+
+typedef struct s3_reader{
+  S3RequestContext * ctx;
+  s3_range_slot_t * slots;
+  int slot_count;
+  int busy;                 /* outstanding requests of direct reads */
+  s3_window_t window[2];
+  int failed;
+  long long requests;
+  double latency_sum;
+  double latency_min;
+  double latency_max;
+  double ttfb_sum;
+  double ttfb_min;
+  double ttfb_max;
+} s3_reader_t;
+
 typedef struct{
   char * object;
+  s3_mpu_t * mpu;
+  s3_reader_t * reader;
+  IOR_offset_t size;        /* object size, -1 if unknown */
 } S3_fd_t;
 
+static S3Status partResponsePropertiesCallback(const S3ResponseProperties *properties, void *callbackData){
+  s3_part_slot_t * s = (s3_part_slot_t *) callbackData;
+  snprintf(s->etag, S3_ETAG_SIZE, "%s", properties->eTag ? properties->eTag : "");
+  return S3StatusOK;
+}
+
+static void partResponseCompleteCallback(S3Status status, const S3ErrorDetails *error, void *callbackData) {
+  s3_part_slot_t * s = (s3_part_slot_t *) callbackData;
+  s3_mpu_t * mpu = s->mpu;
+  double latency = GetTimeStamp() - s->start;
+
+  s3_http_record(s->easy);
+  s->busy = 0;
+  mpu->busy--;
+  if(status != S3StatusOK){
+    WARNF("S3 part %d: %s %s", s->number, S3_get_status_name(status), error && error->message ? error->message : "");
+    mpu->failed++;
+    return;
+  }
+  if(mpu->part_count == mpu->part_capacity){
+    mpu->part_capacity = mpu->part_capacity ? 2 * mpu->part_capacity : 64;
+    mpu->parts = realloc(mpu->parts, sizeof(s3_part_t) * mpu->part_capacity);
+    if(mpu->parts == NULL){
+      ERR("Could not allocate memory for the S3 parts");
+    }
+  }
+  mpu->parts[mpu->part_count].number = s->number;
+  memcpy(mpu->parts[mpu->part_count].etag, s->etag, S3_ETAG_SIZE);
+  mpu->part_count++;
+  mpu->latency_sum += latency;
+  if(latency < mpu->latency_min) mpu->latency_min = latency;
+  if(latency > mpu->latency_max) mpu->latency_max = latency;
+}
+
 static int putObjectDataCallback(int bufferSize, char *buffer, void *callbackData){
   struct data_handling * dh = (struct data_handling *) callbackData;
   const int64_t size = dh->size > bufferSize ? bufferSize : dh->size;
@@ -224,6 +492,180 @@ static int putObjectDataCallback(int bufferSize, char *buffer, void *callbackDat
 }
 
 static S3PutObjectHandler putObjectHandler = { {  &responsePropertiesCallback, &responseCompleteCallback }, & putObjectDataCallback };
+static S3PutObjectHandler partPutObjectHandler = { {  &partResponsePropertiesCallback, &partResponseCompleteCallback }, & putObjectDataCallback };
+
+static S3Status commitResponseCallback(const char *location, const char *etag, void *callbackData){
+  return S3StatusOK;
+}
+
+static S3AbortMultipartUploadHandler abort_handler = { {  &responsePropertiesCallback, &responseCompleteCallback } };
+static S3MultipartCommitHandler commit_handler = { {  &responsePropertiesCallback, &responseCompleteCallback }, & putObjectDataCallback, & commitResponseCallback };
+
+/* drive the request context until fewer than limit requests counted by busy are outstanding */
+static void s3_ctx_wait(S3RequestContext * ctx, int * busy, int limit){
+  while(*busy >= limit){
+    int remaining = 0;
+    S3Status ret = S3_runonce_request_context(ctx, & remaining);
+    if(ret != S3StatusOK){
+      FAIL("S3 request context: %s", S3_get_status_name(ret));
+    }
+    if(*busy < limit){
+      break;
+    }
+    /* wait for socket activity */
+    fd_set rfds, wfds, efds;
+    int max_fd = -1;
+    FD_ZERO(& rfds);
+    FD_ZERO(& wfds);
+    FD_ZERO(& efds);
+    if(S3_get_request_context_fdsets(ctx, & rfds, & wfds, & efds, & max_fd) != S3StatusOK || max_fd < 0){
+      continue;
+    }
+    int64_t timeout = S3_get_request_context_timeout(ctx);
+    if(timeout < 0 || timeout > 100){
+      timeout = 100;
+    }
+    struct timeval tv = { .tv_sec = 0, .tv_usec = timeout * 1000 };
+    select(max_fd + 1, & rfds, & wfds, & efds, & tv);
+  }
+}
+
+/* wait until a slot is free or, with all set, until all parts are done */
+static void s3_mpu_progress(s3_mpu_t * mpu, int all){
+  s3_ctx_wait(mpu->ctx, & mpu->busy, all ? 1 : mpu->slot_count);
+}
+
+static s3_mpu_t * s3_mpu_start(s3_options_t * o, const char * key){
+  s3_mpu_t * mpu = safeMalloc(sizeof(s3_mpu_t));
+  memset(mpu, 0, sizeof(s3_mpu_t));
+  if(hints->filePerProc || rank == 0){
+    S3_initiate_multipart(& o->bucket_context, key, NULL, & multipart_handler, NULL, o->timeout, mpu->upload_id);
+    if(s3status != S3StatusOK){
+      CHECK_ERROR(key);
+      ERR("Could not initiate the S3 multipart upload");
+    }
+  }
+  if(! hints->filePerProc){
+    MPI_CHECK(MPI_Bcast(mpu->upload_id, S3_MPU_ID_SIZE, MPI_CHAR, 0, testComm), "cannot broadcast the upload id");
+  }
+  s3_create_context(& mpu->ctx);
+  mpu->slot_count = o->parallel_parts;
+  mpu->slots = safeMalloc(sizeof(s3_part_slot_t) * mpu->slot_count);
+  for(int i=0; i < mpu->slot_count; i++){
+    memset(& mpu->slots[i], 0, sizeof(s3_part_slot_t));
+    mpu->slots[i].mpu = mpu;
+    mpu->slots[i].buf = safeMalloc(hints->transferSize);
+  }
+  mpu->latency_min = 1e300;
+  return mpu;
+}
+
+static void s3_mpu_put_part(s3_options_t * o, S3_fd_t * fd, IOR_size_t * buffer, IOR_offset_t length, IOR_offset_t offset){
+  s3_mpu_t * mpu = fd->mpu;
+  s3_part_slot_t * s = NULL;
+
+  s3_mpu_progress(mpu, 0);
+  for(int i=0; i < mpu->slot_count; i++){
+    if(! mpu->slots[i].busy){
+      s = & mpu->slots[i];
+      break;
+    }
+  }
+  memcpy(s->buf, buffer, length);
+  s->dh.buf = (IOR_size_t*) s->buf;
+  s->dh.size = length;
+  s->number = offset / hints->transferSize + 1;
+  s->status = S3StatusInterrupted;
+  s->etag[0] = '\0';
+  s->start = GetTimeStamp();
+  s->busy = 1;
+  mpu->busy++;
+  s->easy = NULL;
+  s3_setup_target = & s->easy;
+  S3_upload_part(& o->bucket_context, fd->object, NULL, & partPutObjectHandler, s->number, mpu->upload_id, length, mpu->ctx, o->timeout, s);
+  s3_setup_target = NULL;
+  /* start the transfer */
+  int remaining;
+  S3_runonce_request_context(mpu->ctx, & remaining);
+}
+
+static int s3_part_cmp(const void * a, const void * b){
+  return ((s3_part_t*) a)->number - ((s3_part_t*) b)->number;
+}
+
+/* wait for all parts and complete the upload, for a shared file the ETags are gathered on rank 0 */
+static void s3_mpu_finish(s3_options_t * o, S3_fd_t * fd){
+  s3_mpu_t * mpu = fd->mpu;
+  s3_part_t * parts = mpu->parts;
+  int count = mpu->part_count;
+  int failed = mpu->failed;
+
+  s3_mpu_progress(mpu, 1);
+  if(! hints->filePerProc){
+    int * counts = NULL;
+    int * displs = NULL;
+    int total = 0;
+    MPI_CHECK(MPI_Allreduce(& mpu->failed, & failed, 1, MPI_INT, MPI_SUM, testComm), "cannot reduce failed parts");
+    if(rank == 0){
+      counts = safeMalloc(sizeof(int) * hints->numTasks);
+      displs = safeMalloc(sizeof(int) * hints->numTasks);
+    }
+    int bytes = mpu->part_count * sizeof(s3_part_t);
+    MPI_CHECK(MPI_Gather(& bytes, 1, MPI_INT, counts, 1, MPI_INT, 0, testComm), "cannot gather part counts");
+    if(rank == 0){
+      for(int i=0; i < hints->numTasks; i++){
+        displs[i] = total;
+        total += counts[i];
+      }
+      parts = safeMalloc(total > 0 ? total : 1);
+      count = total / sizeof(s3_part_t);
+    }
+    MPI_CHECK(MPI_Gatherv(mpu->parts, bytes, MPI_BYTE, parts, counts, displs, MPI_BYTE, 0, testComm), "cannot gather parts");
+    free(counts);
+    free(displs);
+  }
+
+  if(hints->filePerProc || rank == 0){
+    if(failed){
+      WARNF("S3 multipart upload of %s: %d parts failed, aborting the upload", fd->object, failed);
+      S3_abort_multipart_upload(& o->bucket_context, fd->object, mpu->upload_id, o->timeout, & abort_handler);
+    }else{
+      qsort(parts, count, sizeof(s3_part_t), s3_part_cmp);
+      size_t xml_size = 64 + (size_t) count * (S3_ETAG_SIZE + 64);
+      char * xml = safeMalloc(xml_size);
+      char * pos = xml;
+      pos += sprintf(pos, "<CompleteMultipartUpload>");
+      for(int i=0; i < count; i++){
+        pos += sprintf(pos, "<Part><PartNumber>%d</PartNumber><ETag>%s</ETag></Part>", parts[i].number, parts[i].etag);
+      }
+      pos += sprintf(pos, "</CompleteMultipartUpload>");
+      struct data_handling dh = { .buf = (IOR_size_t*) xml, .size = pos - xml };
+      S3_complete_multipart_upload(& o->bucket_context, fd->object, & commit_handler, mpu->upload_id, pos - xml, NULL, o->timeout, & dh);
+      CHECK_ERROR(fd->object);
+      free(xml);
+    }
+    if(rank == 0 && mpu->part_count > 0){
+      fprintf(out_logfile, "S3 multipart: %d parts, latency min %.2f ms avg %.2f ms max %.2f ms on rank 0\n",
+        mpu->part_count, mpu->latency_min * 1e3, mpu->latency_sum / mpu->part_count * 1e3, mpu->latency_max * 1e3);
+    }
+  }
+  if(! hints->filePerProc){
+    if(rank == 0){
+      free(parts);
+    }
+    /* the object exists once rank 0 completed the upload */
+    MPI_CHECK(MPI_Barrier(testComm), "barrier error");
+  }
+
+  S3_destroy_request_context(mpu->ctx);
+  for(int i=0; i < mpu->slot_count; i++){
+    free(mpu->slots[i].buf);
+  }
+  free(mpu->slots);
+  free(mpu->parts);
+  free(mpu);
+  fd->mpu = NULL;
+}
 
 static aiori_fd_t *S3_Create(char *path, int iorflags, aiori_mod_opt_t * options)
 {
@@ -238,7 +680,8 @@ static aiori_fd_t *S3_Create(char *path, int iorflags, aiori_mod_opt_t * options
       S3_create_bucket(o->s3_protocol, o->access_key, o->secret_key, NULL, o->host, p, o->authRegion, S3CannedAclPrivate, o->locationConstraint, NULL, o->timeout, & responseHandler, NULL);
     }else{
       struct data_handling dh = { .buf = NULL, .size = 0 };
-      S3_put_object(& o->bucket_context, p, 0, NULL, NULL, o->timeout, &putObjectHandler, & dh);
+      S3_put_object(& o->bucket_context, p, 0, NULL, s3_sync_ctx, o->timeout, &putObjectHandler, & dh);
+      s3_sync_run();
     }
     if (s3status != S3StatusOK){
       CHECK_ERROR(p);
@@ -248,6 +691,12 @@ static aiori_fd_t *S3_Create(char *path, int iorflags, aiori_mod_opt_t * options
 
   S3_fd_t * fd = malloc(sizeof(S3_fd_t));
   fd->object = strdup(p);
+  fd->mpu = NULL;
+  fd->reader = NULL;
+  fd->size = -1;
+  if(o->multipart && hints && (iorflags & IOR_CREAT)){
+    fd->mpu = s3_mpu_start(o, p);
+  }
   return (aiori_fd_t*) fd;
 }
 
@@ -279,6 +728,7 @@ static aiori_fd_t *S3_Open(char *path, int flags, aiori_mod_opt_t * options)
 
   s3_options_t * o = (s3_options_t*) options;
   char p[FILENAME_MAX];
+  struct stat buf;
   def_file_name(o, p, path);
 
   if (o->bucket_per_file){
@@ -286,8 +736,8 @@ static aiori_fd_t *S3_Open(char *path, int flags, aiori_mod_opt_t * options)
                         NULL, o->host, p, o->authRegion, 0, NULL,
                         NULL, o->timeout, & responseHandler, NULL);
   }else{
-    struct stat buf;
-    S3_head_object(& o->bucket_context, p, NULL, o->timeout, & statResponseHandler, & buf);
+    S3_head_object(& o->bucket_context, p, s3_sync_ctx, o->timeout, & statResponseHandler, & buf);
+    s3_sync_run();
   }
   if (s3status != S3StatusOK){
     CHECK_ERROR(p);
@@ -296,6 +746,9 @@ static aiori_fd_t *S3_Open(char *path, int flags, aiori_mod_opt_t * options)
 
   S3_fd_t * fd = malloc(sizeof(S3_fd_t));
   fd->object = strdup(p);
+  fd->mpu = NULL;
+  fd->reader = NULL;
+  fd->size = o->bucket_per_file ? -1 : buf.st_size;
   return (aiori_fd_t*) fd;
 }
 
@@ -311,6 +764,173 @@ static S3Status getObjectDataCallback(int bufferSize, const char *buffer,  void
 
 static S3GetObjectHandler getObjectHandler = { {  &responsePropertiesCallback, &responseCompleteCallback }, & getObjectDataCallback };
 
+static S3Status rangeResponsePropertiesCallback(const S3ResponseProperties *properties, void *callbackData){
+  return S3StatusOK;
+}
+
+static S3Status rangeGetObjectDataCallback(int bufferSize, const char *buffer,  void *callbackData){
+  s3_range_slot_t * s = (s3_range_slot_t *) callbackData;
+  if(s->first == 0){
+    s->first = GetTimeStamp();
+  }
+  return getObjectDataCallback(bufferSize, buffer, callbackData);
+}
+
+static void rangeResponseCompleteCallback(S3Status status, const S3ErrorDetails *error, void *callbackData) {
+  s3_range_slot_t * s = (s3_range_slot_t *) callbackData;
+  s3_reader_t * r = s->reader;
+  double now = GetTimeStamp();
+
+  s3_http_record(s->easy);
+  s->busy = 0;
+  (*s->counter)--;
+  if(status != S3StatusOK || s->dh.size != 0){
+    WARNF("S3 range request: %s %s", S3_get_status_name(status), error && error->message ? error->message : "");
+    r->failed++;
+    return;
+  }
+  double latency = now - s->start;
+  double ttfb = (s->first ? s->first : now) - s->start;
+  r->requests++;
+  r->latency_sum += latency;
+  r->ttfb_sum += ttfb;
+  if(latency < r->latency_min) r->latency_min = latency;
+  if(latency > r->latency_max) r->latency_max = latency;
+  if(ttfb < r->ttfb_min) r->ttfb_min = ttfb;
+  if(ttfb > r->ttfb_max) r->ttfb_max = ttfb;
+}
+
+static S3GetObjectHandler rangeGetObjectHandler = { {  &rangeResponsePropertiesCallback, &rangeResponseCompleteCallback }, & rangeGetObjectDataCallback };
+
+static s3_reader_t * s3_reader_create(s3_options_t * o){
+  s3_reader_t * r = safeMalloc(sizeof(s3_reader_t));
+  memset(r, 0, sizeof(s3_reader_t));
+  s3_create_context(& r->ctx);
+  /* both read-ahead windows may be in flight */
+  r->slot_count = 2 * o->parallel_ranges;
+  r->slots = safeMalloc(sizeof(s3_range_slot_t) * r->slot_count);
+  memset(r->slots, 0, sizeof(s3_range_slot_t) * r->slot_count);
+  for(int i=0; i < 2; i++){
+    r->window[i].start = -1;
+    if(o->read_ahead){
+      r->window[i].buf = safeMalloc(o->parallel_ranges * o->range_size);
+    }
+  }
+  r->latency_min = r->ttfb_min = 1e300;
+  return r;
+}
+
+/* post a GET of [offset, offset + length) of the key into buf, counted by counter */
+static void s3_range_post(s3_options_t * o, s3_reader_t * r, const char * key, char * buf, IOR_offset_t offset, IOR_offset_t length, int * counter){
+  s3_range_slot_t * s = NULL;
+  for(int i=0; i < r->slot_count; i++){
+    if(! r->slots[i].busy){
+      s = & r->slots[i];
+      break;
+    }
+  }
+  if(s == NULL){
+    ERR("No free S3 range request slot");
+  }
+  s->dh.buf = (IOR_size_t*) buf;
+  s->dh.size = length;
+  s->reader = r;
+  s->counter = counter;
+  s->busy = 1;
+  s->first = 0;
+  s->start = GetTimeStamp();
+  (*counter)++;
+  s->easy = NULL;
+  s3_setup_target = & s->easy;
+  S3_get_object(& o->bucket_context, key, NULL, offset, length, r->ctx, o->timeout, & rangeGetObjectHandler, s);
+  s3_setup_target = NULL;
+}
+
+/* read [offset, offset + length) of the key with concurrent ranges directly into buffer */
+static void s3_read_ranges(s3_options_t * o, s3_reader_t * r, const char * key, char * buffer, IOR_offset_t offset, IOR_offset_t length){
+  for(IOR_offset_t pos = 0; pos < length; pos += o->range_size){
+    IOR_offset_t len = length - pos < o->range_size ? length - pos : o->range_size;
+    s3_ctx_wait(r->ctx, & r->busy, o->parallel_ranges);
+    s3_range_post(o, r, key, buffer + pos, offset + pos, len, & r->busy);
+  }
+  s3_ctx_wait(r->ctx, & r->busy, 1);
+}
+
+/* fetch the window starting at start into w without waiting */
+static void s3_window_post(s3_options_t * o, S3_fd_t * fd, s3_window_t * w, IOR_offset_t start){
+  s3_reader_t * r = fd->reader;
+  IOR_offset_t size = (IOR_offset_t) o->parallel_ranges * o->range_size;
+  if(fd->size >= 0 && start + size > fd->size){
+    size = fd->size - start;
+  }
+  w->start = start;
+  w->len = size;
+  for(IOR_offset_t pos = 0; pos < size; pos += o->range_size){
+    IOR_offset_t len = size - pos < o->range_size ? size - pos : o->range_size;
+    s3_range_post(o, r, fd->object, w->buf + pos, start + pos, len, & w->busy);
+  }
+}
+
+/* read through the read-ahead windows */
+static void s3_read_ahead(s3_options_t * o, S3_fd_t * fd, char * buffer, IOR_offset_t offset, IOR_offset_t length){
+  s3_reader_t * r = fd->reader;
+  const IOR_offset_t wsize = (IOR_offset_t) o->parallel_ranges * o->range_size;
+
+  while(length > 0){
+    IOR_offset_t start = offset / wsize * wsize;
+    s3_window_t * w = NULL;
+    s3_window_t * other;
+    for(int i=0; i < 2; i++){
+      if(r->window[i].start == start){
+        w = & r->window[i];
+      }
+    }
+    if(w == NULL){
+      /* a miss, replace the window that does not hold the next data */
+      w = r->window[0].start == start + wsize ? & r->window[1] : & r->window[0];
+      s3_ctx_wait(r->ctx, & w->busy, 1);
+      s3_window_post(o, fd, w, start);
+    }
+    other = w == & r->window[0] ? & r->window[1] : & r->window[0];
+    /* prefetch the next window */
+    if(other->start != start + wsize && (fd->size < 0 || start + wsize < fd->size)){
+      s3_ctx_wait(r->ctx, & other->busy, 1);
+      s3_window_post(o, fd, other, start + wsize);
+    }
+    s3_ctx_wait(r->ctx, & w->busy, 1);
+    if(r->failed){
+      ERRF("S3 ranged read of %s failed", fd->object);
+    }
+    IOR_offset_t pos = offset - w->start;
+    IOR_offset_t len = w->len - pos < length ? w->len - pos : length;
+    if(len <= 0){
+      ERRF("S3 read beyond the end of %s", fd->object);
+    }
+    memcpy(buffer, w->buf + pos, len);
+    buffer += len;
+    offset += len;
+    length -= len;
+  }
+}
+
+static void s3_reader_destroy(S3_fd_t * fd){
+  s3_reader_t * r = fd->reader;
+  /* drain outstanding read-ahead */
+  for(int i=0; i < 2; i++){
+    s3_ctx_wait(r->ctx, & r->window[i].busy, 1);
+    free(r->window[i].buf);
+  }
+  if(rank == 0 && r->requests > 0){
+    fprintf(out_logfile, "S3 ranged reads: %lld requests, TTFB min %.2f ms avg %.2f ms max %.2f ms, latency min %.2f ms avg %.2f ms max %.2f ms on rank 0\n",
+      r->requests, r->ttfb_min * 1e3, r->ttfb_sum / r->requests * 1e3, r->ttfb_max * 1e3,
+      r->latency_min * 1e3, r->latency_sum / r->requests * 1e3, r->latency_max * 1e3);
+  }
+  S3_destroy_request_context(r->ctx);
+  free(r->slots);
+  free(r);
+  fd->reader = NULL;
+}
+
 static IOR_offset_t S3_Xfer(int access, aiori_fd_t * afd, IOR_size_t * buffer, IOR_offset_t length, IOR_offset_t offset, aiori_mod_opt_t * options){
   S3_fd_t * fd = (S3_fd_t *) afd;
   struct data_handling dh = { .buf = buffer, .size = length };
@@ -318,6 +938,32 @@ static IOR_offset_t S3_Xfer(int access, aiori_fd_t * afd, IOR_size_t * buffer, I
   s3_options_t * o = (s3_options_t*) options;
   char p[FILENAME_MAX];
 
+  if(o->multipart && ! o->bucket_per_file){
+    if(access == WRITE){
+      if(fd->mpu == NULL){
+        ERR("S3 multipart writes require the file to be created");
+      }
+      s3_mpu_put_part(o, fd, buffer, length, offset);
+    }else if(o->range_size > 0){
+      if(fd->reader == NULL){
+        fd->reader = s3_reader_create(o);
+      }
+      if(o->read_ahead){
+        s3_read_ahead(o, fd, (char*) buffer, offset, length);
+      }else{
+        s3_read_ranges(o, fd->reader, fd->object, (char*) buffer, offset, length);
+      }
+      if(fd->reader->failed){
+        ERRF("S3 ranged read of %s failed", fd->object);
+      }
+    }else{
+      S3_get_object(& o->bucket_context, fd->object, NULL, offset, length, s3_sync_ctx, o->timeout, &getObjectHandler, & dh);
+      s3_sync_run();
+      CHECK_ERROR(fd->object);
+    }
+    return length;
+  }
+
   if(o->bucket_per_file){
     o->bucket_context.bucketName = fd->object;
     if(offset != 0){
@@ -333,9 +979,21 @@ static IOR_offset_t S3_Xfer(int access, aiori_fd_t * afd, IOR_size_t * buffer, I
     }
   }
   if(access == WRITE){
-    S3_put_object(& o->bucket_context, p, length, NULL, NULL, o->timeout, &putObjectHandler, & dh);
+    S3_put_object(& o->bucket_context, p, length, NULL, s3_sync_ctx, o->timeout, &putObjectHandler, & dh);
+    s3_sync_run();
+  }else if(o->range_size > 0){
+    /* the transfer is its own object */
+    if(fd->reader == NULL){
+      fd->reader = s3_reader_create(o);
+    }
+    s3_read_ranges(o, fd->reader, p, (char*) buffer, 0, length);
+    if(fd->reader->failed){
+      ERRF("S3 ranged read of %s failed", p);
+    }
+    return length;
   }else{
-    S3_get_object(& o->bucket_context, p, NULL, 0, length, NULL, o->timeout, &getObjectHandler, & dh);
+    S3_get_object(& o->bucket_context, p, NULL, 0, length, s3_sync_ctx, o->timeout, &getObjectHandler, & dh);
+    s3_sync_run();
   }
   if (! o->s3_compatible){
     CHECK_ERROR(p);
@@ -347,6 +1005,16 @@ static IOR_offset_t S3_Xfer(int access, aiori_fd_t * afd, IOR_size_t * buffer, I
 static void S3_Close(aiori_fd_t * afd, aiori_mod_opt_t * options)
 {
   S3_fd_t * fd = (S3_fd_t *) afd;
+  if(fd->mpu != NULL){
+    s3_mpu_finish((s3_options_t*) options, fd);
+  }
+  if(fd->reader != NULL){
+    s3_reader_destroy(fd);
+  }
+  /* a file with several transfers per rank is an IOR phase, which all ranks close */
+  if(http_timing && hints && hints->blockSize * hints->segmentCount > hints->transferSize){
+    s3_http_report(fd->object);
+  }
   free(fd->object);
   free(afd);
 }
@@ -390,7 +1058,8 @@ static void S3_Delete(char *path, aiori_mod_opt_t * options)
     char * del_heuristics = getenv("S3LIB_DELETE_HEURISTICS");
     if(del_heuristics){
       struct stat buf;
-      S3_head_object(& o->bucket_context, p, NULL, o->timeout, & statResponseHandler, & buf);
+      S3_head_object(& o->bucket_context, p, s3_sync_ctx, o->timeout, & statResponseHandler, & buf);
+      s3_sync_run();
       if(s3status != S3StatusOK){
         // As the file does not exist, can return safely
         CHECK_ERROR(p);
@@ -404,10 +1073,12 @@ static void S3_Delete(char *path, aiori_mod_opt_t * options)
           S3_list_bucket(& o->bucket_context, p, req.nextMarker, NULL, INT_MAX, NULL, o->timeout, & list_delete_handler, & req);
         }while(req.truncated);
       }
-      S3_delete_object(& o->bucket_context, p, NULL, o->timeout, & responseHandler, NULL);
+      S3_delete_object(& o->bucket_context, p, s3_sync_ctx, o->timeout, & responseHandler, NULL);
+      s3_sync_run();
     }else{    
       // Regular deletion, must remove all created fragments
-      S3_delete_object(& o->bucket_context, p, NULL, o->timeout, & responseHandler, NULL);
+      S3_delete_object(& o->bucket_context, p, s3_sync_ctx, o->timeout, & responseHandler, NULL);
+      s3_sync_run();
       if(s3status != S3StatusOK){
         // As the file does not exist, can return savely
         CHECK_ERROR(p);
@@ -422,6 +1093,165 @@ static void S3_Delete(char *path, aiori_mod_opt_t * options)
   CHECK_ERROR(p);
 }
 
+/*
+ * Batch operations issue all requests of a batch into one libs3 request context
+ * so they are processed concurrently, each element keeps its own status.
+ * With bucket-per-file, each element is processed individually.
+ */
+typedef struct{
+  struct data_handling dh; // do not reorder, the data callbacks use it
+  S3Status status;
+  char key[FILENAME_MAX];
+  struct stat * st;
+  void * easy;
+} s3_batch_elem_t;
+
+/* the limit of keys of a multi-object delete, also bounds the requests of one context */
+#define S3_BATCH_MAX_KEYS 1000
+
+static S3Status batchResponsePropertiesCallback(const S3ResponseProperties *properties, void *callbackData){
+  s3_batch_elem_t * e = (s3_batch_elem_t *) callbackData;
+  if(e->st != NULL){
+    e->st->st_size = properties->contentLength;
+    e->st->st_mtime = properties->lastModified;
+  }
+  return S3StatusOK;
+}
+
+static void batchResponseCompleteCallback(S3Status status, const S3ErrorDetails *error, void *callbackData) {
+  s3_batch_elem_t * e = (s3_batch_elem_t *) callbackData;
+  s3_http_record(e->easy);
+  e->status = status;
+}
+
+/* a get that succeeded with fewer bytes than requested is a short read */
+static void batchGetCompleteCallback(S3Status status, const S3ErrorDetails *error, void *callbackData) {
+  s3_batch_elem_t * e = (s3_batch_elem_t *) callbackData;
+  batchResponseCompleteCallback(status, error, callbackData);
+  if(status == S3StatusOK && e->dh.size != 0){
+    WARNF("S3 batch get (key:%s): short read, %lld bytes missing", e->key, (long long) e->dh.size);
+    e->status = S3StatusErrorIncompleteBody;
+  }
+}
+
+static S3PutObjectHandler batchPutObjectHandler = { {  &batchResponsePropertiesCallback, &batchResponseCompleteCallback }, & putObjectDataCallback };
+static S3GetObjectHandler batchGetObjectHandler = { {  &batchResponsePropertiesCallback, &batchGetCompleteCallback }, & getObjectDataCallback };
+static S3ResponseHandler batchResponseHandler = {  &batchResponsePropertiesCallback, &batchResponseCompleteCallback };
+
+static int S3_batch_finish(S3RequestContext * ctx, int count, char ** names, s3_batch_elem_t * elems, int * status){
+  S3Status ret = S3_runall_request_context(ctx);
+  S3_destroy_request_context(ctx);
+  if(ret != S3StatusOK){
+    WARNF("S3 batch of %d requests: %s", count, S3_get_status_name(ret));
+  }
+  int success = 0;
+  for(int i=0; i < count; i++){
+    if(elems[i].status == S3StatusOK){
+      status[i] = 0;
+      success++;
+    }else{
+      status[i] = -1;
+      if(verbose > 2){
+        WARNF("S3 batch element (path:%s): %s", names[i], S3_get_status_name(elems[i].status));
+      }
+    }
+  }
+  free(elems);
+  return success;
+}
+
+static int S3_batch_xfer(int access, int count, char ** names, IOR_size_t ** buffers, IOR_offset_t * sizes, int * status, aiori_mod_opt_t * options){
+  s3_options_t * o = (s3_options_t*) options;
+  if(o->bucket_per_file){
+    int success = 0;
+    for(int i=0; i < count; i++){
+      aiori_fd_t * fd;
+      status[i] = -1;
+      if(access == WRITE){
+        fd = S3_Create(names[i], IOR_WRONLY | IOR_CREAT, options);
+      }else{
+        fd = S3_Open(names[i], IOR_RDONLY, options);
+      }
+      if(fd == NULL) continue;
+      S3_Xfer(access, fd, buffers[i], sizes[i], 0, options);
+      if(s3status == S3StatusOK){
+        status[i] = 0;
+        success++;
+      }
+      S3_Close(fd, options);
+    }
+    return success;
+  }
+
+  S3RequestContext * ctx;
+  s3_create_context(& ctx);
+  s3_batch_elem_t * elems = safeMalloc(sizeof(s3_batch_elem_t) * count);
+  for(int i=0; i < count; i++){
+    char * p = elems[i].key;
+    def_file_name(o, p, names[i]);
+    elems[i].dh.buf = buffers[i];
+    elems[i].dh.size = sizes[i];
+    elems[i].status = S3StatusInterrupted;
+    elems[i].st = NULL;
+    elems[i].easy = NULL;
+    s3_setup_target = & elems[i].easy;
+    if(access == WRITE){
+      S3_put_object(& o->bucket_context, p, sizes[i], NULL, ctx, o->timeout, & batchPutObjectHandler, & elems[i]);
+    }else{
+      S3_get_object(& o->bucket_context, p, NULL, 0, sizes[i], ctx, o->timeout, & batchGetObjectHandler, & elems[i]);
+    }
+    s3_setup_target = NULL;
+  }
+  return S3_batch_finish(ctx, count, names, elems, status);
+}
+
+static int S3_put_batch(int count, char ** names, IOR_size_t ** buffers, IOR_offset_t * sizes, int * status, aiori_mod_opt_t * options){
+  return S3_batch_xfer(WRITE, count, names, buffers, sizes, status, options);
+}
+
+static int S3_get_batch(int count, char ** names, IOR_size_t ** buffers, IOR_offset_t * sizes, int * status, aiori_mod_opt_t * options){
+  return S3_batch_xfer(READ, count, names, buffers, sizes, status, options);
+}
+
+/*
+ * Removes only the object itself; fragments are never created by the batch put.
+ * libs3 lacks the multi-object delete, hence the DELETE requests of up to
+ * S3_BATCH_MAX_KEYS objects are issued concurrently with one request context.
+ */
+static int S3_remove_batch(int count, char ** names, int * status, aiori_mod_opt_t * options){
+  s3_options_t * o = (s3_options_t*) options;
+  int success = 0;
+  if(o->bucket_per_file){
+    for(int i=0; i < count; i++){
+      S3_Delete(names[i], options);
+      status[i] = s3status == S3StatusOK ? 0 : -1;
+      if(status[i] == 0){
+        success++;
+      }
+    }
+    return success;
+  }
+
+  for(int first=0; first < count; first += S3_BATCH_MAX_KEYS){
+    int n = count - first < S3_BATCH_MAX_KEYS ? count - first : S3_BATCH_MAX_KEYS;
+    S3RequestContext * ctx;
+    s3_create_context(& ctx);
+    s3_batch_elem_t * elems = safeMalloc(sizeof(s3_batch_elem_t) * n);
+    for(int i=0; i < n; i++){
+      char * p = elems[i].key;
+      def_file_name(o, p, names[first + i]);
+      elems[i].status = S3StatusInterrupted;
+      elems[i].st = NULL;
+      elems[i].easy = NULL;
+      s3_setup_target = & elems[i].easy;
+      S3_delete_object(& o->bucket_context, p, ctx, o->timeout, & batchResponseHandler, & elems[i]);
+      s3_setup_target = NULL;
+    }
+    success += S3_batch_finish(ctx, n, names + first, elems, status + first);
+  }
+  return success;
+}
+
 static int S3_mkdir (const char *path, mode_t mode, aiori_mod_opt_t * options){
   s3_options_t * o = (s3_options_t*) options;
   char p[FILENAME_MAX];
@@ -434,7 +1264,8 @@ static int S3_mkdir (const char *path, mode_t mode, aiori_mod_opt_t * options){
     return 0;
   }else{
     struct data_handling dh = { .buf = NULL, .size = 0 };
-    S3_put_object(& o->bucket_context, p, 0, NULL, NULL, o->timeout, & putObjectHandler, & dh);
+    S3_put_object(& o->bucket_context, p, 0, NULL, s3_sync_ctx, o->timeout, & putObjectHandler, & dh);
+    s3_sync_run();
     if (! o->s3_compatible){
       CHECK_ERROR(p);
     }
@@ -452,7 +1283,8 @@ static int S3_rmdir (const char *path, aiori_mod_opt_t * options){
     CHECK_ERROR(p);
     return 0;
   }else{
-    S3_delete_object(& o->bucket_context, p, NULL, o->timeout, & responseHandler, NULL);
+    S3_delete_object(& o->bucket_context, p, s3_sync_ctx, o->timeout, & responseHandler, NULL);
+    s3_sync_run();
     CHECK_ERROR(p);
     return 0;
   }
@@ -469,7 +1301,8 @@ static int S3_stat(const char *path, struct stat *buf, aiori_mod_opt_t * options
                         NULL, o->host, p, o->authRegion, 0, NULL,
                         NULL, o->timeout, & responseHandler, NULL);
   }else{
-    S3_head_object(& o->bucket_context, p, NULL, o->timeout, & statResponseHandler, buf);
+    S3_head_object(& o->bucket_context, p, s3_sync_ctx, o->timeout, & statResponseHandler, buf);
+    s3_sync_run();
   }
   if (s3status != S3StatusOK){
     return -1;
@@ -490,6 +1323,149 @@ static IOR_offset_t S3_GetFileSize(aiori_mod_opt_t * options, char *testFileName
 }
 
 
+/*
+ * Stat by listing: the bucket is listed with the common prefix of the keys of the
+ * batch, starting just before the smallest key until the largest key is passed
+ * or all keys are found. Every listed key is looked up in the sorted keys.
+ */
+typedef struct{
+  s3_batch_elem_t * elems; /* sorted by key */
+  int count;
+  int found;
+  int truncated;
+  int done;
+  char marker[FILENAME_MAX];
+} s3_list_stat_req;
+
+static int s3_elem_key_cmp(const void * a, const void * b){
+  return strcmp(((const s3_batch_elem_t *) a)->key, ((const s3_batch_elem_t *) b)->key);
+}
+
+static int s3_key_elem_cmp(const void * key, const void * elem){
+  return strcmp((const char *) key, ((const s3_batch_elem_t *) elem)->key);
+}
+
+static S3Status list_stat_cb(int isTruncated, const char *nextMarker, int contentsCount, const S3ListBucketContent *contents, int commonPrefixesCount, const char **commonPrefixes, void *callbackData){
+  s3_list_stat_req * req = (s3_list_stat_req*) callbackData;
+  for(int i=0; i < contentsCount; i++){
+    s3_batch_elem_t * e = bsearch(contents[i].key, req->elems, req->count, sizeof(s3_batch_elem_t), s3_key_elem_cmp);
+    if(e == NULL || e->status == S3StatusOK){
+      continue;
+    }
+    e->st->st_size = contents[i].size;
+    e->st->st_mtime = contents[i].lastModified;
+    e->status = S3StatusOK;
+    req->found++;
+  }
+  req->truncated = isTruncated;
+  if(contentsCount > 0){
+    /* without a delimiter, S3 may omit the next marker: continue after the last key */
+    const char * last = nextMarker != NULL ? nextMarker : contents[contentsCount - 1].key;
+    snprintf(req->marker, FILENAME_MAX, "%s", last);
+    if(strcmp(last, req->elems[req->count - 1].key) >= 0){
+      req->done = 1;
+    }
+  }else{
+    req->truncated = 0;
+  }
+  if(req->found == req->count){
+    req->done = 1;
+  }
+  return S3StatusOK;
+}
+
+static S3ListBucketHandler list_stat_handler = {{&responsePropertiesCallback, &responseCompleteCallback }, list_stat_cb};
+
+static int S3_list_stat(s3_options_t * o, int count, char ** names, struct stat * bufs, int * status){
+  s3_batch_elem_t * elems = safeMalloc(sizeof(s3_batch_elem_t) * count);
+  for(int i=0; i < count; i++){
+    def_file_name(o, elems[i].key, names[i]);
+    elems[i].status = S3StatusInterrupted;
+    elems[i].st = & bufs[i];
+    memset(& bufs[i], 0, sizeof(struct stat));
+  }
+  qsort(elems, count, sizeof(s3_batch_elem_t), s3_elem_key_cmp);
+
+  char prefix[FILENAME_MAX];
+  size_t len = strlen(elems[0].key);
+  for(int i=1; i < count; i++){
+    size_t l = 0;
+    while(l < len && elems[0].key[l] == elems[i].key[l]){
+      l++;
+    }
+    len = l;
+  }
+  memcpy(prefix, elems[0].key, len);
+  prefix[len] = '\0';
+
+  s3_list_stat_req req = {elems, count, 0, 0, 0, ""};
+  /* the marker is exclusive, the smallest key without its last character sorts just before it */
+  len = strlen(elems[0].key);
+  memcpy(req.marker, elems[0].key, len - 1);
+  req.marker[len - 1] = '\0';
+  do{
+    S3_list_bucket(& o->bucket_context, prefix, req.marker, NULL, S3_BATCH_MAX_KEYS, s3_sync_ctx, o->timeout, & list_stat_handler, & req);
+    s3_sync_run();
+    if(s3status != S3StatusOK){
+      WARNF("S3 listing of prefix %s: %s", prefix, S3_get_status_name(s3status));
+      break;
+    }
+  }while(req.truncated && ! req.done);
+
+  /* map the sorted elements back to the order of the names */
+  int success = 0;
+  for(int i=0; i < count; i++){
+    int pos = elems[i].st - bufs;
+    status[pos] = elems[i].status == S3StatusOK ? 0 : -1;
+    if(status[pos] == 0){
+      success++;
+    }else if(verbose > 2){
+      WARNF("S3 listing does not contain (path:%s)", names[pos]);
+    }
+  }
+  free(elems);
+  return success;
+}
+
+static int S3_stat_batch(int count, char ** names, struct stat * bufs, int * status, aiori_mod_opt_t * options){
+  s3_options_t * o = (s3_options_t*) options;
+  if(o->bucket_per_file){
+    int success = 0;
+    for(int i=0; i < count; i++){
+      status[i] = S3_stat(names[i], & bufs[i], options);
+      success += status[i] == 0;
+    }
+    return success;
+  }
+  if(count == 0){
+    return 0;
+  }
+  if(o->list_stat){
+    return S3_list_stat(o, count, names, bufs, status);
+  }
+
+  int success = 0;
+  for(int first=0; first < count; first += S3_BATCH_MAX_KEYS){
+    int n = count - first < S3_BATCH_MAX_KEYS ? count - first : S3_BATCH_MAX_KEYS;
+    S3RequestContext * ctx;
+    s3_create_context(& ctx);
+    s3_batch_elem_t * elems = safeMalloc(sizeof(s3_batch_elem_t) * n);
+    for(int i=0; i < n; i++){
+      char * p = elems[i].key;
+      def_file_name(o, p, names[first + i]);
+      memset(& bufs[first + i], 0, sizeof(struct stat));
+      elems[i].status = S3StatusInterrupted;
+      elems[i].st = & bufs[first + i];
+      elems[i].easy = NULL;
+      s3_setup_target = & elems[i].easy;
+      S3_head_object(& o->bucket_context, p, ctx, o->timeout, & batchResponseHandler, & elems[i]);
+      s3_setup_target = NULL;
+    }
+    success += S3_batch_finish(ctx, n, names + first, elems, status + first);
+  }
+  return success;
+}
+
 static int S3_check_params(aiori_mod_opt_t * options){
   s3_options_t * o = (s3_options_t*) options;
   if(o->access_key == NULL){
@@ -501,6 +1477,39 @@ static int S3_check_params(aiori_mod_opt_t * options){
   if(o->host == NULL){
     WARN("The S3 hostname should be specified");
   }
+  if(o->parallel_parts < 1){
+    ERR("The number of parallel parts must be at least 1");
+  }
+  if(o->parallel_ranges < 1 || o->range_size < 0){
+    ERR("The number of parallel ranges must be at least 1 and the range size non-negative");
+  }
+  if(o->read_ahead && (! o->multipart || o->range_size == 0)){
+    ERR("S3 read-ahead requires multipart mode and a range size");
+  }
+#ifndef S3_HTTP_TIMING
+  if(o->http_timing){
+    ERR("S3 HTTP timing requires libs3 with S3_create_request_context_ex() and the libcurl headers");
+  }
+#endif
+  if(o->multipart){
+    if(o->bucket_per_file){
+      ERR("S3 multipart uploads cannot be combined with bucket-per-file");
+    }
+    if(hints && hints->transferSize > 0){
+      /* every transfer is one part of the object of the file */
+      IOR_offset_t size = hints->blockSize * hints->segmentCount * (hints->filePerProc ? 1 : hints->numTasks);
+      IOR_offset_t parts = (size + hints->transferSize - 1) / hints->transferSize;
+      if(parts > S3_MPU_MAX_PARTS){
+        ERRF("S3 multipart uploads are limited to %d parts, the file needs %lld parts of the transfer size", S3_MPU_MAX_PARTS, (long long) parts);
+      }
+      if(parts > 1 && hints->transferSize < S3_MPU_MIN_PART_SIZE){
+        ERRF("S3 multipart uploads require parts of at least %d bytes except the last one, the transfer size is %lld", S3_MPU_MIN_PART_SIZE, (long long) hints->transferSize);
+      }
+    }
+  }
+  if(o->list_stat && o->bucket_per_file){
+    ERR("S3 list-stat cannot be combined with bucket-per-file");
+  }
   return 0;
 }
 
@@ -540,6 +1549,12 @@ static void S3_init(aiori_mod_opt_t * options){
   if(ret != S3StatusOK)
     FAIL("Could not initialize S3 library");
 
+  http_timing = o->http_timing;
+  if(http_timing){
+    memset(& http_stats, 0, sizeof(http_stats));
+    s3_create_context(& s3_sync_ctx);
+  }
+
   // create a bucket id based on access-key using a trivial checksumming
   if(! o->dont_suffix){
     uint64_t c = 0;
@@ -586,6 +1601,12 @@ static void S3_final(aiori_mod_opt_t * options){
     CHECK_ERROR(o->bucket_context.bucketName);
   }
 
+  if(http_timing){
+    s3_http_report("total");
+    S3_destroy_request_context(s3_sync_ctx);
+    s3_sync_ctx = NULL;
+    http_timing = 0;
+  }
   S3_deinitialize();
 }
 
@@ -612,5 +1633,9 @@ ior_aiori_t S3_libS3_aiori = {
         .get_options = S3_options,
         .check_params = S3_check_params,
         .sync = S3_Sync,
+        .put_batch = S3_put_batch,
+        .get_batch = S3_get_batch,
+        .remove_batch = S3_remove_batch,
+        .stat_batch = S3_stat_batch,
         .enable_mdtest = true
 };
@@ -45,6 +45,9 @@ ior_aiori_t *available_aiori[] = {
 #ifdef USE_AIO_AIORI
         &aio_aiori,
 #endif
+#ifdef USE_POSIX_AIORI
+        &ec_aiori,
+#endif
 #ifdef USE_PMDK_AIORI
         &pmdk_aiori,
 #endif
@@ -99,6 +102,9 @@ ior_aiori_t *available_aiori[] = {
         NULL
 };
 
+/* the options of all modules as parsed from the command line, used by backends that wrap other backends */
+static options_all_t * all_module_options = NULL;
+
 void * airoi_update_module_options(const ior_aiori_t * backend, options_all_t * opt){
   if (backend->get_options == NULL)
     return NULL;
@@ -130,9 +136,24 @@ options_all_t * airoi_create_all_module_options(option_help * global_options){
       opt->modules[i].options = NULL;
     }
   }
+  all_module_options = opt;
   return opt;
 }
 
+aiori_mod_opt_t * aiori_module_options(const ior_aiori_t * backend){
+  aiori_mod_opt_t * defaults = NULL;
+  if (backend->get_options == NULL)
+    return NULL;
+  if (all_module_options != NULL){
+    defaults = airoi_update_module_options(backend, all_module_options);
+  }
+  if (defaults == NULL){
+    option_help * help = backend->get_options(& defaults, NULL);
+    free(help);
+  }
+  return defaults;
+}
+
 void aiori_supported_apis(char * APIs, char * APIs_legacy, enum bench_type type)
 {
         ior_aiori_t **tmp = available_aiori;
@@ -243,6 +264,73 @@ char* aiori_get_version()
   return "";
 }
 
+int aiori_put_batch (const ior_aiori_t * backend, int count, char ** names, IOR_size_t ** buffers, IOR_offset_t * sizes, int * status, aiori_mod_opt_t * module_options)
+{
+        if (backend->put_batch)
+                return backend->put_batch(count, names, buffers, sizes, status, module_options);
+
+        int success = 0;
+        for (int i = 0; i < count; i++) {
+                aiori_fd_t *fd = backend->create(names[i], IOR_WRONLY | IOR_CREAT, module_options);
+                status[i] = -1;
+                if (fd == NULL)
+                        continue;
+                if (sizes[i] == 0 || backend->xfer(WRITE, fd, buffers[i], sizes[i], 0, module_options) == sizes[i]) {
+                        status[i] = 0;
+                        success++;
+                }
+                backend->close(fd, module_options);
+        }
+        return success;
+}
+
+int aiori_get_batch (const ior_aiori_t * backend, int count, char ** names, IOR_size_t ** buffers, IOR_offset_t * sizes, int * status, aiori_mod_opt_t * module_options)
+{
+        if (backend->get_batch)
+                return backend->get_batch(count, names, buffers, sizes, status, module_options);
+
+        int success = 0;
+        for (int i = 0; i < count; i++) {
+                aiori_fd_t *fd = backend->open(names[i], IOR_RDONLY, module_options);
+                status[i] = -1;
+                if (fd == NULL)
+                        continue;
+                if (sizes[i] == 0 || backend->xfer(READ, fd, buffers[i], sizes[i], 0, module_options) == sizes[i]) {
+                        status[i] = 0;
+                        success++;
+                }
+                backend->close(fd, module_options);
+        }
+        return success;
+}
+
+int aiori_remove_batch (const ior_aiori_t * backend, int count, char ** names, int * status, aiori_mod_opt_t * module_options)
+{
+        if (backend->remove_batch)
+                return backend->remove_batch(count, names, status, module_options);
+
+        /* remove() does not return an error, it reports failures itself like the non-batched path */
+        for (int i = 0; i < count; i++) {
+                backend->remove(names[i], module_options);
+                status[i] = 0;
+        }
+        return count;
+}
+
+int aiori_stat_batch (const ior_aiori_t * backend, int count, char ** names, struct stat * bufs, int * status, aiori_mod_opt_t * module_options)
+{
+        if (backend->stat_batch)
+                return backend->stat_batch(count, names, bufs, status, module_options);
+
+        int success = 0;
+        for (int i = 0; i < count; i++) {
+                status[i] = backend->stat(names[i], & bufs[i], module_options) == 0 ? 0 : -1;
+                if (status[i] == 0)
+                        success++;
+        }
+        return success;
+}
+
 const ior_aiori_t *aiori_select (const char *api)
 {
         char warn_str[256] = {0};
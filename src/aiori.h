@@ -112,6 +112,16 @@ typedef struct ior_aiori {
         option_help * (*get_options)(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t* init_values); /* initializes the backend options as well and returns the pointer to the option help structure */
         int (*check_params)(aiori_mod_opt_t *); /* check if the provided module_optionseters for the given test and the module options are correct, if they aren't print a message and exit(1) or return 1*/
         void (*sync)(aiori_mod_opt_t * ); /* synchronize every pending operation for this storage */
+        /*
+         Optional batch operations on count objects, each object is accessed as a whole from offset 0.
+         put creates and writes an object, get reads an object, stat fills bufs[i] like stat(),
+         status[i] is set to 0 on success and -1 otherwise.
+         They return the number of successful elements, use the aiori_*_batch() functions to fall back to individual calls.
+        */
+        int (*put_batch)(int count, char ** names, IOR_size_t ** buffers, IOR_offset_t * sizes, int * status, aiori_mod_opt_t * module_options);
+        int (*get_batch)(int count, char ** names, IOR_size_t ** buffers, IOR_offset_t * sizes, int * status, aiori_mod_opt_t * module_options);
+        int (*remove_batch)(int count, char ** names, int * status, aiori_mod_opt_t * module_options);
+        int (*stat_batch)(int count, char ** names, struct stat * bufs, int * status, aiori_mod_opt_t * module_options);
         bool enable_mdtest;
 } ior_aiori_t;
 
@@ -122,6 +132,7 @@ enum bench_type {
 
 extern ior_aiori_t dummy_aiori;
 extern ior_aiori_t aio_aiori;
+extern ior_aiori_t ec_aiori;
 extern ior_aiori_t daos_aiori;
 extern ior_aiori_t dfs_aiori;
 extern ior_aiori_t hdf5_aiori;
@@ -149,6 +160,8 @@ void aiori_supported_apis(char * APIs, char * APIs_legacy, enum bench_type type)
 options_all_t * airoi_create_all_module_options(option_help * global_options);
 
 void * airoi_update_module_options(const ior_aiori_t * backend, options_all_t * module_defaults);
+/* a copy of the parsed options of the backend, for backends that wrap another backend */
+aiori_mod_opt_t * aiori_module_options(const ior_aiori_t * backend);
 
 const char *aiori_default (void);
 
@@ -160,6 +173,12 @@ int aiori_posix_rmdir (const char *path, aiori_mod_opt_t * module_options);
 int aiori_posix_access (const char *path, int mode, aiori_mod_opt_t * module_options);
 int aiori_posix_stat (const char *path, struct stat *buf, aiori_mod_opt_t * module_options);
 
+/* batch operations using the backend batch calls if available or individual calls otherwise */
+int aiori_put_batch (const ior_aiori_t * backend, int count, char ** names, IOR_size_t ** buffers, IOR_offset_t * sizes, int * status, aiori_mod_opt_t * module_options);
+int aiori_get_batch (const ior_aiori_t * backend, int count, char ** names, IOR_size_t ** buffers, IOR_offset_t * sizes, int * status, aiori_mod_opt_t * module_options);
+int aiori_remove_batch (const ior_aiori_t * backend, int count, char ** names, int * status, aiori_mod_opt_t * module_options);
+int aiori_stat_batch (const ior_aiori_t * backend, int count, char ** names, struct stat * bufs, int * status, aiori_mod_opt_t * module_options);
+
 
 /* NOTE: these MPI-IO pro are exported for reuse by HDF5/PNetCDF */
 
@@ -170,6 +189,10 @@ typedef struct { /* if you change this datatype, e.g., adding more options, make
   int useSharedFilePointer;        /* use shared file pointer */
   int useStridedDatatype;          /* put strided access into datatype */
   char * hintsFileName;            /* full name for hints file */
+  int nonBlocking;                 /* use non-blocking transfers */
+  int requestWindow;               /* max outstanding non-blocking requests per file */
+  int wholePhase;                  /* one file view for the whole phase, transfers are aggregated */
+  IOR_offset_t phaseBufferSize;    /* bytes per buffer of the whole-phase mode */
 } mpiio_options_t;
 
 void MPIIO_Delete(char *testFileName, aiori_mod_opt_t * module_options);
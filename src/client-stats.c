@@ -0,0 +1,121 @@
+/*
+ * Per-phase accounting of the client resources, see client-stats.h
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "client-stats.h"
+#include "utilities.h"
+#include "aiori-debug.h"
+
+static int node_leader = 0;
+
+void client_stats_init(MPI_Comm com){
+  MPI_Comm node_comm;
+  int node_rank;
+  MPI_CHECK(MPI_Comm_split_type(com, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, & node_comm), "MPI_Comm_split_type() error");
+  MPI_CHECK(MPI_Comm_rank(node_comm, & node_rank), "MPI_Comm_rank() error");
+  MPI_CHECK(MPI_Comm_free(& node_comm), "MPI_Comm_free() error");
+  node_leader = node_rank == 0;
+}
+
+void client_stats_finalize(void){
+  node_leader = 0;
+}
+
+/* read "key value" lines of a proc file into the matching fields */
+static void read_proc_file(const char * file, const char ** keys, int * fields, double * scale, int count, client_stats_t * s){
+  FILE * f = fopen(file, "r");
+  if(f == NULL){
+    return;
+  }
+  char key[64];
+  unsigned long long value;
+  while(fscanf(f, "%63[^: ]%*[: ]%llu\n", key, & value) == 2){
+    for(int i=0; i < count; i++){
+      if(strcmp(key, keys[i]) == 0){
+        s->v[fields[i]] = value * scale[i];
+      }
+    }
+  }
+  fclose(f);
+}
+
+static void client_stats_sample(client_stats_t * s){
+  struct rusage ru;
+  memset(s, 0, sizeof(client_stats_t));
+  if(getrusage(RUSAGE_SELF, & ru) == 0){
+    s->v[CLIENT_STATS_UTIME] = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec * 1e-6;
+    s->v[CLIENT_STATS_STIME] = ru.ru_stime.tv_sec + ru.ru_stime.tv_usec * 1e-6;
+    s->v[CLIENT_STATS_NVCSW] = ru.ru_nvcsw;
+    s->v[CLIENT_STATS_NIVCSW] = ru.ru_nivcsw;
+    s->v[CLIENT_STATS_MAJFLT] = ru.ru_majflt;
+  }
+  {
+    const char * keys[] = {"read_bytes", "write_bytes", "cancelled_write_bytes"};
+    int fields[] = {CLIENT_STATS_READ_BYTES, CLIENT_STATS_WRITE_BYTES, CLIENT_STATS_CANCELLED_WRITE_BYTES};
+    double scale[] = {1, 1, 1};
+    read_proc_file("/proc/self/io", keys, fields, scale, 3, s);
+  }
+  if(node_leader){
+    const double page = sysconf(_SC_PAGESIZE);
+    const char * keys[] = {"nr_dirty", "nr_writeback", "pgpgin", "pgpgout"};
+    int fields[] = {CLIENT_STATS_NR_DIRTY, CLIENT_STATS_NR_WRITEBACK, CLIENT_STATS_PGPGIN, CLIENT_STATS_PGPGOUT};
+    double scale[] = {page, page, 1024, 1024};
+    s->v[CLIENT_STATS_NODES] = 1;
+    read_proc_file("/proc/vmstat", keys, fields, scale, 4, s);
+  }
+}
+
+void client_stats_start(client_stats_t * s){
+  client_stats_sample(s);
+}
+
+void client_stats_stop(client_stats_t * s, uint64_t app_bytes, uint64_t app_ops){
+  client_stats_t end;
+  client_stats_sample(& end);
+  for(int i=0; i < CLIENT_STATS_COUNT; i++){
+    s->v[i] = end.v[i] - s->v[i];
+  }
+  s->v[CLIENT_STATS_NODES] = end.v[CLIENT_STATS_NODES];
+  s->v[CLIENT_STATS_APP_BYTES] = app_bytes;
+  s->v[CLIENT_STATS_APP_OPS] = app_ops;
+}
+
+void client_stats_report(FILE * out, const char * phase, client_stats_t * s, MPI_Comm com){
+  client_stats_t sum;
+  int com_rank;
+  MPI_CHECK(MPI_Comm_rank(com, & com_rank), "MPI_Comm_rank() error");
+  MPI_CHECK(MPI_Reduce(s->v, sum.v, CLIENT_STATS_COUNT, MPI_DOUBLE, MPI_SUM, 0, com), "MPI_Reduce() error");
+  if(com_rank != 0){
+    return;
+  }
+  const double MiB = 1024.0 * 1024.0;
+  const double GiB = MiB * 1024.0;
+  double * v = sum.v;
+  double cpu = v[CLIENT_STATS_UTIME] + v[CLIENT_STATS_STIME];
+
+  fprintf(out, "client %-20s CPU %.3f s (user %.3f sys %.3f)", phase, cpu, v[CLIENT_STATS_UTIME], v[CLIENT_STATS_STIME]);
+  if(v[CLIENT_STATS_APP_BYTES] > 0){
+    fprintf(out, " %.3f CPU-s/GiB", cpu / (v[CLIENT_STATS_APP_BYTES] / GiB));
+  }
+  if(v[CLIENT_STATS_APP_OPS] > 0){
+    fprintf(out, " %.2f CPU-us/op", cpu * 1e6 / v[CLIENT_STATS_APP_OPS]);
+  }
+  fprintf(out, " ctxsw %.0f/%.0f majflt %.0f\n", v[CLIENT_STATS_NVCSW], v[CLIENT_STATS_NIVCSW], v[CLIENT_STATS_MAJFLT]);
+  fprintf(out, "client %-20s app %.1f MiB storage read %.1f MiB write %.1f MiB cancelled %.1f MiB", phase,
+    v[CLIENT_STATS_APP_BYTES] / MiB, v[CLIENT_STATS_READ_BYTES] / MiB, v[CLIENT_STATS_WRITE_BYTES] / MiB, v[CLIENT_STATS_CANCELLED_WRITE_BYTES] / MiB);
+  if(v[CLIENT_STATS_NODES] > 0){
+    fprintf(out, " nodes %.0f dirty %+.1f MiB writeback %+.1f MiB pgpgin %.1f MiB pgpgout %.1f MiB", v[CLIENT_STATS_NODES],
+      v[CLIENT_STATS_NR_DIRTY] / MiB, v[CLIENT_STATS_NR_WRITEBACK] / MiB, v[CLIENT_STATS_PGPGIN] / MiB, v[CLIENT_STATS_PGPGOUT] / MiB);
+  }
+  fprintf(out, "\n");
+  fflush(out);
+}
@@ -0,0 +1,47 @@
+#ifndef _IOR_CLIENT_STATS_H
+#define _IOR_CLIENT_STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <mpi.h>
+
+/*
+ * Per-phase accounting of the client resources: CPU time and context switches from getrusage(),
+ * the storage I/O of the process from /proc/self/io, and the page cache state of the node
+ * from /proc/vmstat (sampled by one rank per node only).
+ */
+
+enum {
+  CLIENT_STATS_UTIME = 0,   /* s */
+  CLIENT_STATS_STIME,       /* s */
+  CLIENT_STATS_NVCSW,
+  CLIENT_STATS_NIVCSW,
+  CLIENT_STATS_MAJFLT,
+  CLIENT_STATS_READ_BYTES,  /* bytes fetched from the storage layer */
+  CLIENT_STATS_WRITE_BYTES, /* bytes sent to the storage layer */
+  CLIENT_STATS_CANCELLED_WRITE_BYTES,
+  CLIENT_STATS_NODES,       /* number of node leaders */
+  CLIENT_STATS_NR_DIRTY,    /* bytes */
+  CLIENT_STATS_NR_WRITEBACK, /* bytes */
+  CLIENT_STATS_PGPGIN,      /* bytes */
+  CLIENT_STATS_PGPGOUT,     /* bytes */
+  CLIENT_STATS_APP_BYTES,   /* bytes accessed by the benchmark */
+  CLIENT_STATS_APP_OPS,     /* operations performed by the benchmark */
+  CLIENT_STATS_COUNT
+};
+
+typedef struct {
+  double v[CLIENT_STATS_COUNT];
+} client_stats_t;
+
+/* collective, determines the node leaders of com */
+void client_stats_init(MPI_Comm com);
+void client_stats_finalize(void);
+
+void client_stats_start(client_stats_t * s);
+/* turns s into the difference since client_stats_start() */
+void client_stats_stop(client_stats_t * s, uint64_t app_bytes, uint64_t app_ops);
+/* collective, sums up the differences of all ranks and prints them on rank 0 */
+void client_stats_report(FILE * out, const char * phase, client_stats_t * s, MPI_Comm com);
+
+#endif
@@ -0,0 +1,246 @@
+/*
+ * Write coalescing of the backend calls, see coalesce.h
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "coalesce.h"
+#include "utilities.h"
+
+enum {
+  COALESCE_WRITES = 0,    /* logical writes */
+  COALESCE_READS,         /* logical reads */
+  COALESCE_BACKEND_WRITES,
+  COALESCE_BACKEND_READS,
+  COALESCE_BUFFER_READS,  /* reads served from the buffer */
+  COALESCE_FLUSH_FULL,    /* the end of the window was reached */
+  COALESCE_FLUSH_GAP,     /* a write was not contiguous */
+  COALESCE_FLUSH_READ,    /* a read overlapped the buffer */
+  COALESCE_FLUSH_FSYNC,
+  COALESCE_FLUSH_CLOSE,
+  COALESCE_COUNTERS
+};
+
+typedef struct {
+  aiori_fd_t * fd;      /* of the wrapped backend */
+  char * buf;           /* allocated on the first write */
+  IOR_offset_t window;  /* file offset of buf */
+  IOR_offset_t start;   /* buffered range of the file, empty if start == end */
+  IOR_offset_t end;
+} coalesce_fd_t;
+
+static struct {
+  const ior_aiori_t * orig; /* NULL if coalescing is disabled */
+  ior_aiori_t wrapped;
+  IOR_offset_t size;
+  uint64_t counters[COALESCE_COUNTERS];
+} cs;
+
+static void flush(coalesce_fd_t * cfd, int reason, aiori_mod_opt_t * module_options){
+  IOR_offset_t length = cfd->end - cfd->start;
+  if(length == 0){
+    return;
+  }
+  IOR_offset_t ret = cs.orig->xfer(WRITE, cfd->fd, (IOR_size_t *) (cfd->buf + (cfd->start - cfd->window)), length, cfd->start, module_options);
+  if(ret != length){
+    ERRF("Coalesced write of %lld bytes at offset %lld returned %lld", (long long) length, (long long) cfd->start, (long long) ret);
+  }
+  cs.counters[COALESCE_BACKEND_WRITES]++;
+  cs.counters[reason]++;
+  cfd->start = cfd->end = 0;
+}
+
+/*
+ * Writes the buffered range up to the end of its aligned window, the rest moves to the start
+ * of the buffer and begins the next window.
+ */
+static void flush_window(coalesce_fd_t * cfd, aiori_mod_opt_t * module_options){
+  IOR_offset_t boundary = cfd->window + cs.size;
+  IOR_offset_t end = cfd->end;
+  cfd->end = boundary;
+  flush(cfd, COALESCE_FLUSH_FULL, module_options);
+  if(end > boundary){
+    memmove(cfd->buf, cfd->buf + cs.size, end - boundary);
+    cfd->window = cfd->start = boundary;
+    cfd->end = end;
+  }
+}
+
+/*
+ * The buffer holds two aligned windows, so a write that crosses the end of a window is buffered
+ * as a whole. Only a filled window is flushed at the aligned boundary; a range that starts
+ * within its window is flushed there once a contiguous write continues it, otherwise it is
+ * written with one call like any range on a gap.
+ */
+static IOR_offset_t coalesce_write(coalesce_fd_t * cfd, char * buffer, IOR_offset_t size, IOR_offset_t offset, aiori_mod_opt_t * module_options){
+  IOR_offset_t remaining = size;
+  while(remaining > 0){
+    int buffered = cfd->end > cfd->start;
+    /* the buffered range can only grow if the write touches it */
+    if(buffered && (offset > cfd->end || offset + remaining < cfd->start || offset < cfd->window)){
+      flush(cfd, COALESCE_FLUSH_GAP, module_options);
+      buffered = 0;
+    }
+    if(buffered && cfd->end > cfd->window + cs.size){
+      /* the range that crossed the window end is continued, i.e., written sequentially */
+      flush_window(cfd, module_options);
+      continue;
+    }
+    if(! buffered && remaining >= cs.size){
+      /* writes of at least the buffer size are passed on with one call */
+      IOR_offset_t ret = cs.orig->xfer(WRITE, cfd->fd, (IOR_size_t *) buffer, remaining, offset, module_options);
+      cs.counters[COALESCE_BACKEND_WRITES]++;
+      if(ret != remaining){
+        return size - remaining + (ret > 0 ? ret : 0);
+      }
+      return size;
+    }
+    if(cfd->buf == NULL){
+      cfd->buf = aligned_buffer_alloc(2 * cs.size, IOR_MEMORY_TYPE_CPU);
+    }
+    if(! buffered){
+      cfd->window = offset - offset % cs.size;
+      cfd->start = cfd->end = offset;
+    }
+    IOR_offset_t n = cfd->window + 2 * cs.size - offset;
+    if(n > remaining){
+      n = remaining;
+    }
+    memcpy(cfd->buf + (offset - cfd->window), buffer, n);
+    if(offset < cfd->start){
+      cfd->start = offset;
+    }
+    if(offset + n > cfd->end){
+      cfd->end = offset + n;
+    }
+    if(cfd->start == cfd->window && cfd->end >= cfd->window + cs.size){
+      flush_window(cfd, module_options);
+    }
+    buffer += n;
+    offset += n;
+    remaining -= n;
+  }
+  return size;
+}
+
+/* wrappers of the backend functions that access a file descriptor */
+
+static aiori_fd_t *coalesce_wrap(aiori_fd_t * fd){
+  if(fd == NULL){
+    return NULL;
+  }
+  coalesce_fd_t * cfd = safeMalloc(sizeof(coalesce_fd_t));
+  memset(cfd, 0, sizeof(coalesce_fd_t));
+  cfd->fd = fd;
+  return (aiori_fd_t *) cfd;
+}
+
+static aiori_fd_t *coalesce_create(char * name, int flags, aiori_mod_opt_t * module_options){
+  return coalesce_wrap(cs.orig->create(name, flags, module_options));
+}
+
+static aiori_fd_t *coalesce_open(char * name, int flags, aiori_mod_opt_t * module_options){
+  return coalesce_wrap(cs.orig->open(name, flags, module_options));
+}
+
+static IOR_offset_t coalesce_xfer(int access, aiori_fd_t * fd, IOR_size_t * buffer, IOR_offset_t size, IOR_offset_t offset, aiori_mod_opt_t * module_options){
+  coalesce_fd_t * cfd = (coalesce_fd_t *) fd;
+  if(access == WRITE){
+    cs.counters[COALESCE_WRITES]++;
+    return coalesce_write(cfd, (char *) buffer, size, offset, module_options);
+  }
+  cs.counters[COALESCE_READS]++;
+  if(cfd->end > cfd->start && offset < cfd->end && offset + size > cfd->start){
+    if(offset >= cfd->start && offset + size <= cfd->end){
+      memcpy(buffer, cfd->buf + (offset - cfd->window), size);
+      cs.counters[COALESCE_BUFFER_READS]++;
+      return size;
+    }
+    flush(cfd, COALESCE_FLUSH_READ, module_options);
+  }
+  cs.counters[COALESCE_BACKEND_READS]++;
+  return cs.orig->xfer(access, cfd->fd, buffer, size, offset, module_options);
+}
+
+static void coalesce_close(aiori_fd_t * fd, aiori_mod_opt_t * module_options){
+  coalesce_fd_t * cfd = (coalesce_fd_t *) fd;
+  flush(cfd, COALESCE_FLUSH_CLOSE, module_options);
+  cs.orig->close(cfd->fd, module_options);
+  if(cfd->buf != NULL){
+    aligned_buffer_free(cfd->buf, IOR_MEMORY_TYPE_CPU);
+  }
+  free(cfd);
+}
+
+static void coalesce_fsync(aiori_fd_t * fd, aiori_mod_opt_t * module_options){
+  coalesce_fd_t * cfd = (coalesce_fd_t *) fd;
+  flush(cfd, COALESCE_FLUSH_FSYNC, module_options);
+  cs.orig->fsync(cfd->fd, module_options);
+}
+
+const ior_aiori_t * coalesce_init(IOR_offset_t buffer_size, const ior_aiori_t * backend){
+  if(buffer_size == 0){
+    return backend;
+  }
+  if(buffer_size < 0){
+    ERRF("Invalid coalescing buffer size: %lld", (long long) buffer_size);
+  }
+  if(cs.orig != NULL){
+    ERR("Write coalescing is already active");
+  }
+  memset(& cs, 0, sizeof(cs));
+  cs.orig = backend;
+  cs.size = buffer_size;
+
+  /* the functions without a file descriptor are called directly */
+  cs.wrapped = *backend;
+  ior_aiori_t * w = & cs.wrapped;
+  w->create = backend->create ? coalesce_create : NULL;
+  w->open = backend->open ? coalesce_open : NULL;
+  w->xfer = backend->xfer ? coalesce_xfer : NULL;
+  w->close = backend->close ? coalesce_close : NULL;
+  w->fsync = backend->fsync ? coalesce_fsync : NULL;
+  return w;
+}
+
+void coalesce_finalize(void){
+  if(cs.orig == NULL){
+    return;
+  }
+  /* the wrapped backend may still be referenced, let it call the original functions */
+  cs.wrapped = *cs.orig;
+  cs.orig = NULL;
+}
+
+void coalesce_report(FILE * out, const char * phase, MPI_Comm com){
+  uint64_t sum[COALESCE_COUNTERS];
+  int com_rank;
+  if(cs.orig == NULL){
+    return;
+  }
+  MPI_CHECK(MPI_Comm_rank(com, & com_rank), "MPI_Comm_rank() error");
+  MPI_CHECK(MPI_Reduce(cs.counters, sum, COALESCE_COUNTERS, MPI_UINT64_T, MPI_SUM, 0, com), "MPI_Reduce() error");
+  memset(cs.counters, 0, sizeof(cs.counters));
+  if(com_rank != 0){
+    return;
+  }
+  uint64_t logical = sum[COALESCE_WRITES] + sum[COALESCE_READS];
+  uint64_t physical = sum[COALESCE_BACKEND_WRITES] + sum[COALESCE_BACKEND_READS];
+  fprintf(out, "coalesce %-16s writes %llu -> %llu reads %llu -> %llu (%llu from buffer) ratio %.2f flushes full %llu gap %llu read %llu fsync %llu close %llu\n",
+          phase,
+          (unsigned long long) sum[COALESCE_WRITES], (unsigned long long) sum[COALESCE_BACKEND_WRITES],
+          (unsigned long long) sum[COALESCE_READS], (unsigned long long) sum[COALESCE_BACKEND_READS],
+          (unsigned long long) sum[COALESCE_BUFFER_READS],
+          physical > 0 ? (double) logical / physical : 0.0,
+          (unsigned long long) sum[COALESCE_FLUSH_FULL], (unsigned long long) sum[COALESCE_FLUSH_GAP],
+          (unsigned long long) sum[COALESCE_FLUSH_READ], (unsigned long long) sum[COALESCE_FLUSH_FSYNC],
+          (unsigned long long) sum[COALESCE_FLUSH_CLOSE]);
+  fflush(out);
+}
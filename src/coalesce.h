@@ -0,0 +1,26 @@
+#ifndef _IOR_COALESCE_H
+#define _IOR_COALESCE_H
+
+#include <stdio.h>
+#include <mpi.h>
+
+#include "aiori.h"
+
+/*
+ * Write coalescing: the functions of the ior_aiori_t are wrapped and the writes of each open
+ * file are collected in a write-back buffer of two aligned windows of the file. A filled window
+ * is written with one aligned backend call; the buffered range is also written on a write that
+ * is not contiguous with it, before an overlapping read, on fsync and on close. A single write
+ * is never split into several backend calls unless it continues a sequential stream, and
+ * writes of at least the buffer size are not buffered.
+ * Reads that are covered by the buffer are served from it.
+ */
+
+/* returns the wrapped backend or backend itself if buffer_size is 0 */
+const ior_aiori_t * coalesce_init(IOR_offset_t buffer_size, const ior_aiori_t * backend);
+void coalesce_finalize(void);
+
+/* collective on com, prints the logical and physical operations since the last report on rank 0 */
+void coalesce_report(FILE * out, const char * phase, MPI_Comm com);
+
+#endif
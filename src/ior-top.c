@@ -0,0 +1,141 @@
+/*
+ * Watch the live progress telemetry of the ranks on this node (see telemetry.h).
+ * Run the benchmark with --telemetry=NAME and start ior-top NAME.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TELEMETRY_READER_ONLY
+#include "telemetry.h"
+
+#define MIB (1024.0 * 1024.0)
+#define WAIT_TIMEOUT 10 /* s until the benchmark initialized the segment */
+
+static double wall_time(){
+  struct timeval tv;
+  gettimeofday(& tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static void sleep_seconds(double t){
+  struct timespec ts = {(time_t) t, (long) ((t - (time_t) t) * 1e9)};
+  nanosleep(& ts, NULL);
+}
+
+static void print_rates(const char * label, const char * phase, uint64_t bytes, uint64_t ops, uint64_t errors, double latency, uint64_t prev_bytes, uint64_t prev_ops, double interval){
+  printf("%-6s %-16s %12.1f %10.1f %12.1f %8llu %12.3e\n", label, phase, bytes / MIB, (bytes - prev_bytes) / MIB / interval, (ops - prev_ops) / interval, (unsigned long long) errors, latency);
+}
+
+int main(int argc, char ** argv){
+  if(argc < 2 || argc > 4){
+    fprintf(stderr, "Synopsis: %s <NAME> [<INTERVAL in s>] [-1]\n", argv[0]);
+    fprintf(stderr, "Watches the telemetry segment of the benchmark started with --telemetry=NAME, -1 prints one sample only\n");
+    return 1;
+  }
+  char name[256];
+  snprintf(name, sizeof(name), "/%s", argv[1]);
+  double interval = argc > 2 && strcmp(argv[2], "-1") != 0 ? atof(argv[2]) : 1.0;
+  int once = strcmp(argv[argc - 1], "-1") == 0;
+  if(interval <= 0){
+    interval = 1.0;
+  }
+
+  int fd = shm_open(name, O_RDONLY, 0);
+  if(fd < 0){
+    fprintf(stderr, "Cannot open the telemetry segment %s, is the benchmark running?\n", name);
+    return 1;
+  }
+  /* the benchmark creates the segment, sizes it and sets the magic last */
+  struct stat st;
+  telemetry_segment_t * seg = NULL;
+  size_t mapped = 0;
+  double deadline = wall_time() + WAIT_TIMEOUT;
+  while(1){
+    if(fstat(fd, & st) != 0){
+      fprintf(stderr, "Cannot stat the telemetry segment %s\n", name);
+      return 1;
+    }
+    /* mapping beyond the end of the segment would fault on access */
+    if(seg == NULL && (size_t) st.st_size >= sizeof(telemetry_segment_t)){
+      mapped = st.st_size;
+      seg = mmap(NULL, mapped, PROT_READ, MAP_SHARED, fd, 0);
+      if(seg == MAP_FAILED){
+        fprintf(stderr, "Cannot map the telemetry segment %s\n", name);
+        return 1;
+      }
+    }
+    if(seg != NULL && seg->magic == TELEMETRY_MAGIC){
+      break;
+    }
+    if(wall_time() > deadline){
+      fprintf(stderr, "Invalid telemetry segment %s, not initialized within %d s\n", name, WAIT_TIMEOUT);
+      return 1;
+    }
+    sleep_seconds(0.01);
+  }
+  int slots = seg->slots;
+  if(slots < 0 || sizeof(telemetry_segment_t) + sizeof(telemetry_slot_t) * slots > mapped){
+    fprintf(stderr, "Invalid telemetry segment %s\n", name);
+    return 1;
+  }
+
+  uint64_t * prev_bytes = calloc(slots + 1, sizeof(uint64_t));
+  uint64_t * prev_ops = calloc(slots + 1, sizeof(uint64_t));
+  double prev_time = seg->start_time;
+  while(1){
+    if(! once){
+      sleep_seconds(interval);
+    }
+    /* a new benchmark with the same name truncates the segment */
+    if(fstat(fd, & st) != 0 || (size_t) st.st_size < mapped){
+      fprintf(stderr, "The telemetry segment %s was replaced\n", name);
+      return 1;
+    }
+    double now = wall_time();
+    double elapsed = now - prev_time;
+    if(elapsed <= 0){
+      elapsed = 1e-9;
+    }
+    printf("%s on %s, %d ranks, runtime %.1fs\n", seg->command, seg->hostname, slots, now - seg->start_time);
+    printf("%-6s %-16s %12s %10s %12s %8s %12s\n", "rank", "phase", "MiB", "MiB/s", "ops/s", "errors", "last-lat(s)");
+    uint64_t bytes = 0, ops = 0, errors = 0;
+    double latency = 0;
+    for(int i=0; i < slots; i++){
+      telemetry_slot_t s = seg->slot[i];
+      char label[16];
+      s.phase[TELEMETRY_PHASE_LEN - 1] = 0;
+      snprintf(label, sizeof(label), "%d", s.rank);
+      print_rates(label, s.phase, s.bytes, s.ops, s.errors, s.last_latency, prev_bytes[i], prev_ops[i], elapsed);
+      prev_bytes[i] = s.bytes;
+      prev_ops[i] = s.ops;
+      bytes += s.bytes;
+      ops += s.ops;
+      errors += s.errors;
+      latency = s.last_latency > latency ? s.last_latency : latency;
+    }
+    print_rates("node", "", bytes, ops, errors, latency, prev_bytes[slots], prev_ops[slots], elapsed);
+    printf("\n");
+    fflush(stdout);
+    prev_bytes[slots] = bytes;
+    prev_ops[slots] = ops;
+    prev_time = now;
+    if(once || seg->finished){
+      break;
+    }
+  }
+  return 0;
+}
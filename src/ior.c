@@ -44,6 +44,11 @@
 #include "aiori.h"
 #include "utilities.h"
 #include "parse_options.h"
+#include "telemetry.h"
+#include "client-stats.h"
+#include "perf-counters.h"
+#include "timeline.h"
+#include "coalesce.h"
 
 enum {
         IOR_TIMER_OPEN_START,
@@ -135,6 +140,17 @@ static int test_initialize(IOR_test_t * test){
   }
   ior_set_xfer_hints(& test->params);
   aiori_warning_as_errors = test->params.warningAsErrors;
+  telemetry_init(test->params.telemetry, "ior", testComm);
+  if(test->params.clientStats){
+    client_stats_init(testComm);
+  }
+  if(test->params.perfCounters){
+    perf_counters_init();
+  }
+  test->params.backend = timeline_init(test->params.timeline, test->params.timelineEvents, backend, testComm);
+  /* the timeline records the coalesced calls */
+  test->params.backend = coalesce_init(test->params.coalesceBuffer, test->params.backend);
+  backend = test->params.backend;
 
   if (rank == 0 && verbose >= VERBOSE_0) {
     ShowTestStart(& test->params);
@@ -144,6 +160,11 @@ static int test_initialize(IOR_test_t * test){
 
 static void test_finalize(IOR_test_t * test){
   backend = test->params.backend;
+  telemetry_finalize();
+  client_stats_finalize();
+  perf_counters_finalize();
+  coalesce_finalize();
+  timeline_finalize();
   if(backend->finalize){
     backend->finalize(test->params.backend_options);
   }
@@ -284,6 +305,7 @@ void init_IOR_Param_t(IOR_param_t * p, MPI_Comm com)
         p->transferSize = 262144;
         p->randomSeed = -1;
         p->incompressibleSeed = 573;
+        p->timelineEvents = TIMELINE_DEFAULT_EVENTS;
         p->testComm = com; // this com might change for smaller tests
         p->mpi_comm_world = com;
 
@@ -1161,6 +1183,8 @@ static void TestIoSys(IOR_test_t *test)
         IOR_offset_t dataMoved; /* for data rate calculation */
         void *hog_buf;
         IOR_io_buffers ioBuffers;
+        client_stats_t clientStats;
+        perf_counters_t perfCounters;
 
         /* show test setup */
         if (rank == 0 && verbose >= VERBOSE_0)
@@ -1245,6 +1269,11 @@ static void TestIoSys(IOR_test_t *test)
                         params->stoneWallingWearOutIterations = params_saved_wearout;
                         MPI_CHECK(MPI_Barrier(testComm), "barrier error");
                         params->open = WRITE;
+                        timeline_phase("write");
+                        if (params->clientStats)
+                                client_stats_start(&clientStats);
+                        if (params->perfCounters)
+                                perf_counters_start(&perfCounters);
                         timer[IOR_TIMER_OPEN_START] = GetTimeStamp();
                         fd = backend->create(testFileName, IOR_WRONLY | IOR_CREAT | IOR_TRUNC, params->backend_options);
                         if(fd == NULL) FAIL("Cannot create file");
@@ -1271,6 +1300,11 @@ static void TestIoSys(IOR_test_t *test)
                         backend->close(fd, params->backend_options);
 
                         timer[IOR_TIMER_CLOSE_STOP] = GetTimeStamp();
+                        timeline_phase(NULL);
+                        if (params->perfCounters)
+                                perf_counters_stop(&perfCounters);
+                        if (params->clientStats)
+                                client_stats_stop(&clientStats, dataMoved, dataMoved / params->transferSize);
                         MPI_CHECK(MPI_Barrier(testComm), "barrier error");
 
                         /* check if stat() of file doesn't equal expected file size,
@@ -1278,6 +1312,12 @@ static void TestIoSys(IOR_test_t *test)
                         CheckFileSize(test, testFileName, dataMoved, rep, WRITE);
 
                         ProcessIterResults(test, timer, rep, WRITE);
+                        if (params->clientStats)
+                                client_stats_report(out_logfile, "write", &clientStats, testComm);
+                        if (params->perfCounters)
+                                perf_counters_report(out_logfile, "write", &perfCounters, dataMoved / params->transferSize, testComm);
+                        if (params->coalesceBuffer)
+                                coalesce_report(out_logfile, "write", testComm);
 
                         /* check if in this round we run write with stonewalling */
                         if(params->deadlineForStonewalling > 0){
@@ -1307,10 +1347,12 @@ static void TestIoSys(IOR_test_t *test)
                         
                         GetTestFileName(testFileName, params);
                         params->open = WRITECHECK;
+                        timeline_phase("write-check");
                         fd = backend->open(testFileName, IOR_RDONLY, params->backend_options);
                         if(fd == NULL) FAIL("Cannot open file");
                         dataMoved = WriteOrRead(params, rep, &results[rep], fd, WRITECHECK, &ioBuffers);
                         backend->close(fd, params->backend_options);
+                        timeline_phase(NULL);
                         rankOffset = 0;
                 }
                 /*
@@ -1403,6 +1445,11 @@ static void TestIoSys(IOR_test_t *test)
                         DelaySecs(params->interTestDelay);
                         MPI_CHECK(MPI_Barrier(testComm), "barrier error");
                         params->open = READ;
+                        timeline_phase(operation_flag == READ ? "read" : "read-check");
+                        if (params->clientStats)
+                                client_stats_start(&clientStats);
+                        if (params->perfCounters)
+                                perf_counters_start(&perfCounters);
                         timer[IOR_TIMER_OPEN_START] = GetTimeStamp();
                         fd = backend->open(testFileName, IOR_RDONLY, params->backend_options);
                         if(fd == NULL) FAIL("Cannot open file");
@@ -1424,12 +1471,23 @@ static void TestIoSys(IOR_test_t *test)
                         timer[IOR_TIMER_CLOSE_START] = GetTimeStamp();
                         backend->close(fd, params->backend_options);
                         timer[IOR_TIMER_CLOSE_STOP] = GetTimeStamp();
+                        timeline_phase(NULL);
+                        if (params->perfCounters)
+                                perf_counters_stop(&perfCounters);
+                        if (params->clientStats)
+                                client_stats_stop(&clientStats, dataMoved, dataMoved / params->transferSize);
 
                         /* check if stat() of file doesn't equal expected file size,
                            use actual amount of byte moved */
                         CheckFileSize(test, testFileName, dataMoved, rep, READ);
 
                         ProcessIterResults(test, timer, rep, READ);
+                        if (params->clientStats)
+                                client_stats_report(out_logfile, "read", &clientStats, testComm);
+                        if (params->perfCounters)
+                                perf_counters_report(out_logfile, "read", &perfCounters, dataMoved / params->transferSize, testComm);
+                        if (params->coalesceBuffer)
+                                coalesce_report(out_logfile, "read", testComm);
                 }
 
                 if (!params->keepFile
@@ -1475,6 +1533,10 @@ static void ValidateTests(IOR_param_t * test, MPI_Comm com)
           ERR("GPUDirect requires a non-CPU memory type");
         if (test->gpuMemoryFlags == IOR_MEMORY_TYPE_GPU_DEVICE_ONLY && ! test->gpuDirect )
           ERR("Using GPU Device memory only requires the usage of GPUDirect");
+        if (test->coalesceBuffer < 0)
+          ERR("the coalescing buffer size must be non-negative");
+        if (test->coalesceBuffer && test->gpuMemoryFlags == IOR_MEMORY_TYPE_GPU_DEVICE_ONLY)
+          ERR("write coalescing copies the data on the CPU and cannot be used with GPU device memory");
         if (test->stoneWallingStatusFile && test->keepFile == 0)
           ERR("a StoneWallingStatusFile is only sensible when splitting write/read into multiple executions of ior, please use -k");
         if (test->stoneWallingStatusFile && test->stoneWallingWearOut == 0 && test->writeFile)
@@ -1682,7 +1744,9 @@ static IOR_offset_t WriteOrReadSingle(IOR_offset_t offset, int pretendRank, IOR_
           update_write_memory_pattern(offset, ioBuffers->buffer, transfer, test->setTimeStampSignature, pretendRank, test->dataPacketType, test->gpuMemoryFlags);
           double start = GetTimeStamp();
           amtXferred = backend->xfer(access, fd, buffer, transfer, offset, test->backend_options);
-          if(ot) OpTimerValue(ot, start - startTime, GetTimeStamp() - start);
+          double runtime = GetTimeStamp() - start;
+          if(ot) OpTimerRecord(ot, access, start - startTime, runtime, transfer, offset);
+          telemetry_op(transfer, runtime);
           if (amtXferred != transfer)
                   ERR("cannot write to file");
           if (test->fsyncPerWrite)
@@ -1694,7 +1758,9 @@ static IOR_offset_t WriteOrReadSingle(IOR_offset_t offset, int pretendRank, IOR_
   } else if (access == READ) {
           double start = GetTimeStamp();
           amtXferred = backend->xfer(access, fd, buffer, transfer, offset, test->backend_options);
-          if(ot) OpTimerValue(ot, start - startTime, GetTimeStamp() - start);
+          double runtime = GetTimeStamp() - start;
+          if(ot) OpTimerRecord(ot, access, start - startTime, runtime, transfer, offset);
+          telemetry_op(transfer, runtime);
           if (amtXferred != transfer)
                   ERR("cannot read from file");
           if (test->interIODelay > 0){
@@ -1705,19 +1771,27 @@ static IOR_offset_t WriteOrReadSingle(IOR_offset_t offset, int pretendRank, IOR_
           invalidate_buffer_pattern(buffer, transfer, test->gpuMemoryFlags);
           double start = GetTimeStamp();
           amtXferred = backend->xfer(access, fd, buffer, transfer, offset, test->backend_options);
-          if(ot) OpTimerValue(ot, start - startTime, GetTimeStamp() - start);
+          double runtime = GetTimeStamp() - start;
+          if(ot) OpTimerRecord(ot, access, start - startTime, runtime, transfer, offset);
+          telemetry_op(transfer, runtime);
           if (amtXferred != transfer)
                   ERR("cannot read from file write check");
-          *errors += CompareData(buffer, transfer, test, offset, pretendRank, WRITECHECK);
+          int cmp_errors = CompareData(buffer, transfer, test, offset, pretendRank, WRITECHECK);
+          *errors += cmp_errors;
+          telemetry_error(cmp_errors);
   } else if (access == READCHECK) {
           invalidate_buffer_pattern(buffer, transfer, test->gpuMemoryFlags);          
           double start = GetTimeStamp();
           amtXferred = backend->xfer(access, fd, buffer, transfer, offset, test->backend_options);
-          if(ot) OpTimerValue(ot, start - startTime, GetTimeStamp() - start);
+          double runtime = GetTimeStamp() - start;
+          if(ot) OpTimerRecord(ot, access, start - startTime, runtime, transfer, offset);
+          telemetry_op(transfer, runtime);
           if (amtXferred != transfer){
             ERR("cannot read from file");
           }
-          *errors += CompareData(buffer, transfer, test, offset, pretendRank, READCHECK);
+          int cmp_errors = CompareData(buffer, transfer, test, offset, pretendRank, READCHECK);
+          *errors += cmp_errors;
+          telemetry_error(cmp_errors);
   }
   return amtXferred;
 }
@@ -1761,6 +1835,7 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
 
         /* initialize values */
         pretendRank = (rank + rankOffset) % test->numTasks;
+        telemetry_phase(access == WRITE ? "write" : access == WRITECHECK ? "write-check" : access == READ ? "read" : "read-check");
 
         //  offsetArray = GetOffsetArraySequential(test, pretendRank);
 
@@ -1787,8 +1862,8 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
         OpTimer * ot = NULL;
         if(test->savePerOpDataCSV != NULL) {
                 char fname[FILENAME_MAX];
-                sprintf(fname, "%s-%d-%05d.csv", test->savePerOpDataCSV, rep, rank);
-                ot = OpTimerInit(fname, test->transferSize);
+                sprintf(fname, "%s-%d-%05d.%s", test->savePerOpDataCSV, rep, rank, optrace_format_suffix(test->savePerOpDataFormat));
+                ot = OpTimerInit(fname, test->transferSize, test->savePerOpDataFormat);
         }
         // start timer after random offset was generated        
         startForStonewall = GetTimeStamp();
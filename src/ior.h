@@ -116,6 +116,13 @@ typedef struct
     IOR_offset_t randomPrefillBlocksize;   /* prefill option for random IO, the amount of data used for prefill */
 
     char * savePerOpDataCSV;            /* save details about each I/O operation into this file */
+    int savePerOpDataFormat;            /* format of the per operation data, optrace_format_e */
+    char * telemetry;                   /* name of the shared memory segment for live progress telemetry */
+    int clientStats;                    /* report the client CPU and OS I/O accounting per phase */
+    int perfCounters;                   /* report hardware performance counters per phase */
+    char * timeline;                    /* write a timeline of all backend calls into this file */
+    int timelineEvents;                 /* number of backend calls kept per rank for the timeline */
+    IOR_offset_t coalesceBuffer;        /* coalesce writes per file in a buffer of this size, 0 disables it */
     char * saveRankDetailsCSV;       /* save the details about the performance to a file */
     int summary_every_test;          /* flag to print summary every test, not just at end */
     int uniqueDir;                   /* use unique directory for each fpp */
@@ -0,0 +1,55 @@
+/*
+ * Convert a binary per-operation trace (see optrace.h) into CSV.
+ * The first columns are identical to the CSV written directly by the benchmarks.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "optrace.h"
+
+int main(int argc, char ** argv){
+  if(argc < 2 || argc > 3){
+    fprintf(stderr, "Synopsis: %s <TRACE> [<CSV>]\n", argv[0]);
+    fprintf(stderr, "Converts the binary trace into CSV, written to stdout if no output file is given\n");
+    return 1;
+  }
+  FILE * in = fopen(argv[1], "rb");
+  if(in == NULL){
+    fprintf(stderr, "Cannot open %s\n", argv[1]);
+    return 1;
+  }
+  int format = optrace_read_header(in);
+  if(format < 0){
+    fprintf(stderr, "%s is not a trace file\n", argv[1]);
+    return 1;
+  }
+  FILE * out = stdout;
+  if(argc == 3){
+    out = fopen(argv[2], "w");
+    if(out == NULL){
+      fprintf(stderr, "Cannot open %s\n", argv[2]);
+      return 1;
+    }
+  }
+
+  fprintf(out, "time,runtime,tp,op,size,offset\n");
+  optrace_state_t state = {0};
+  optrace_record_t rec;
+  int ret;
+  while((ret = optrace_read(in, format, & state, & rec)) == 1){
+    fprintf(out, "%.8e,%.8e,%e,%d,%lld,%lld\n", rec.time, rec.runtime, rec.size / rec.runtime, rec.op, (long long) rec.size, (long long) rec.offset);
+  }
+  if(ret < 0){
+    fprintf(stderr, "%s is truncated\n", argv[1]);
+  }
+  fclose(in);
+  if(out != stdout){
+    fclose(out);
+  }
+  return ret < 0 ? 1 : 0;
+}
@@ -3,7 +3,9 @@
 #include "md-workbench.h"
 
 int main(int argc, char ** argv){
-  MPI_Init(& argc, & argv);
+  int provided;
+  // the windowed mode uses worker threads that may abort via MPI on errors
+  MPI_Init_thread(& argc, & argv, MPI_THREAD_MULTIPLE, & provided);
   //phase_stat_t* results =
   md_workbench_run(argc, argv, MPI_COMM_WORLD, stdout);
   // API check, access the results of the first phase which is precrate.
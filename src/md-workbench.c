@@ -7,7 +7,9 @@
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
+#include <float.h>
 #include <assert.h>
+#include <pthread.h>
 
 #include "md-workbench.h"
 #include "config.h"
@@ -40,6 +42,22 @@ typedef struct{
   float runtime;
 } time_result_t;
 
+/*
+ Mergeable quantile sketch with logarithmic buckets (DDSketch style).
+ Bucket i covers the latencies (SKETCH_MIN_VALUE * gamma^(i-1), SKETCH_MIN_VALUE * gamma^i], with gamma = (1+a)/(1-a),
+ hence any quantile is returned with a relative error of at most a (the latency accuracy).
+ Sketches of different processes are merged by adding the bucket counts.
+ */
+#define SKETCH_MIN_VALUE 1e-9
+#define SKETCH_MAX_VALUE 1e5
+
+typedef struct{
+  uint64_t count;
+  double min;
+  double max;
+  uint64_t bins[]; // sketch_bins many
+} latency_sketch_t;
+
 
 // statistics for running a single phase
 typedef struct{ // NOTE: if this type is changed, adjust end_phase() !!!
@@ -54,18 +72,26 @@ typedef struct{ // NOTE: if this type is changed, adjust end_phase() !!!
   op_stat_t obj_stat;
   op_stat_t obj_delete;
 
-  // time measurements of individual runs, these are not returned for now by the API!
+  // time measurements of individual runs, these are only kept when latency files are written
   uint64_t repeats;
   time_result_t * time_create;
   time_result_t * time_read;
   time_result_t * time_stat;
   time_result_t * time_delete;
 
+  latency_sketch_t * sketch_create;
+  latency_sketch_t * sketch_read;
+  latency_sketch_t * sketch_stat;
+  latency_sketch_t * sketch_delete;
+  latency_sketch_t * sketch_workflow; // open-loop: from the scheduled arrival until the workflow completes
+
   time_statistics_t stats_create;
   time_statistics_t stats_read;
   time_statistics_t stats_stat;
   time_statistics_t stats_delete;
+  time_statistics_t stats_workflow;
 
+  uint64_t bytes; // the data read and written
   // the maximum time for any single operation
   double max_op_time;
   double phase_start_timer;
@@ -92,6 +118,16 @@ struct benchmark_options{
   int iterations;
   int global_iteration;
   int file_size;
+  char * object_size_distribution;
+  float object_size_sigma; // the shape of the lognormal distribution
+  int object_size_max;
+  char * object_size_file;
+  int object_size_hist_count; // the histogram of the object sizes
+  int * object_size_hist_size;
+  double * object_size_hist_cdf;
+  double object_size_mean;
+  int objects_per_request;
+  int batch; // use the batch operations of the backend for the objects of a request
   int read_only;
   int stonewall_timer;
   int stonewall_timer_wear_out;
@@ -101,6 +137,9 @@ struct benchmark_options{
 
   char * latency_file_prefix;
   int latency_keep_all;
+  float latency_accuracy;
+  char * latency_format_str;
+  int latency_format; // optrace_format_e
 
   int phase_cleanup;
   int phase_precreate;
@@ -126,6 +165,10 @@ struct benchmark_options{
 
   float relative_waiting_factor;
   int adaptive_waiting_mode;
+  int window; // number of object workflows in flight per process
+  float arrival_rate; // open-loop mode: aggregated workflows per second
+  char * arrival_distribution;
+  int arrival_poisson;
 
   uint64_t start_item_number;
 };
@@ -140,6 +183,130 @@ static void def_obj_name(char * out_name, int n, int d, int i){
   sprintf(out_name, "%s/%d_%d/file-%d", o.prefix, n, d, i);
 }
 
+static uint64_t mix64(uint64_t x){
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+/* The size of an object is a deterministic function of its name, hence readers know the size of objects created by others */
+static int object_size(int n, int d, int i){
+  if(o.object_size_hist_count == 0 && o.object_size_sigma == 0){
+    return o.file_size;
+  }
+  uint64_t h = mix64(mix64(mix64(mix64(o.random_seed) ^ n) ^ d) ^ i);
+  double u1 = ((h >> 11) + 0.5) / 9007199254740992.0; // (0, 1)
+  if(o.object_size_hist_count > 0){
+    int lo = 0;
+    int hi = o.object_size_hist_count - 1;
+    while(lo < hi){
+      int mid = (lo + hi) / 2;
+      if(o.object_size_hist_cdf[mid] < u1){
+        lo = mid + 1;
+      }else{
+        hi = mid;
+      }
+    }
+    return o.object_size_hist_size[lo];
+  }
+  // lognormal with median file_size, Box-Muller transform
+  h = mix64(h);
+  double u2 = ((h >> 11) + 0.5) / 9007199254740992.0;
+  double z = sqrt(-2.0 * log(u1)) * cos(2.0 * 3.14159265358979323846 * u2);
+  double size = round(o.file_size * exp(o.object_size_sigma * z));
+  if(size < 1){
+    return 1;
+  }
+  return size > o.object_size_max ? o.object_size_max : (int) size;
+}
+
+static void read_object_size_file(){
+  int count = 0;
+  double total = 0;
+  if(o.rank == 0){
+    FILE * f = fopen(o.object_size_file, "r");
+    if(! f){
+      ERRF("Could not open the object size file %s", o.object_size_file);
+    }
+    char line[1024];
+    int allocated = 0;
+    while(fgets(line, sizeof(line), f)){
+      int size;
+      double weight;
+      if(line[0] == '#' || sscanf(line, "%d %lf", & size, & weight) != 2){
+        continue;
+      }
+      if(size < 1 || weight < 0){
+        ERRF("Invalid entry in the object size file: %s", line);
+      }
+      if(count == allocated){
+        allocated = allocated * 2 + 16;
+        o.object_size_hist_size = realloc(o.object_size_hist_size, allocated * sizeof(int));
+        o.object_size_hist_cdf = realloc(o.object_size_hist_cdf, allocated * sizeof(double));
+      }
+      total += weight;
+      o.object_size_hist_size[count] = size;
+      o.object_size_hist_cdf[count] = total;
+      count++;
+    }
+    fclose(f);
+    if(count == 0 || total <= 0){
+      ERRF("The object size file %s contains no entries", o.object_size_file);
+    }
+  }
+  MPI_Bcast(& count, 1, MPI_INT, 0, o.com);
+  if(o.rank != 0){
+    o.object_size_hist_size = malloc(count * sizeof(int));
+    o.object_size_hist_cdf = malloc(count * sizeof(double));
+  }
+  MPI_Bcast(o.object_size_hist_size, count, MPI_INT, 0, o.com);
+  MPI_Bcast(o.object_size_hist_cdf, count, MPI_DOUBLE, 0, o.com);
+  o.object_size_hist_count = count;
+}
+
+static void object_size_init(){
+  if(o.file_size < 1){
+    ERR("The object size must be at least 1");
+  }
+  o.object_size_max = o.file_size;
+  o.object_size_mean = o.file_size;
+  if(strcmp(o.object_size_distribution, "fixed") == 0){
+    o.object_size_sigma = 0;
+  }else if(strcmp(o.object_size_distribution, "lognormal") == 0){
+    if(o.object_size_sigma <= 0){
+      ERR("The sigma of the lognormal object size distribution must be positive");
+    }
+    o.object_size_max = (int) min(o.file_size * exp(4 * o.object_size_sigma), (double) INT32_MAX);
+    o.object_size_mean = o.file_size * exp(o.object_size_sigma * o.object_size_sigma / 2);
+  }else if(strcmp(o.object_size_distribution, "histogram") == 0){
+    if(! o.object_size_file){
+      ERR("The histogram object size distribution requires --object-size-file");
+    }
+    read_object_size_file();
+    o.object_size_max = 0;
+    o.object_size_mean = 0;
+    double total = o.object_size_hist_cdf[o.object_size_hist_count - 1];
+    double prev = 0;
+    for(int i=0; i < o.object_size_hist_count; i++){
+      o.object_size_max = o.object_size_hist_size[i] > o.object_size_max ? o.object_size_hist_size[i] : o.object_size_max;
+      o.object_size_mean += o.object_size_hist_size[i] * (o.object_size_hist_cdf[i] - prev) / total;
+      prev = o.object_size_hist_cdf[i];
+      o.object_size_hist_cdf[i] /= total;
+    }
+  }else{
+    ERRF("Unknown object size distribution: %s", o.object_size_distribution);
+  }
+}
+
+static void object_size_finalize(){
+  free(o.object_size_hist_size);
+  free(o.object_size_hist_cdf);
+  o.object_size_hist_size = NULL;
+  o.object_size_hist_cdf = NULL;
+  o.object_size_hist_count = 0;
+}
+
 void init_options(){
   o = (struct benchmark_options){
   .interface = "POSIX",
@@ -151,15 +318,106 @@ void init_options(){
   .offset = 1,
   .iterations = 3,
   .file_size = 3901,
+  .object_size_distribution = "fixed",
+  .object_size_sigma = 1.0,
+  .objects_per_request = 1,
   .packetTypeStr = "t",
   .run_info_file = "md-workbench.status",
   .gpuID = -1,
+  .latency_accuracy = 0.01,
+  .window = 1,
+  .arrival_distribution = "poisson",
+  .latency_format_str = "csv",
   };
 }
 
-static void mdw_wait(double runtime){
-  double waittime = runtime * o.relative_waiting_factor;
-  //printf("waittime: %e\n", waittime);
+static int sketch_bins;
+static double sketch_log_gamma;
+static size_t sketch_size;
+static MPI_Datatype sketch_type;
+static MPI_Op sketch_op;
+
+static void sketch_merge(void * in, void * inout, int * len, MPI_Datatype * type){
+  for(int i=0; i < *len; i++){
+    latency_sketch_t * a = (latency_sketch_t *) ((char*) in + i * sketch_size);
+    latency_sketch_t * b = (latency_sketch_t *) ((char*) inout + i * sketch_size);
+    b->count += a->count;
+    b->min = min(a->min, b->min);
+    b->max = a->max > b->max ? a->max : b->max;
+    for(int j=0; j < sketch_bins; j++){
+      b->bins[j] += a->bins[j];
+    }
+  }
+}
+
+static void sketch_init(){
+  if(o.latency_accuracy <= 0 || o.latency_accuracy >= 1){
+    ERR("The latency accuracy must be in the range (0, 1)");
+  }
+  sketch_log_gamma = log((1.0 + o.latency_accuracy) / (1.0 - o.latency_accuracy));
+  sketch_bins = (int) ceil(log(SKETCH_MAX_VALUE / SKETCH_MIN_VALUE) / sketch_log_gamma) + 1;
+  sketch_size = sizeof(latency_sketch_t) + sketch_bins * sizeof(uint64_t);
+  int ret = MPI_Type_contiguous(sketch_size, MPI_BYTE, & sketch_type);
+  CHECK_MPI_RET(ret)
+  ret = MPI_Type_commit(& sketch_type);
+  CHECK_MPI_RET(ret)
+  ret = MPI_Op_create(sketch_merge, 1, & sketch_op);
+  CHECK_MPI_RET(ret)
+}
+
+static void sketch_finalize(){
+  MPI_Op_free(& sketch_op);
+  MPI_Type_free(& sketch_type);
+}
+
+static latency_sketch_t * sketch_alloc(){
+  latency_sketch_t * s = calloc(1, sketch_size);
+  s->min = DBL_MAX;
+  return s;
+}
+
+static void sketch_add(latency_sketch_t * s, double value){
+  int idx = 0;
+  if(value > SKETCH_MIN_VALUE){
+    idx = (int) ceil(log(value / SKETCH_MIN_VALUE) / sketch_log_gamma);
+    idx = min(idx, sketch_bins - 1);
+  }
+  s->bins[idx]++;
+  s->count++;
+  s->min = min(value, s->min);
+  s->max = value > s->max ? value : s->max;
+}
+
+static double sketch_quantile(latency_sketch_t * s, double quantile){
+  uint64_t rank = (uint64_t) (quantile * (s->count - 1) + 0.49);
+  uint64_t cum = 0;
+  for(int i=0; i < sketch_bins; i++){
+    cum += s->bins[i];
+    if(cum > rank){
+      // the representative value of the bucket
+      double value = 2.0 * SKETCH_MIN_VALUE * exp(i * sketch_log_gamma) / (1.0 + exp(sketch_log_gamma));
+      value = value < s->min ? s->min : value;
+      return value > s->max ? s->max : value;
+    }
+  }
+  return s->max;
+}
+
+static void sketch_statistics(latency_sketch_t * s, time_statistics_t * stats){
+  if(s->count == 0){
+    memset(stats, 0, sizeof(time_statistics_t));
+    return;
+  }
+  stats->min = s->min;
+  stats->q1 = sketch_quantile(s, 0.25);
+  stats->median = sketch_quantile(s, 0.5);
+  stats->q3 = sketch_quantile(s, 0.75);
+  stats->q90 = sketch_quantile(s, 0.90);
+  stats->q99 = sketch_quantile(s, 0.99);
+  stats->max = s->max;
+}
+
+static void mdw_sleep(double waittime){
   if(waittime < 0.01){
     double start;
     start = GetTimeStamp();
@@ -176,9 +434,40 @@ static void mdw_wait(double runtime){
   }
 }
 
+static void mdw_wait(double runtime){
+  double waittime = runtime * o.relative_waiting_factor;
+  //printf("waittime: %e\n", waittime);
+  mdw_sleep(waittime);
+}
+
+static uint64_t arrival_rng_state;
+
+/* Time until the next workflow arrives in open-loop mode for this process */
+static double next_interarrival_time(){
+  double rate = o.arrival_rate / o.size;
+  if(! o.arrival_poisson){
+    return 1.0 / rate;
+  }
+  // xorshift64*, exponentially distributed inter-arrival times
+  arrival_rng_state ^= arrival_rng_state >> 12;
+  arrival_rng_state ^= arrival_rng_state << 25;
+  arrival_rng_state ^= arrival_rng_state >> 27;
+  uint64_t r = arrival_rng_state * 2685821657736338717ULL;
+  double u = ((r >> 11) + 1.0) / 9007199254740993.0; // (0, 1]
+  return - log(u) / rate;
+}
+
 static void init_stats(phase_stat_t * p, size_t repeats){
   memset(p, 0, sizeof(phase_stat_t));
   p->repeats = repeats;
+  p->sketch_create = sketch_alloc();
+  p->sketch_read = sketch_alloc();
+  p->sketch_stat = sketch_alloc();
+  p->sketch_delete = sketch_alloc();
+  p->sketch_workflow = sketch_alloc();
+  if(! o.latency_file_prefix){
+    return;
+  }
   size_t timer_size = repeats * sizeof(time_result_t);
   p->time_create = (time_result_t *) malloc(timer_size);
   p->time_read = (time_result_t *) malloc(timer_size);
@@ -186,11 +475,14 @@ static void init_stats(phase_stat_t * p, size_t repeats){
   p->time_delete = (time_result_t *) malloc(timer_size);
 }
 
-static float add_timed_result(double start, double phase_start_timer, time_result_t * results, size_t pos, double * max_time, double * out_op_time){
+static float add_timed_result(double start, double phase_start_timer, time_result_t * results, latency_sketch_t * sketch, size_t pos, double * max_time, double * out_op_time){
   float curtime = start - phase_start_timer;
   double op_time = GetTimeStamp() - start;
-  results[pos].runtime = (float) op_time;
-  results[pos].time_since_app_start = curtime;
+  sketch_add(sketch, op_time);
+  if(results){
+    results[pos].runtime = (float) op_time;
+    results[pos].time_since_app_start = curtime;
+  }
   if (op_time > *max_time){
     *max_time = op_time;
   }
@@ -198,6 +490,18 @@ static float add_timed_result(double start, double phase_start_timer, time_resul
   return curtime;
 }
 
+/* Size of the I/O buffer per process or worker, in batch mode it holds all objects of a request */
+static size_t object_buffer_stride(){
+  return ((size_t) o.object_size_max + 4095) / 4096 * 4096;
+}
+
+static size_t object_buffer_size(){
+  if(o.batch){
+    return object_buffer_stride() * o.objects_per_request;
+  }
+  return o.object_size_max;
+}
+
 static void print_detailed_stat_header(){
     printf("phase\t\td name\tcreate\tdelete\tob nam\tcreate\tread\tstat\tdelete\tt_inc_b\tt_no_bar\tthp\tmax_t\n");
 }
@@ -235,7 +539,7 @@ static void statistics_minmax(int count, double * arr, double * out_min, double
 }
 
 static void print_p_stat(char * buff, const char * name, phase_stat_t * p, double t, int print_global){
-  const double tp = (double)(p->obj_create.suc + p->obj_read.suc) * o.file_size / t / 1024 / 1024;
+  const double tp = (double) p->bytes / t / 1024 / 1024;
 
   const int errs = sum_err(p);
   double r_min = 0;
@@ -283,6 +587,14 @@ static void print_p_stat(char * buff, const char * name, phase_stat_t * p, doubl
         if(o.relative_waiting_factor > 1e-9){
           pos += sprintf(buff + pos, " waiting_factor:%.2f", o.relative_waiting_factor);
         }
+        if(o.window > 1){
+          pos += sprintf(buff + pos, " window:%d", o.window);
+        }
+        if(o.arrival_rate > 0){
+          /* the arrival rate is in requests, each request processes objects_per_request objects */
+          double offered = print_global ? o.arrival_rate : o.arrival_rate / o.size;
+          pos += sprintf(buff + pos, " offered:%.1f req/s (%.1f obj/s)", offered, offered * o.objects_per_request);
+        }
         break;
       case('p'):
         rate = (p->dset_create.suc + p->obj_create.suc) / t;
@@ -348,19 +660,13 @@ static void print_p_stat(char * buff, const char * name, phase_stat_t * p, doubl
       time_statistics_t stat = p->stats_delete;
       pos += sprintf(buff + pos, " delete(%.4es, %.4es, %.4es, %.4es, %.4es, %.4es, %.4es)", stat.min, stat.q1, stat.median, stat.q3, stat.q90, stat.q99, stat.max);
     }
+    if(p->stats_workflow.max > 1e-9){
+      time_statistics_t stat = p->stats_workflow;
+      pos += sprintf(buff + pos, " workflow(%.4es, %.4es, %.4es, %.4es, %.4es, %.4es, %.4es)", stat.min, stat.q1, stat.median, stat.q3, stat.q90, stat.q99, stat.max);
+    }
   }
 }
 
-static int compare_floats(time_result_t * x, time_result_t * y){
-  return x->runtime < y->runtime ? -1 : (x->runtime > y->runtime ? +1 : 0);
-}
-
-static double runtime_quantile(int repeats, time_result_t * times, float quantile){
-  int pos = round(quantile * (repeats - 1) + 0.49);
-  assert(pos < repeats);
-  return times[pos].runtime;
-}
-
 static uint64_t aggregate_timers(int repeats, int max_repeats, time_result_t * times, time_result_t * global_times){
   uint64_t count = 0;
   int ret;
@@ -384,34 +690,62 @@ static uint64_t aggregate_timers(int repeats, int max_repeats, time_result_t * t
   return count;
 }
 
-static void compute_histogram(const char * name, time_result_t * times, time_statistics_t * stats, size_t repeats, int writeLatencyFile){
-  if(writeLatencyFile && o.latency_file_prefix ){
-    char file[MAX_PATHLEN];
-    sprintf(file, "%s-%.2f-%d-%s.csv", o.latency_file_prefix, o.relative_waiting_factor, o.global_iteration, name);
-    FILE * f = fopen(file, "w+");
-    if(f == NULL){
-      ERRF("%d: Error writing to latency file: %s", o.rank, file);
-      return;
-    }
-    fprintf(f, "time,runtime\n");
+static void write_latency_file(const char * name, time_result_t * times, size_t repeats){
+  char file[MAX_PATHLEN];
+  sprintf(file, "%s-%.2f-%d-%s.%s", o.latency_file_prefix, o.relative_waiting_factor, o.global_iteration, name, optrace_format_suffix(o.latency_format));
+  if(o.latency_format != OPTRACE_FORMAT_CSV){
+    OpTimer * ot = OpTimerInit(file, 0, o.latency_format);
     for(size_t i = 0; i < repeats; i++){
-      fprintf(f, "%.7f,%.4e\n", times[i].time_since_app_start, times[i].runtime);
+      OpTimerRecord(ot, 0, times[i].time_since_app_start, times[i].runtime, 0, -1);
     }
-    fclose(f);
+    OpTimerFree(& ot);
+    return;
   }
-  // now sort the times and pick the quantiles
-  qsort(times, repeats, sizeof(time_result_t), (int (*)(const void *, const void *)) compare_floats);
-  stats->min = times[0].runtime;
-  stats->q1 = runtime_quantile(repeats, times, 0.25);
-  if(repeats % 2 == 0){
-    stats->median = (times[repeats/2].runtime + times[repeats/2 - 1].runtime)/2.0;
-  }else{
-    stats->median = times[repeats/2].runtime;
+  FILE * f = fopen(file, "w+");
+  if(f == NULL){
+    ERRF("%d: Error writing to latency file: %s", o.rank, file);
+    return;
+  }
+  fprintf(f, "time,runtime\n");
+  for(size_t i = 0; i < repeats; i++){
+    fprintf(f, "%.7f,%.4e\n", times[i].time_since_app_start, times[i].runtime);
+  }
+  fclose(f);
+}
+
+/*
+ Compute the local and global latency statistics of one operation type from the sketches.
+ The raw latencies are only communicated when all of them shall be stored in a latency file.
+ */
+static void compute_histogram(const char * name, phase_stat_t * p, int max_repeats, time_result_t * times, latency_sketch_t * sketch, time_statistics_t * stats, time_statistics_t * global_stats){
+  int ret;
+  char all_name[MAX_PATHLEN];
+  sprintf(all_name, "%s-all", name);
+
+  if(o.latency_file_prefix && times){
+    if(o.latency_keep_all){
+      time_result_t * global_times = NULL;
+      if(o.rank == 0){
+        global_times = malloc(sizeof(time_result_t) * (size_t) max_repeats * o.size);
+      }
+      uint64_t repeats = aggregate_timers(p->repeats, max_repeats, times, global_times);
+      if(o.rank == 0){
+        write_latency_file(all_name, global_times, repeats);
+        free(global_times);
+      }
+    }else if(o.rank == 0){
+      write_latency_file(name, times, p->repeats);
+    }
+  }
+  sketch_statistics(sketch, stats);
+
+  latency_sketch_t * global_sketch = o.rank == 0 ? sketch_alloc() : NULL;
+  ret = MPI_Reduce(sketch, global_sketch, 1, sketch_type, sketch_op, 0, o.com);
+  CHECK_MPI_RET(ret)
+  if(o.rank == 0){
+    sketch_statistics(global_sketch, global_stats);
+    free(global_sketch);
   }
-  stats->q3 = runtime_quantile(repeats, times, 0.75);
-  stats->q90 = runtime_quantile(repeats, times, 0.90);
-  stats->q99 = runtime_quantile(repeats, times, 0.99);
-  stats->max = times[repeats - 1].runtime;
 }
 
 static void end_phase(const char * name, phase_stat_t * p){
@@ -428,7 +762,7 @@ static void end_phase(const char * name, phase_stat_t * p){
 
   // prepare the summarized report
   phase_stat_t g_stat;
-  init_stats(& g_stat, (o.rank == 0 ? 1 : 0) * ((size_t) max_repeats) * o.size);
+  memset(& g_stat, 0, sizeof(g_stat));
   // reduce timers
   ret = MPI_Reduce(& p->t, & g_stat.t, 2, MPI_DOUBLE, MPI_MAX, 0, o.com);
   CHECK_MPI_RET(ret)
@@ -441,50 +775,27 @@ static void end_phase(const char * name, phase_stat_t * p){
   CHECK_MPI_RET(ret)
   ret = MPI_Reduce(& p->max_op_time, & g_stat.max_op_time, 1, MPI_DOUBLE, MPI_MAX, 0, o.com);
   CHECK_MPI_RET(ret)
+  ret = MPI_Reduce(& p->bytes, & g_stat.bytes, 1, MPI_UINT64_T, MPI_SUM, 0, o.com);
+  CHECK_MPI_RET(ret)
   if( p->stonewall_iterations ){
     ret = MPI_Reduce(& p->repeats, & g_stat.repeats, 1, MPI_UINT64_T, MPI_MIN, 0, o.com);
     CHECK_MPI_RET(ret)
     g_stat.stonewall_iterations = p->stonewall_iterations;
   }
-  int write_rank0_latency_file = (o.rank == 0) && ! o.latency_keep_all;
 
   if(strcmp(name,"precreate") == 0){
-    uint64_t repeats = aggregate_timers(p->repeats, max_repeats, p->time_create, g_stat.time_create);
-    if(o.rank == 0){
-      compute_histogram("precreate-all", g_stat.time_create, & g_stat.stats_create, repeats, o.latency_keep_all);
-    }
-    compute_histogram("precreate", p->time_create, & p->stats_create, p->repeats, write_rank0_latency_file);
+    compute_histogram("precreate", p, max_repeats, p->time_create, p->sketch_create, & p->stats_create, & g_stat.stats_create);
   }else if(strcmp(name,"cleanup") == 0){
-    uint64_t repeats = aggregate_timers(p->repeats, max_repeats, p->time_delete, g_stat.time_delete);
-    if(o.rank == 0) {
-      compute_histogram("cleanup-all", g_stat.time_delete, & g_stat.stats_delete, repeats, o.latency_keep_all);
-    }
-    compute_histogram("cleanup", p->time_delete, & p->stats_delete, p->repeats, write_rank0_latency_file);
+    compute_histogram("cleanup", p, max_repeats, p->time_delete, p->sketch_delete, & p->stats_delete, & g_stat.stats_delete);
   }else if(strcmp(name,"benchmark") == 0){
-    uint64_t repeats = aggregate_timers(p->repeats, max_repeats, p->time_read, g_stat.time_read);
-    if(o.rank == 0) {
-      compute_histogram("read-all", g_stat.time_read, & g_stat.stats_read, repeats, o.latency_keep_all);
-    }
-    compute_histogram("read", p->time_read, & p->stats_read, p->repeats, write_rank0_latency_file);
-
-    repeats = aggregate_timers(p->repeats, max_repeats, p->time_stat, g_stat.time_stat);
-    if(o.rank == 0) {
-      compute_histogram("stat-all", g_stat.time_stat, & g_stat.stats_stat, repeats, o.latency_keep_all);
-    }
-    compute_histogram("stat", p->time_stat, & p->stats_stat, p->repeats, write_rank0_latency_file);
-
+    compute_histogram("read", p, max_repeats, p->time_read, p->sketch_read, & p->stats_read, & g_stat.stats_read);
+    compute_histogram("stat", p, max_repeats, p->time_stat, p->sketch_stat, & p->stats_stat, & g_stat.stats_stat);
     if(! o.read_only){
-      repeats = aggregate_timers(p->repeats, max_repeats, p->time_create, g_stat.time_create);
-      if(o.rank == 0) {
-        compute_histogram("create-all", g_stat.time_create, & g_stat.stats_create, repeats, o.latency_keep_all);
-      }
-      compute_histogram("create", p->time_create, & p->stats_create, p->repeats, write_rank0_latency_file);
-
-      repeats = aggregate_timers(p->repeats, max_repeats, p->time_delete, g_stat.time_delete);
-      if(o.rank == 0) {
-        compute_histogram("delete-all", g_stat.time_delete, & g_stat.stats_delete, repeats, o.latency_keep_all);
-      }
-      compute_histogram("delete", p->time_delete, & p->stats_delete, p->repeats, write_rank0_latency_file);
+      compute_histogram("create", p, max_repeats, p->time_create, p->sketch_create, & p->stats_create, & g_stat.stats_create);
+      compute_histogram("delete", p, max_repeats, p->time_delete, p->sketch_delete, & p->stats_delete, & g_stat.stats_delete);
+    }
+    if(o.arrival_rate > 0 || o.objects_per_request > 1){
+      compute_histogram("workflow", p, max_repeats, NULL, p->sketch_workflow, & p->stats_workflow, & g_stat.stats_workflow);
     }
   }
 
@@ -517,12 +828,11 @@ static void end_phase(const char * name, phase_stat_t * p){
     free(p->time_stat);
     free(p->time_delete);
   }
-  if(g_stat.time_create){
-    free(g_stat.time_create);
-    free(g_stat.time_read);
-    free(g_stat.time_stat);
-    free(g_stat.time_delete);
-  }
+  free(p->sketch_create);
+  free(p->sketch_read);
+  free(p->sketch_stat);
+  free(p->sketch_delete);
+  free(p->sketch_workflow);
 
   // copy the result back for the API
   mdworkbench_result_t * res = & o.results->result[o.results->count];
@@ -530,6 +840,7 @@ static void end_phase(const char * name, phase_stat_t * p){
   memcpy(& res->stats_read, & g_stat.stats_read, sizeof(time_statistics_t));
   memcpy(& res->stats_stat, & g_stat.stats_stat, sizeof(time_statistics_t));
   memcpy(& res->stats_delete, & g_stat.stats_delete, sizeof(time_statistics_t));
+  memcpy(& res->stats_workflow, & g_stat.stats_workflow, sizeof(time_statistics_t));
 
   o.results->count++;
 
@@ -560,8 +871,9 @@ void run_precreate(phase_stat_t * s, int current_index){
     }
   }
 
-  char * buf = aligned_buffer_alloc(o.file_size, o.gpuMemoryFlags);
-  generate_memory_pattern(buf, o.file_size, o.random_seed, o.rank, o.dataPacketType, o.gpuMemoryFlags);
+  char * buf = aligned_buffer_alloc(o.object_size_max, o.gpuMemoryFlags);
+  generate_memory_pattern(buf, o.object_size_max, o.random_seed, o.rank, o.dataPacketType, o.gpuMemoryFlags);
+  int pattern_size = o.object_size_max;
   double op_timer; // timer for individual operations
   size_t pos = -1; // position inside the individual measurement array
   double op_time;
@@ -571,15 +883,22 @@ void run_precreate(phase_stat_t * s, int current_index){
     for(int d=0; d < o.dset_count; d++){
       pos++;
       def_obj_name(obj_name, o.rank, d, f);
+      const int size = object_size(o.rank, d, f);
+      if(size != pattern_size){
+        // the pattern of the trailing bytes depends on the size
+        generate_memory_pattern(buf, size, o.random_seed, o.rank, o.dataPacketType, o.gpuMemoryFlags);
+        pattern_size = size;
+      }
 
       op_timer = GetTimeStamp();
       aiori_fd_t * aiori_fh = o.backend->create(obj_name, IOR_WRONLY | IOR_CREAT, o.backend_options);
       if (NULL == aiori_fh){
         FAIL("Unable to open file %s", obj_name);
       }
-      update_write_memory_pattern(f * o.dset_count + d, buf, o.file_size, o.random_seed, o.rank, o.dataPacketType, o.gpuMemoryFlags);
-      if ( o.file_size == (int) o.backend->xfer(WRITE, aiori_fh, (IOR_size_t *) buf, o.file_size, 0, o.backend_options)) {
+      update_write_memory_pattern(f * o.dset_count + d, buf, size, o.random_seed, o.rank, o.dataPacketType, o.gpuMemoryFlags);
+      if ( size == (int) o.backend->xfer(WRITE, aiori_fh, (IOR_size_t *) buf, size, 0, o.backend_options)) {
         s->obj_create.suc++;
+        s->bytes += size;
       }else{
         s->obj_create.err++;
         if (! o.ignore_precreate_errors){
@@ -588,7 +907,7 @@ void run_precreate(phase_stat_t * s, int current_index){
       }
       o.backend->close(aiori_fh, o.backend_options);
 
-      add_timed_result(op_timer, s->phase_start_timer, s->time_create, pos, & s->max_op_time, & op_time);
+      add_timed_result(op_timer, s->phase_start_timer, s->time_create, s->sketch_create, pos, & s->max_op_time, & op_time);
 
       if (o.verbosity >= 2){
         oprintf("%d: write %s:%s (%d) pretend: %d\n", o.rank, dset, obj_name, ret, o.rank);
@@ -598,135 +917,512 @@ void run_precreate(phase_stat_t * s, int current_index){
   aligned_buffer_free(buf, o.gpuMemoryFlags);
 }
 
-/* FIFO: create a new file, write to it. Then read from the first created file, delete it... */
-void run_benchmark(phase_stat_t * s, int * current_index_p){
+/* Stat and read the oldest object of the data set, @return 0 if the object exists */
+static int run_benchmark_get(phase_stat_t * s, char * buf, int f, int d, int start_index, size_t pos, float * bench_runtime){
   char obj_name[MAX_PATHLEN];
   int ret;
-  char * buf = aligned_buffer_alloc(o.file_size, o.gpuMemoryFlags);
-  invalidate_buffer_pattern(buf, o.file_size, o.gpuMemoryFlags);
   double op_timer; // timer for individual operations
-  size_t pos = -1; // position inside the individual measurement array
-  int start_index = *current_index_p;
-  int total_num = o.num;
-  int armed_stone_wall = (o.stonewall_timer > 0);
-  int f;
-  double phase_allreduce_time = 0;
   aiori_fd_t * aiori_fh;
+  double op_time;
+  struct stat stat_buf;
+  const int prevFile = f + start_index;
 
-  for(f=0; f < total_num; f++){
-    float bench_runtime = 0; // the time since start
-    for(int d=0; d < o.dset_count; d++){
-      double op_time;
-      struct stat stat_buf;
-      const int prevFile = f + start_index;
-      pos++;
-
-      int readRank = (o.rank - o.offset * (d+1)) % o.size;
-      readRank = readRank < 0 ? readRank + o.size : readRank;
-      def_obj_name(obj_name, readRank, d, prevFile);
+  int readRank = (o.rank - o.offset * (d+1)) % o.size;
+  readRank = readRank < 0 ? readRank + o.size : readRank;
+  def_obj_name(obj_name, readRank, d, prevFile);
+  const int size = object_size(readRank, d, prevFile);
 
-      op_timer = GetTimeStamp();
+  op_timer = GetTimeStamp();
 
-      ret = o.backend->stat(obj_name, & stat_buf, o.backend_options);
-      // TODO potentially check return value must be identical to o.file_size
+  ret = o.backend->stat(obj_name, & stat_buf, o.backend_options);
+  // TODO potentially check return value must be identical to o.file_size
 
-      bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_stat, pos, & s->max_op_time, & op_time);
-      if(o.relative_waiting_factor > 1e-9) {
-        mdw_wait(op_time);
-      }
+  *bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_stat, s->sketch_stat, pos, & s->max_op_time, & op_time);
+  if(o.relative_waiting_factor > 1e-9) {
+    mdw_wait(op_time);
+  }
 
-      if (o.verbosity >= 2){
-        oprintf("%d: stat %s (%d)\n", o.rank, obj_name, ret);
-      }
+  if (o.verbosity >= 2){
+    oprintf("%d: stat %s (%d)\n", o.rank, obj_name, ret);
+  }
 
-      if(ret != 0){
-        if (o.verbosity)
-          ERRF("%d: Error while stating the obj: %s", o.rank, obj_name);
-        s->obj_stat.err++;
-        continue;
-      }
-      s->obj_stat.suc++;
+  if(ret != 0){
+    if (o.verbosity)
+      ERRF("%d: Error while stating the obj: %s", o.rank, obj_name);
+    s->obj_stat.err++;
+    return 1;
+  }
+  s->obj_stat.suc++;
 
-      if (o.verbosity >= 2){
-        oprintf("%d: read %s pretend: %d\n", o.rank, obj_name, readRank);
-      }
+  if (o.verbosity >= 2){
+    oprintf("%d: read %s pretend: %d\n", o.rank, obj_name, readRank);
+  }
 
-      op_timer = GetTimeStamp();
-      aiori_fh = o.backend->open(obj_name, IOR_RDONLY, o.backend_options);
-      if (NULL == aiori_fh){
-        FAIL("Unable to open file %s", obj_name);
-      }
-      if ( o.file_size == (int) o.backend->xfer(READ, aiori_fh, (IOR_size_t *) buf, o.file_size, 0, o.backend_options) ) {
-        if(o.verify_read){
-            if(verify_memory_pattern(prevFile * o.dset_count + d, buf, o.file_size, o.random_seed, readRank, o.dataPacketType, o.gpuMemoryFlags) == 0){
-              s->obj_read.suc++;
-            }else{
-              s->obj_read.err++;
-            }
-        }else{
+  op_timer = GetTimeStamp();
+  aiori_fh = o.backend->open(obj_name, IOR_RDONLY, o.backend_options);
+  if (NULL == aiori_fh){
+    FAIL("Unable to open file %s", obj_name);
+  }
+  if ( size == (int) o.backend->xfer(READ, aiori_fh, (IOR_size_t *) buf, size, 0, o.backend_options) ) {
+    s->bytes += size;
+    if(o.verify_read){
+        if(verify_memory_pattern(prevFile * o.dset_count + d, buf, size, o.random_seed, readRank, o.dataPacketType, o.gpuMemoryFlags) == 0){
           s->obj_read.suc++;
+        }else{
+          s->obj_read.err++;
         }
-      }else{
-        s->obj_read.err++;
-        WARNF("%d: Error while reading the obj: %s", o.rank, obj_name);
-      }
-      o.backend->close(aiori_fh, o.backend_options);
+    }else{
+      s->obj_read.suc++;
+    }
+  }else{
+    s->obj_read.err++;
+    WARNF("%d: Error while reading the obj: %s", o.rank, obj_name);
+  }
+  o.backend->close(aiori_fh, o.backend_options);
 
-      bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_read, pos, & s->max_op_time, & op_time);
-      if(o.relative_waiting_factor > 1e-9) {
-        mdw_wait(op_time);
-      }
-      if(o.read_only){
-        continue;
-      }
+  *bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_read, s->sketch_read, pos, & s->max_op_time, & op_time);
+  if(o.relative_waiting_factor > 1e-9) {
+    mdw_wait(op_time);
+  }
+  return 0;
+}
 
-      op_timer = GetTimeStamp();
-      o.backend->remove(obj_name, o.backend_options);
-      bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_delete, pos, & s->max_op_time, & op_time);
-      if(o.relative_waiting_factor > 1e-9) {
-        mdw_wait(op_time);
-      }
+/* Delete the object read before and create a new object in the data set */
+static void run_benchmark_put(phase_stat_t * s, char * buf, int f, int d, int start_index, size_t pos, float * bench_runtime){
+  char obj_name[MAX_PATHLEN];
+  int ret = 0;
+  double op_timer; // timer for individual operations
+  aiori_fd_t * aiori_fh;
+  double op_time;
+  const int prevFile = f + start_index;
 
-      if (o.verbosity >= 2){
-        oprintf("%d: delete %s\n", o.rank, obj_name);
+  int readRank = (o.rank - o.offset * (d+1)) % o.size;
+  readRank = readRank < 0 ? readRank + o.size : readRank;
+  def_obj_name(obj_name, readRank, d, prevFile);
+
+
+  op_timer = GetTimeStamp();
+  o.backend->remove(obj_name, o.backend_options);
+  *bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_delete, s->sketch_delete, pos, & s->max_op_time, & op_time);
+  if(o.relative_waiting_factor > 1e-9) {
+    mdw_wait(op_time);
+  }
+
+  if (o.verbosity >= 2){
+    oprintf("%d: delete %s\n", o.rank, obj_name);
+  }
+  s->obj_delete.suc++;
+
+  int writeRank = (o.rank + o.offset * (d+1)) % o.size;
+  const int newFileIndex = o.precreate + prevFile;
+  def_obj_name(obj_name, writeRank, d, newFileIndex);
+  const int size = object_size(writeRank, d, newFileIndex);
+
+  op_timer = GetTimeStamp();
+  aiori_fh = o.backend->create(obj_name, IOR_WRONLY | IOR_CREAT, o.backend_options);
+  if (NULL != aiori_fh){
+    generate_memory_pattern(buf, size, o.random_seed, writeRank, o.dataPacketType, o.gpuMemoryFlags);
+    update_write_memory_pattern(newFileIndex * o.dset_count + d, buf, size, o.random_seed, writeRank, o.dataPacketType, o.gpuMemoryFlags);
+    
+    if ( size == (int) o.backend->xfer(WRITE, aiori_fh, (IOR_size_t *) buf, size, 0, o.backend_options)) {
+      s->obj_create.suc++;
+      s->bytes += size;
+    }else{
+      s->obj_create.err++;
+      if (! o.ignore_precreate_errors){
+        ERRF("%d: Error while creating the obj: %s\n", o.rank, obj_name);
       }
+    }
+    o.backend->close(aiori_fh, o.backend_options);
+  }else{
+    if (! o.ignore_precreate_errors){
+     ERRF("%d: Error while creating the obj: %s", o.rank, obj_name);
+    }
+    WARNF("Unable to open file %s", obj_name);
+    s->obj_create.err++;
+  }
+  *bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_create, s->sketch_create, pos, & s->max_op_time, & op_time);
+  if(o.relative_waiting_factor > 1e-9) {
+    mdw_wait(op_time);
+  }
+
+  if (o.verbosity >= 2){
+    oprintf("%d: write %s (%d) pretend: %d\n", o.rank, obj_name, ret, writeRank);
+  }
+}
+
+/*
+ Process the objects of a request with the batch operations of the backend:
+ stat each object, read all existing objects with one batch, delete them with one batch and create the new objects with one batch.
+ The latency of a batch is accounted for each of its objects.
+ */
+static void run_benchmark_batch(phase_stat_t * s, char * buf, int f, int first_dset, int count, int start_index, size_t pos, float * bench_runtime){
+  const size_t stride = object_buffer_stride();
+  const int prevFile = f + start_index;
+  const int newFileIndex = o.precreate + prevFile;
+  char * names[count];
+  IOR_size_t * buffers[count];
+  IOR_offset_t sizes[count];
+  int status[count];
+  int ranks[count];
+  int dsets[count];
+  double op_timer;
+  double op_time = 0;
+  int n = 0;
+
+  char * name_buf = malloc(MAX_PATHLEN * count);
+  for(int i=0; i < count; i++){
+    const int d = first_dset + i;
+    int readRank = (o.rank - o.offset * (d+1)) % o.size;
+    readRank = readRank < 0 ? readRank + o.size : readRank;
+    names[n] = name_buf + MAX_PATHLEN * n;
+    def_obj_name(names[n], readRank, d, prevFile);
+
+    struct stat stat_buf;
+    op_timer = GetTimeStamp();
+    int ret = o.backend->stat(names[n], & stat_buf, o.backend_options);
+    *bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_stat, s->sketch_stat, pos + i, & s->max_op_time, & op_time);
+    if (o.verbosity >= 2){
+      oprintf("%d: stat %s (%d)\n", o.rank, names[n], ret);
+    }
+    if(ret != 0){
+      if (o.verbosity)
+        ERRF("%d: Error while stating the obj: %s", o.rank, names[n]);
+      s->obj_stat.err++;
+      continue;
+    }
+    s->obj_stat.suc++;
+    buffers[n] = (IOR_size_t *) (buf + stride * n);
+    sizes[n] = object_size(readRank, d, prevFile);
+    ranks[n] = readRank;
+    dsets[n] = d;
+    n++;
+  }
+  if(o.relative_waiting_factor > 1e-9) {
+    mdw_wait(op_time);
+  }
+  if(n == 0){
+    free(name_buf);
+    return;
+  }
+
+  op_timer = GetTimeStamp();
+  aiori_get_batch(o.backend, n, names, buffers, sizes, status, o.backend_options);
+  for(int i=0; i < n; i++){
+    *bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_read, s->sketch_read, pos + dsets[i] - first_dset, & s->max_op_time, & op_time);
+    if(status[i] != 0){
+      s->obj_read.err++;
+      WARNF("%d: Error while reading the obj: %s", o.rank, names[i]);
+      continue;
+    }
+    s->bytes += sizes[i];
+    if(o.verify_read && verify_memory_pattern(prevFile * o.dset_count + dsets[i], (char*) buffers[i], sizes[i], o.random_seed, ranks[i], o.dataPacketType, o.gpuMemoryFlags) != 0){
+      s->obj_read.err++;
+    }else{
+      s->obj_read.suc++;
+    }
+  }
+  if(o.relative_waiting_factor > 1e-9) {
+    mdw_wait(op_time);
+  }
+  if(o.read_only){
+    free(name_buf);
+    return;
+  }
+
+  op_timer = GetTimeStamp();
+  aiori_remove_batch(o.backend, n, names, status, o.backend_options);
+  for(int i=0; i < n; i++){
+    *bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_delete, s->sketch_delete, pos + dsets[i] - first_dset, & s->max_op_time, & op_time);
+    if(status[i] == 0){
       s->obj_delete.suc++;
+    }else{
+      s->obj_delete.err++;
+    }
+  }
+  if(o.relative_waiting_factor > 1e-9) {
+    mdw_wait(op_time);
+  }
 
-      int writeRank = (o.rank + o.offset * (d+1)) % o.size;
-      const int newFileIndex = o.precreate + prevFile;
-      def_obj_name(obj_name, writeRank, d, newFileIndex);
+  for(int i=0; i < n; i++){
+    const int d = dsets[i];
+    const int writeRank = (o.rank + o.offset * (d+1)) % o.size;
+    def_obj_name(names[i], writeRank, d, newFileIndex);
+    sizes[i] = object_size(writeRank, d, newFileIndex);
+    generate_memory_pattern((char*) buffers[i], sizes[i], o.random_seed, writeRank, o.dataPacketType, o.gpuMemoryFlags);
+    update_write_memory_pattern(newFileIndex * o.dset_count + d, (char*) buffers[i], sizes[i], o.random_seed, writeRank, o.dataPacketType, o.gpuMemoryFlags);
+  }
+  op_timer = GetTimeStamp();
+  aiori_put_batch(o.backend, n, names, buffers, sizes, status, o.backend_options);
+  for(int i=0; i < n; i++){
+    *bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_create, s->sketch_create, pos + dsets[i] - first_dset, & s->max_op_time, & op_time);
+    if(status[i] == 0){
+      s->obj_create.suc++;
+      s->bytes += sizes[i];
+    }else{
+      s->obj_create.err++;
+      if (! o.ignore_precreate_errors){
+        ERRF("%d: Error while creating the obj: %s", o.rank, names[i]);
+      }
+    }
+    if (o.verbosity >= 2){
+      oprintf("%d: write %s (%d)\n", o.rank, names[i], status[i]);
+    }
+  }
+  if(o.relative_waiting_factor > 1e-9) {
+    mdw_wait(op_time);
+  }
+  free(name_buf);
+}
 
-      op_timer = GetTimeStamp();
-      aiori_fh = o.backend->create(obj_name, IOR_WRONLY | IOR_CREAT, o.backend_options);
-      if (NULL != aiori_fh){
-        generate_memory_pattern(buf, o.file_size, o.random_seed, writeRank, o.dataPacketType, o.gpuMemoryFlags);
-        update_write_memory_pattern(newFileIndex * o.dset_count + d, buf, o.file_size, o.random_seed, writeRank, o.dataPacketType, o.gpuMemoryFlags);
-        
-        if ( o.file_size == (int) o.backend->xfer(WRITE, aiori_fh, (IOR_size_t *) buf, o.file_size, 0, o.backend_options)) {
-          s->obj_create.suc++;
-        }else{
-          s->obj_create.err++;
-          if (! o.ignore_precreate_errors){
-            ERRF("%d: Error while creating the obj: %s\n", o.rank, obj_name);
-          }
-        }
-        o.backend->close(aiori_fh, o.backend_options);
-      }else{
-        if (! o.ignore_precreate_errors){
-         ERRF("%d: Error while creating the obj: %s", o.rank, obj_name);
+/*
+ Process one logical request on up to o.objects_per_request objects of the iteration f:
+ first stat and read all objects (multi-get), then delete them and create the new objects (multi-put).
+ The operations on each object remain ordered.
+ */
+static float run_benchmark_request(phase_stat_t * s, char * buf, size_t request, int start_index, double arrival){
+  const int requests_per_iteration = (o.dset_count + o.objects_per_request - 1) / o.objects_per_request;
+  const int f = request / requests_per_iteration;
+  const int first_dset = (request % requests_per_iteration) * o.objects_per_request;
+  const int count = min(o.objects_per_request, o.dset_count - first_dset);
+  const size_t pos = (size_t) f * o.dset_count + first_dset; // position inside the individual measurement array
+  float bench_runtime = 0; // the time since start
+  int exists[count];
+  double start = GetTimeStamp();
+
+  if(o.batch){
+    run_benchmark_batch(s, buf, f, first_dset, count, start_index, pos, & bench_runtime);
+  }else{
+    for(int i=0; i < count; i++){
+      exists[i] = run_benchmark_get(s, buf, f, first_dset + i, start_index, pos + i, & bench_runtime) == 0;
+    }
+    if(! o.read_only){
+      for(int i=0; i < count; i++){
+        if(exists[i]){
+          run_benchmark_put(s, buf, f, first_dset + i, start_index, pos + i, & bench_runtime);
         }
-        WARNF("Unable to open file %s", obj_name);
-        s->obj_create.err++;
-      }
-      bench_runtime = add_timed_result(op_timer, s->phase_start_timer, s->time_create, pos, & s->max_op_time, & op_time);
-      if(o.relative_waiting_factor > 1e-9) {
-        mdw_wait(op_time);
       }
+    }
+  }
+  // the latency of the request, in open-loop mode since the scheduled arrival
+  if(arrival > 0){
+    sketch_add(s->sketch_workflow, GetTimeStamp() - arrival);
+  }else if(o.objects_per_request > 1){
+    sketch_add(s->sketch_workflow, GetTimeStamp() - start);
+  }
+  return bench_runtime;
+}
 
-      if (o.verbosity >= 2){
-        oprintf("%d: write %s (%d) pretend: %d\n", o.rank, obj_name, ret, writeRank);
+/*
+ The windowed mode keeps up to o.window object workflows in flight per process.
+ Each workflow is executed by one worker thread. A workflow reads and deletes the objects created by the workflow
+ o.precreate iterations earlier, so it only starts once that one has completed and the operations on an object remain ordered.
+ This ordering is per process only: the objects of a dataset are created by another rank, which is not waited for,
+ as in the serial mode a rank that lags more than o.precreate iterations behind its readers causes failed reads.
+ Workers account their operations into a private phase_stat_t that is merged at the end.
+ Errors in workers abort via MPI, hence the windowed mode requires MPI_THREAD_MULTIPLE.
+ */
+typedef struct{
+  pthread_t thread;
+  struct mdw_pipeline * pipe;
+  phase_stat_t stat;
+  char * buf;
+} mdw_worker_t;
+
+typedef struct mdw_pipeline{
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  phase_stat_t * s;
+  int start_index;
+  size_t submitted; // the workflows [0, submitted) can be processed
+  size_t taken;
+  size_t completed; // all workflows [0, completed) are completed
+  size_t dependency; // distance to the workflow that created the objects used by a workflow
+  int done; // no further workflow will be submitted
+  float bench_runtime; // the maximum time since start of any completed workflow
+  double * arrivals; // scheduled arrival of the workflows in open-loop mode, indexed by item % window
+  char * finished; // the workflow is completed, indexed by item % window
+  mdw_worker_t * workers;
+} mdw_pipeline_t;
+
+static void * pipeline_worker(void * arg){
+  mdw_worker_t * w = (mdw_worker_t *) arg;
+  mdw_pipeline_t * p = w->pipe;
+  while(1){
+    pthread_mutex_lock(& p->lock);
+    while(p->taken == p->submitted && ! p->done){
+      pthread_cond_wait(& p->cond, & p->lock);
+    }
+    if(p->taken == p->submitted){
+      pthread_mutex_unlock(& p->lock);
+      return NULL;
+    }
+    size_t item = p->taken++;
+    double arrival = p->arrivals[item % o.window];
+    while(p->dependency > 0 && item >= p->dependency && p->completed <= item - p->dependency){
+      pthread_cond_wait(& p->cond, & p->lock);
+    }
+    w->stat.phase_start_timer = p->s->phase_start_timer;
+    pthread_mutex_unlock(& p->lock);
+
+    float runtime = run_benchmark_request(& w->stat, w->buf, item, p->start_index, arrival);
+
+    pthread_mutex_lock(& p->lock);
+    p->finished[item % o.window] = 1;
+    while(p->completed < p->taken && p->finished[p->completed % o.window]){
+      p->finished[p->completed % o.window] = 0;
+      p->completed++;
+    }
+    if(runtime > p->bench_runtime){
+      p->bench_runtime = runtime;
+    }
+    pthread_cond_broadcast(& p->cond);
+    pthread_mutex_unlock(& p->lock);
+  }
+}
+
+static mdw_pipeline_t * pipeline_start(phase_stat_t * s, int start_index){
+  mdw_pipeline_t * p = calloc(1, sizeof(mdw_pipeline_t));
+  pthread_mutex_init(& p->lock, NULL);
+  pthread_cond_init(& p->cond, NULL);
+  p->s = s;
+  p->start_index = start_index;
+  p->dependency = (size_t) o.precreate * ((o.dset_count + o.objects_per_request - 1) / o.objects_per_request);
+  p->arrivals = calloc(o.window, sizeof(double));
+  p->finished = calloc(o.window, 1);
+  p->workers = calloc(o.window, sizeof(mdw_worker_t));
+  for(int i=0; i < o.window; i++){
+    mdw_worker_t * w = & p->workers[i];
+    w->pipe = p;
+    w->buf = aligned_buffer_alloc(object_buffer_size(), o.gpuMemoryFlags);
+    invalidate_buffer_pattern(w->buf, object_buffer_size(), o.gpuMemoryFlags);
+    w->stat.time_create = s->time_create;
+    w->stat.time_read = s->time_read;
+    w->stat.time_stat = s->time_stat;
+    w->stat.time_delete = s->time_delete;
+    w->stat.sketch_create = sketch_alloc();
+    w->stat.sketch_read = sketch_alloc();
+    w->stat.sketch_stat = sketch_alloc();
+    w->stat.sketch_delete = sketch_alloc();
+    w->stat.sketch_workflow = sketch_alloc();
+    if(pthread_create(& w->thread, NULL, pipeline_worker, w) != 0){
+      FAIL("Unable to create worker thread");
+    }
+  }
+  return p;
+}
+
+static void pipeline_submit(mdw_pipeline_t * p, double arrival){
+  pthread_mutex_lock(& p->lock);
+  while(p->submitted - p->completed >= (size_t) o.window){
+    pthread_cond_wait(& p->cond, & p->lock);
+  }
+  // an item is taken before the item window positions later can be submitted, so the slot is free
+  p->arrivals[p->submitted % o.window] = arrival;
+  p->submitted++;
+  pthread_cond_broadcast(& p->cond);
+  pthread_mutex_unlock(& p->lock);
+}
+
+static float pipeline_runtime(mdw_pipeline_t * p){
+  pthread_mutex_lock(& p->lock);
+  float runtime = p->bench_runtime;
+  pthread_mutex_unlock(& p->lock);
+  return runtime;
+}
+
+static void pipeline_restart_timer(mdw_pipeline_t * p, phase_stat_t * s){
+  if(p) pthread_mutex_lock(& p->lock);
+  s->phase_start_timer = GetTimeStamp();
+  if(p) pthread_mutex_unlock(& p->lock);
+}
+
+static void op_stat_add(op_stat_t * out, op_stat_t * in){
+  out->suc += in->suc;
+  out->err += in->err;
+}
+
+/* Wait for all outstanding workflows and merge the statistics of the workers */
+static void pipeline_finish(mdw_pipeline_t * p, phase_stat_t * s){
+  int one = 1;
+  pthread_mutex_lock(& p->lock);
+  p->done = 1;
+  pthread_cond_broadcast(& p->cond);
+  pthread_mutex_unlock(& p->lock);
+  for(int i=0; i < o.window; i++){
+    mdw_worker_t * w = & p->workers[i];
+    pthread_join(w->thread, NULL);
+    op_stat_add(& s->obj_create, & w->stat.obj_create);
+    op_stat_add(& s->obj_read, & w->stat.obj_read);
+    op_stat_add(& s->obj_stat, & w->stat.obj_stat);
+    op_stat_add(& s->obj_delete, & w->stat.obj_delete);
+    s->bytes += w->stat.bytes;
+    if(w->stat.max_op_time > s->max_op_time){
+      s->max_op_time = w->stat.max_op_time;
+    }
+    sketch_merge(w->stat.sketch_create, s->sketch_create, & one, NULL);
+    sketch_merge(w->stat.sketch_read, s->sketch_read, & one, NULL);
+    sketch_merge(w->stat.sketch_stat, s->sketch_stat, & one, NULL);
+    sketch_merge(w->stat.sketch_delete, s->sketch_delete, & one, NULL);
+    sketch_merge(w->stat.sketch_workflow, s->sketch_workflow, & one, NULL);
+    free(w->stat.sketch_create);
+    free(w->stat.sketch_read);
+    free(w->stat.sketch_stat);
+    free(w->stat.sketch_delete);
+    free(w->stat.sketch_workflow);
+    aligned_buffer_free(w->buf, o.gpuMemoryFlags);
+  }
+  pthread_mutex_destroy(& p->lock);
+  pthread_cond_destroy(& p->cond);
+  free(p->arrivals);
+  free(p->finished);
+  free(p->workers);
+  free(p);
+}
+
+/* FIFO: create a new file, write to it. Then read from the first created file, delete it... */
+void run_benchmark(phase_stat_t * s, int * current_index_p){
+  char * buf = NULL;
+  size_t request = -1; // the number of the logical request
+  int start_index = *current_index_p;
+  int total_num = o.num;
+  int armed_stone_wall = (o.stonewall_timer > 0);
+  int f;
+  double phase_allreduce_time = 0;
+  mdw_pipeline_t * pipe = NULL;
+  double arrival = 0; // the scheduled arrival of the next workflow in open-loop mode
+  if(o.arrival_rate > 0){
+    arrival = s->phase_start_timer;
+  }
+
+  if(o.window > 1){
+    pipe = pipeline_start(s, start_index);
+  }else{
+    buf = aligned_buffer_alloc(object_buffer_size(), o.gpuMemoryFlags);
+    invalidate_buffer_pattern(buf, object_buffer_size(), o.gpuMemoryFlags);
+  }
+
+  for(f=0; f < total_num; f++){
+    float bench_runtime = 0; // the time since start
+    for(int d=0; d < o.dset_count; d += o.objects_per_request){
+      request++;
+      if(o.arrival_rate > 0){
+        // open loop: issue at the scheduled arrival, if we are late the delay is part of the workflow latency
+        arrival += next_interarrival_time();
+        double now = GetTimeStamp();
+        if(arrival > now){
+          mdw_sleep(arrival - now);
+        }
       }
-    } // end loop
+      if(pipe){
+        pipeline_submit(pipe, arrival);
+      }else{
+        bench_runtime = run_benchmark_request(s, buf, request, start_index, arrival);
+      }
+    }
+    if(pipe){
+      bench_runtime = pipeline_runtime(pipe);
+    }
 
     if(armed_stone_wall && bench_runtime >= o.stonewall_timer){
       if(o.verbosity){
@@ -742,7 +1438,7 @@ void run_benchmark(phase_stat_t * s, int * current_index_p){
       phase_allreduce_time = GetTimeStamp() - s->phase_start_timer;
       int ret = MPI_Allreduce(& cur_pos, & total_num, 1, MPI_INT, MPI_MAX, o.com);
       CHECK_MPI_RET(ret)
-      s->phase_start_timer = GetTimeStamp();
+      pipeline_restart_timer(pipe, s);
       s->stonewall_iterations = total_num;
       if(o.rank == 0){
         oprintf("stonewall wear out %fs (%d iter)\n", bench_runtime, total_num);
@@ -752,6 +1448,9 @@ void run_benchmark(phase_stat_t * s, int * current_index_p){
       }
     }
   }
+  if(pipe){
+    pipeline_finish(pipe, s);
+  }
   s->t = GetTimeStamp() - s->phase_start_timer + phase_allreduce_time;
   if(armed_stone_wall && o.stonewall_timer_wear_out){
     int f = total_num;
@@ -769,8 +1468,12 @@ void run_benchmark(phase_stat_t * s, int * current_index_p){
   if(! o.read_only) {
     *current_index_p += f;
   }
-  s->repeats = pos + 1;
-  aligned_buffer_free(buf, o.gpuMemoryFlags);
+  // requests do not span iterations
+  const int requests_per_iteration = (o.dset_count + o.objects_per_request - 1) / o.objects_per_request;
+  s->repeats = (request + 1) / requests_per_iteration * o.dset_count;
+  if(buf){
+    aligned_buffer_free(buf, o.gpuMemoryFlags);
+  }
 }
 
 void run_cleanup(phase_stat_t * s, int start_index){
@@ -787,7 +1490,7 @@ void run_cleanup(phase_stat_t * s, int start_index){
 
       op_timer = GetTimeStamp();
       o.backend->remove(obj_name, o.backend_options);
-      add_timed_result(op_timer, s->phase_start_timer, s->time_delete, pos, & s->max_op_time, & op_time);
+      add_timed_result(op_timer, s->phase_start_timer, s->time_delete, s->sketch_delete, pos, & s->max_op_time, & op_time);
 
       if (o.verbosity >= 2){
         oprintf("%d: delete %s\n", o.rank, obj_name);
@@ -814,6 +1517,8 @@ static option_help options [] = {
   {'I', "obj-per-proc", "Number of I/O operations per data set.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.num},
   {'L', "latency", "Measure the latency for individual operations, prefix the result files with the provided filename.", OPTION_OPTIONAL_ARGUMENT, 's', & o.latency_file_prefix},
   {0, "latency-all", "Keep the latency files from all ranks.", OPTION_FLAG, 'd', & o.latency_keep_all},
+  {0, "latency-format", "Format of the latency files [csv|binary|binary-delta], convert binary files with iortrace2csv", OPTION_OPTIONAL_ARGUMENT, 's', & o.latency_format_str},
+  {0, "latency-accuracy", "Relative accuracy of the reported latency quantiles, e.g., 0.01 for 1%%.", OPTION_OPTIONAL_ARGUMENT, 'f', & o.latency_accuracy},
   {'P', "precreate-per-set", "Number of object to precreate per data set.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.precreate},
   {'D', "data-sets", "Number of data sets covered per process and iteration.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.dset_count},
   {'G', NULL,        "Timestamp/Random seed for access pattern, if not set, a random value is used", OPTION_OPTIONAL_ARGUMENT, 'd', & o.random_seed},
@@ -822,9 +1527,17 @@ static option_help options [] = {
   //{'m', "lim-free-mem", "Allocate memory until this limit (in MiB) is reached.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.limit_memory},
   //  {'M', "lim-free-mem-phase", "Allocate memory until this limit (in MiB) is reached between the phases, but free it before starting the next phase; the time is NOT included for the phase.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.limit_memory_between_phases},
   {'S', "object-size", "Size for the created objects.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.file_size},
+  {0, "object-size-distribution", "Distribution of the object sizes [fixed|lognormal|histogram], the lognormal distribution has the median object-size", OPTION_OPTIONAL_ARGUMENT, 's', & o.object_size_distribution},
+  {0, "object-size-sigma", "Shape parameter (sigma) of the lognormal object size distribution, sizes are capped at object-size * exp(4 sigma)", OPTION_OPTIONAL_ARGUMENT, 'f', & o.object_size_sigma},
+  {0, "object-size-file", "Histogram for the object sizes, each line contains: <size> <weight>", OPTION_OPTIONAL_ARGUMENT, 's', & o.object_size_file},
+  {0, "objects-per-request", "Number of objects accessed by one logical request (multi-get, then multi-put), at most the number of data sets; the request latency is reported as workflow", OPTION_OPTIONAL_ARGUMENT, 'd', & o.objects_per_request},
+  {0, "batch", "Use the batch operations of the backend (put/get/delete many) for the objects of a request, emulated by individual operations if the backend lacks them", OPTION_FLAG, 'd', & o.batch},
   {'R', "iterations", "Number of times to rerun the main phase", OPTION_OPTIONAL_ARGUMENT, 'd', & o.iterations},
   {'t', "waiting-time", "Waiting time relative to runtime (1.0 is 100%%)", OPTION_OPTIONAL_ARGUMENT, 'f', & o.relative_waiting_factor},
   {'T', "adaptive-waiting", "Compute an adaptive waiting time", OPTION_FLAG, 'd', & o.adaptive_waiting_mode},
+  {0, "arrival-rate", "Open-loop mode: issue requests at this aggregated rate (requests/s across all processes); the workflow latency is measured from the scheduled arrival", OPTION_OPTIONAL_ARGUMENT, 'f', & o.arrival_rate},
+  {0, "arrival-distribution", "Distribution of the inter-arrival times in open-loop mode [poisson|fixed]", OPTION_OPTIONAL_ARGUMENT, 's', & o.arrival_distribution},
+  {0, "window", "Number of object workflows kept in flight per process by worker threads during the benchmark phase, requires a thread-safe backend; workflows wait for the earlier workflows of the same process only, not for the ranks that created the objects they read", OPTION_OPTIONAL_ARGUMENT, 'd', & o.window},
   {'1', "run-precreate", "Run precreate phase", OPTION_FLAG, 'd', & o.phase_precreate},
   {'2', "run-benchmark", "Run benchmark phase", OPTION_FLAG, 'd', & o.phase_benchmark},
   {'3', "run-cleanup", "Run cleanup phase (only run explicit phases)", OPTION_FLAG, 'd', & o.phase_cleanup},
@@ -924,6 +1637,32 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
   o.backend_options = airoi_update_module_options(o.backend, global_options);
   
   o.dataPacketType = parsePacketType(o.packetTypeStr[0]);
+  if(o.window < 1){
+    ERR("The window must be at least 1");
+  }
+  if(o.window > 1){
+    int provided;
+    MPI_Query_thread(& provided);
+    if(provided < MPI_THREAD_MULTIPLE){
+      ERR("The window requires MPI to be initialized with MPI_THREAD_MULTIPLE");
+    }
+  }
+  if(o.objects_per_request < 1 || o.objects_per_request > o.dset_count){
+    ERR("The objects per request must be between 1 and the number of data sets");
+  }
+  o.latency_format = optrace_parse_format(o.latency_format_str);
+  if(o.latency_format < 0){
+    ERRF("Unknown latency format: %s", o.latency_format_str);
+  }
+  if(strcmp(o.arrival_distribution, "poisson") == 0){
+    o.arrival_poisson = 1;
+  }else if(strcmp(o.arrival_distribution, "fixed") != 0){
+    ERRF("Unknown arrival distribution: %s", o.arrival_distribution);
+  }
+  if(o.arrival_rate > 0 && (o.relative_waiting_factor > 1e-9 || o.adaptive_waiting_mode)){
+    ERR("The open-loop mode (--arrival-rate) cannot be combined with a waiting time");
+  }
+  sketch_init();
 
   if (!(o.phase_cleanup || o.phase_precreate || o.phase_benchmark)){
     // enable all phases
@@ -938,6 +1677,8 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
       o.random_seed = time(NULL);
       MPI_Bcast(& o.random_seed, 1, MPI_INT, 0, o.com);
   }
+  object_size_init();
+  arrival_rng_state = 0x9E3779B97F4A7C15ULL ^ ((uint64_t) o.random_seed << 20) ^ (uint64_t) (o.rank + 1);
 
   if(o.backend->xfer_hints){
     o.backend->xfer_hints(& o.hints);
@@ -968,7 +1709,7 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
 
   size_t total_obj_count = o.dset_count * (size_t) (o.num * o.iterations + o.precreate) * o.size;
   if (o.rank == 0 && ! o.quiet_output){
-    oprintf("MD-Workbench total objects: %zu workingset size: %.3f MiB (version: %s) time: ", total_obj_count, ((double) o.size) * o.dset_count * o.precreate * o.file_size / 1024.0 / 1024.0,  PACKAGE_VERSION);
+    oprintf("MD-Workbench total objects: %zu workingset size: %.3f MiB (version: %s) time: ", total_obj_count, ((double) o.size) * o.dset_count * o.precreate * o.object_size_mean / 1024.0 / 1024.0,  PACKAGE_VERSION);
     printTime();
     if(o.num > o.precreate){
       oprintf("WARNING: num > precreate, this may cause the situation that no objects are available to read\n");
@@ -1067,6 +1808,8 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
     oprintf("Total runtime: %.0fs time: ",  t_all);
     printTime();
   }
+  sketch_finalize();
+  object_size_finalize();
   //mem_free_preallocated(& limit_memory_P);
   return o.results;
 }
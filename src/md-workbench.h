@@ -22,6 +22,7 @@ typedef struct{ // NOTE: if this type is changed, adjust end_phase() !!!
   time_statistics_t stats_read;
   time_statistics_t stats_stat;
   time_statistics_t stats_delete;
+  time_statistics_t stats_workflow; // open-loop mode: latency from the scheduled arrival
 
   int errors;
   double rate;
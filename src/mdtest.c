@@ -73,6 +73,10 @@
 #include "aiori.h"
 #include "ior.h"
 #include "mdtest.h"
+#include "telemetry.h"
+#include "client-stats.h"
+#include "perf-counters.h"
+#include "timeline.h"
 
 #include <mpi.h>
 
@@ -174,11 +178,18 @@ typedef struct {
   int path_count;
   int nstride; /* neighbor stride */
   int make_node;
+  int batch_size; /* number of files created/stat'ed/removed with one batch operation */
   #ifdef HAVE_LUSTRE_LUSTREAPI
   int global_dir_layout;
   #endif /* HAVE_LUSTRE_LUSTREAPI */
   char * saveRankDetailsCSV;       /* save the details about the performance to a file */
   char * savePerOpDataCSV; 
+  int savePerOpDataFormat; /* optrace_format_e */
+  char * telemetry; /* name of the shared memory segment for live progress */
+  int client_stats; /* report the client CPU and OS I/O accounting per phase */
+  int perf_counters; /* report hardware performance counters per phase */
+  char * timeline; /* write a timeline of all backend calls into this file */
+  int timeline_events; /* number of backend calls kept per rank for the timeline */
   const char *prologue;
   const char *epilogue;
 
@@ -280,7 +291,12 @@ static void prep_testdir(int j, int dir_iter){
   pos += sprintf(& o.testdir[pos], ".%d-%d", j, dir_iter);
 }
 
-static void phase_prepare(){
+static client_stats_t client_stats;
+static perf_counters_t perf_counters;
+
+static void phase_prepare(int test_num){
+  telemetry_phase(mdtest_test_name(test_num));
+  timeline_phase(mdtest_test_name(test_num));
   if (*o.prologue){
     VERBOSE(0,5,"calling prologue: \"%s\"", o.prologue);
     system(o.prologue);
@@ -288,6 +304,12 @@ static void phase_prepare(){
   if (o.barriers) {
     MPI_CHECK(MPI_Barrier(testComm), "MPI_Barrier error");
   }
+  if (o.client_stats) {
+    client_stats_start(& client_stats);
+  }
+  if (o.perf_counters) {
+    perf_counters_start(& perf_counters);
+  }
 }
 
 static void phase_end(){
@@ -438,12 +460,75 @@ static void create_file (const char *path, uint64_t itemNum) {
     o.backend->close (aiori_fh, o.backend_options);
 }
 
+/* create or remove count files with one batch operation of the backend */
+static void create_remove_files_batch (const int create, const char *path, uint64_t itemNum, int count, rank_progress_t * progress) {
+    char * names[count];
+    IOR_size_t * buffers[count];
+    IOR_offset_t sizes[count];
+    int status[count];
+    char * name_buf = safeMalloc(MAX_PATHLEN * count);
+
+    for (int i = 0; i < count; i++) {
+        names[i] = name_buf + MAX_PATHLEN * i;
+        sprintf(names[i], "%s/file.%s"LLU"", path, create ? o.mk_name : o.rm_name, itemNum + i);
+        VERBOSE(3,5,"create_remove_items_helper (batch %s): curr_item is '%s'", create ? "create" : "remove", names[i]);
+        if (create) {
+            buffers[i] = (IOR_size_t *) (o.write_buffer + o.write_bytes * i);
+            sizes[i] = o.write_bytes;
+            if (o.write_bytes > 0) {
+                update_write_memory_pattern(itemNum + i, (char *) buffers[i], o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+            }
+        }
+    }
+
+    double start = GetTimeStamp();
+    int success;
+    if (create) {
+        o.hints.filePerProc = ! o.shared_file;
+        /* the emulation syncs each item with its write, a batch put of an object store completes durably */
+        o.hints.fsyncPerWrite = o.sync_file;
+        success = aiori_put_batch (o.backend, count, names, buffers, sizes, status, o.backend_options);
+    } else {
+        success = aiori_remove_batch (o.backend, count, names, status, o.backend_options);
+    }
+    double end = GetTimeStamp();
+    if (success != count) {
+        for (int i = 0; i < count; i++) {
+            if (status[i] != 0) {
+                WARNF("unable to %s file %s", create ? "create" : "remove", names[i]);
+            }
+        }
+    }
+    /* every file of the batch observes the latency of the batch */
+    for (int i = 0; i < count; i++) {
+        if (progress->ot) OpTimerValue(progress->ot, start - progress->start_time, end - start);
+        telemetry_op(create ? o.write_bytes : 0, end - start);
+    }
+    telemetry_error(count - success);
+    free(name_buf);
+}
+
 /* helper for creating/removing items */
 void create_remove_items_helper(const int dirs, const int create, const char *path,
                                 uint64_t itemNum, rank_progress_t * progress) {
 
     VERBOSE(1,-1,"Entering create_remove_items_helper on %s", path );
 
+    if (!dirs && o.batch_size > 1) {
+        for (uint64_t i = progress->items_start; i < progress->items_per_dir ; i += o.batch_size) {
+            int count = progress->items_per_dir - i < (uint64_t) o.batch_size ? (int) (progress->items_per_dir - i) : o.batch_size;
+            create_remove_files_batch (create, path, itemNum + i, count, progress);
+            if(CHECK_STONE_WALL(progress)){
+              if(progress->items_done == 0){
+                progress->items_done = i + count;
+              }
+              return;
+            }
+        }
+        progress->items_done = progress->items_per_dir;
+        return;
+    }
+
     for (uint64_t i = progress->items_start; i < progress->items_per_dir ; ++i) {
         if (!dirs) {
             double start = GetTimeStamp();
@@ -452,9 +537,13 @@ void create_remove_items_helper(const int dirs, const int create, const char *pa
             } else {
                 remove_file (path, itemNum + i);
             }
-            if(progress->ot) OpTimerValue(progress->ot, start - progress->start_time, GetTimeStamp() - start);
+            double runtime = GetTimeStamp() - start;
+            if(progress->ot) OpTimerValue(progress->ot, start - progress->start_time, runtime);
+            telemetry_op(create ? o.write_bytes : 0, runtime);
         } else {
+            double start = GetTimeStamp();
             create_remove_dirs (path, create, itemNum + i);
+            telemetry_op(0, GetTimeStamp() - start);
         }
         if(CHECK_STONE_WALL(progress)){
           if(progress->items_done == 0){
@@ -573,14 +662,49 @@ void create_remove_items(int currDepth, const int dirs, const int create, const
     }
 }
 
+/* stats count files with one batch operation of the backend */
+static void stat_files_batch (char ** names, int count, rank_progress_t * progress) {
+    struct stat bufs[count];
+    int status[count];
+
+    double start = GetTimeStamp();
+    int success = aiori_stat_batch (o.backend, count, names, bufs, status, o.backend_options);
+    double end = GetTimeStamp();
+    if (success != count) {
+        for (int i = 0; i < count; i++) {
+            if (status[i] != 0) {
+                WARNF("unable to stat file %s", names[i]);
+            }
+        }
+    }
+    /* every file of the batch observes the latency of the batch */
+    for (int i = 0; i < count; i++) {
+        if (progress->ot) OpTimerValue(progress->ot, start - progress->start_time, end - start);
+        telemetry_op(0, end - start);
+    }
+    telemetry_error(count - success);
+}
+
 /* stats all of the items created as specified by the input parameters */
 void mdtest_stat(const int random, const int dirs, const long dir_iter, const char *path, rank_progress_t * progress) {
     struct stat buf;
     uint64_t parent_dir, item_num = 0;
     char item[MAX_PATHLEN], temp[MAX_PATHLEN];
+    const int batch = ! dirs && o.batch_size > 1;
+    char ** names = NULL;
+    char * name_buf = NULL;
+    int batch_count = 0;
 
     VERBOSE(1,-1,"Entering mdtest_stat on %s", path );
 
+    if (batch) {
+        names = safeMalloc(sizeof(char *) * o.batch_size);
+        name_buf = safeMalloc(MAX_PATHLEN * o.batch_size);
+        for (int i = 0; i < o.batch_size; i++) {
+            names[i] = name_buf + MAX_PATHLEN * i;
+        }
+    }
+
     uint64_t stop_items = o.items;
 
     if( o.directory_loops != 1 ){
@@ -649,12 +773,25 @@ void mdtest_stat(const int random, const int dirs, const long dir_iter, const ch
 
         /* below temp used to be hiername */
         VERBOSE(3,5,"mdtest_stat %4s: %s", (dirs ? "dir" : "file"), item);
+        if (batch) {
+            strcpy(names[batch_count++], item);
+            if (batch_count == o.batch_size || i == stop_items - 1) {
+                stat_files_batch (names, batch_count, progress);
+                batch_count = 0;
+            }
+            continue;
+        }
         double start = GetTimeStamp();
         if (-1 == o.backend->stat (item, &buf, o.backend_options)) {
             WARNF("unable to stat %s %s", dirs ? "directory" : "file", item);
+            telemetry_error(1);
         }
-        if(progress->ot) OpTimerValue(progress->ot, start - progress->start_time, GetTimeStamp() - start);        
+        double runtime = GetTimeStamp() - start;
+        if(progress->ot) OpTimerValue(progress->ot, start - progress->start_time, runtime);
+        telemetry_op(0, runtime);
     }
+    free(names);
+    free(name_buf);
 }
 
 /* reads all of the items created as specified by the input parameters */
@@ -762,12 +899,15 @@ void mdtest_read(int random, int dirs, const long dir_iter, char *path, rank_pro
               }
               int error = verify_memory_pattern(item_num, read_buffer, o.read_bytes, o.random_buffer_offset, pretend_rank, o.dataPacketType, o.gpuMemoryFlags);
               o.verification_error += error;
+              telemetry_error(error);
               if(error){
                 VERBOSE(1,1,"verification error in file: %s", item);
               }
             }
         }
-        if(progress->ot) OpTimerValue(progress->ot, start - progress->start_time, GetTimeStamp() - start);
+        double runtime = GetTimeStamp() - start;
+        if(progress->ot) OpTimerValue(progress->ot, start - progress->start_time, runtime);
+        telemetry_op(o.read_bytes, runtime);
 
         /* close file */
         o.backend->close (aiori_fh, o.backend_options);
@@ -944,6 +1084,22 @@ static void updateResult(mdtest_results_t * res, mdtest_test_num_t test, uint64_
   }
   res->items[test] = item_count;
   res->stonewall_last_item[test] = o.items;
+
+  timeline_phase(NULL);
+  if (o.perf_counters) {
+    perf_counters_stop(& perf_counters);
+    perf_counters_report(out_logfile, mdtest_test_name(test), & perf_counters, item_count, testComm);
+  }
+  if (o.client_stats) {
+    uint64_t bytes = 0;
+    if (test == MDTEST_FILE_CREATE_NUM) {
+      bytes = item_count * o.write_bytes;
+    } else if (test == MDTEST_FILE_READ_NUM) {
+      bytes = item_count * o.read_bytes;
+    }
+    client_stats_stop(& client_stats, bytes, item_count);
+    client_stats_report(out_logfile, mdtest_test_name(test), & client_stats, testComm);
+  }
 }
 
 void directory_test(const int iteration, const int ntasks, const char *path, rank_progress_t * progress) {
@@ -960,7 +1116,7 @@ void directory_test(const int iteration, const int ntasks, const char *path, ran
 
     /* create phase */
     if(o.create_only) {
-      phase_prepare();
+      phase_prepare(MDTEST_DIR_CREATE_NUM);
       t_start = GetTimeStamp();
       progress->stone_wall_timer_seconds = o.stone_wall_timer_seconds;
       progress->items_done = 0;
@@ -997,7 +1153,7 @@ void directory_test(const int iteration, const int ntasks, const char *path, ran
 
     /* stat phase */
     if (o.stat_only) {
-      phase_prepare();
+      phase_prepare(MDTEST_DIR_STAT_NUM);
       t_start = GetTimeStamp();
       for (int dir_iter = 0; dir_iter < o.directory_loops; dir_iter ++){
         prep_testdir(iteration, dir_iter);
@@ -1027,7 +1183,7 @@ void directory_test(const int iteration, const int ntasks, const char *path, ran
 
     /* read phase */
     if (o.read_only) {
-      phase_prepare();
+      phase_prepare(MDTEST_DIR_READ_NUM);
       t_start = GetTimeStamp();
       for (int dir_iter = 0; dir_iter < o.directory_loops; dir_iter ++){
         prep_testdir(iteration, dir_iter);
@@ -1057,7 +1213,7 @@ void directory_test(const int iteration, const int ntasks, const char *path, ran
 
     /* rename phase */
     if(o.rename_dirs && o.items > 1){
-      phase_prepare();
+      phase_prepare(MDTEST_DIR_RENAME_NUM);
       t_start = GetTimeStamp();
       for (int dir_iter = 0; dir_iter < o.directory_loops; dir_iter ++){
         prep_testdir(iteration, dir_iter);
@@ -1082,7 +1238,7 @@ void directory_test(const int iteration, const int ntasks, const char *path, ran
 
     /* remove phase */
     if (o.remove_only) {
-      phase_prepare();
+      phase_prepare(MDTEST_DIR_REMOVE_NUM);
       t_start = GetTimeStamp();
       for (int dir_iter = 0; dir_iter < o.directory_loops; dir_iter ++){
         prep_testdir(iteration, dir_iter);
@@ -1252,11 +1408,11 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
 
     /* create phase */
     if (o.create_only ) {
-      phase_prepare();
+      phase_prepare(MDTEST_FILE_CREATE_NUM);
       if(o.savePerOpDataCSV != NULL) {
         char path[MAX_PATHLEN];
-        sprintf(path, "%s-%s-%05d.csv", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_CREATE_NUM), rank);
-        progress->ot = OpTimerInit(path, o.write_bytes > 0 ? o.write_bytes : 1);
+        sprintf(path, "%s-%s-%05d.%s", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_CREATE_NUM), rank, optrace_format_suffix(o.savePerOpDataFormat));
+        progress->ot = OpTimerInit(path, o.write_bytes > 0 ? o.write_bytes : 1, o.savePerOpDataFormat);
       }      
       t_start = GetTimeStamp();
 #ifdef HAVE_GPFSCREATESHARING_T
@@ -1312,11 +1468,11 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
 
     /* stat phase */
     if (o.stat_only ) {
-      phase_prepare();
+      phase_prepare(MDTEST_FILE_STAT_NUM);
       if(o.savePerOpDataCSV != NULL) {
         char path[MAX_PATHLEN];
-        sprintf(path, "%s-%s-%05d.csv", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_STAT_NUM), rank);
-        progress->ot = OpTimerInit(path, 1);
+        sprintf(path, "%s-%s-%05d.%s", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_STAT_NUM), rank, optrace_format_suffix(o.savePerOpDataFormat));
+        progress->ot = OpTimerInit(path, 1, o.savePerOpDataFormat);
       }            
       t_start = GetTimeStamp();
       progress->start_time = t_start;
@@ -1345,11 +1501,11 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
 
     /* read phase */
     if (o.read_only ) {
-      phase_prepare();
+      phase_prepare(MDTEST_FILE_READ_NUM);
       if(o.savePerOpDataCSV != NULL) {
         char path[MAX_PATHLEN];
-        sprintf(path, "%s-%s-%05d.csv", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_READ_NUM), rank);
-        progress->ot = OpTimerInit(path, o.read_bytes > 0 ? o.read_bytes : 1);
+        sprintf(path, "%s-%s-%05d.%s", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_READ_NUM), rank, optrace_format_suffix(o.savePerOpDataFormat));
+        progress->ot = OpTimerInit(path, o.read_bytes > 0 ? o.read_bytes : 1, o.savePerOpDataFormat);
       }            
       t_start = GetTimeStamp();
       progress->start_time = t_start;
@@ -1382,10 +1538,10 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
 
     /* remove phase */
     if (o.remove_only) {
-      phase_prepare();
+      phase_prepare(MDTEST_FILE_REMOVE_NUM);
       if(o.savePerOpDataCSV != NULL) {
-        sprintf(temp_path, "%s-%s-%05d.csv", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_REMOVE_NUM), rank);
-        progress->ot = OpTimerInit(temp_path, o.write_bytes > 0 ? o.write_bytes : 1);
+        sprintf(temp_path, "%s-%s-%05d.%s", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_REMOVE_NUM), rank, optrace_format_suffix(o.savePerOpDataFormat));
+        progress->ot = OpTimerInit(temp_path, o.write_bytes > 0 ? o.write_bytes : 1, o.savePerOpDataFormat);
       }      
       t_start = GetTimeStamp();
       progress->start_time = t_start;
@@ -1880,6 +2036,10 @@ void md_validate_tests() {
         FAIL("-k not compatible with -w");
     }
 
+    if (o.batch_size > 1 && (o.make_node || o.collective_creates || o.shared_file || o.verify_write)) {
+        FAIL("--batch-size is not compatible with -k, -c, -S and --verify-write");
+    }
+
     if(o.verify_read && ! o.read_only)
       FAIL("Verify read requires that the read test is used");
 
@@ -2263,6 +2423,7 @@ void mdtest_init_args(){
      .prologue = "",
      .epilogue = "",
      .gpuID = -1,
+     .timeline_events = TIMELINE_DEFAULT_EVENTS,
   };
 }
 
@@ -2301,6 +2462,7 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
     memset(& o.hints, 0, sizeof(o.hints));
     
     char * packetType = "t";
+    char * perOpDataFormat = "csv";
 
     option_help options [] = {
       {'a', NULL,        apiStr, OPTION_OPTIONAL_ARGUMENT, 's', & o.api},
@@ -2339,6 +2501,7 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
       {'u', NULL,        "unique working directory for each task", OPTION_FLAG, 'd', & o.unique_dir_per_task},
       {'v', NULL,        "verbosity (each instance of option increments by one)", OPTION_FLAG, 'd', & verbose},
       {'V', NULL,        "verbosity value", OPTION_OPTIONAL_ARGUMENT, 'd', & verbose},
+      {0, "batch-size",  "number of files created (and written), stat'ed or removed with one batch operation of the backend", OPTION_OPTIONAL_ARGUMENT, 'd', & o.batch_size},
       {'w', NULL,        "bytes to write to each file after it is created", OPTION_OPTIONAL_ARGUMENT, 'l', & o.write_bytes},
       {'W', NULL,        "number in seconds; stonewall timer, write as many seconds and ensure all processes did the same number of operations (currently only stops during create phase and files)", OPTION_OPTIONAL_ARGUMENT, 'd', & o.stone_wall_timer_seconds},
       {'x', NULL,        "StoneWallingStatusFile; contains the number of iterations of the creation phase, can be used to split phases across runs", OPTION_OPTIONAL_ARGUMENT, 's', & o.stoneWallingStatusFile},
@@ -2361,6 +2524,12 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
       {0, "warningAsErrors",        "Any warning should lead to an error.", OPTION_FLAG, 'd', & aiori_warning_as_errors},
       {0, "saveRankPerformanceDetails", "Save the individual rank information into this CSV file.", OPTION_OPTIONAL_ARGUMENT, 's', & o.saveRankDetailsCSV},
       {0, "savePerOpDataCSV", "Store the performance of each rank into an individual file prefixed with this option.", OPTION_OPTIONAL_ARGUMENT, 's', & o.savePerOpDataCSV},
+      {0, "clientStats", "Report the client CPU time, context switches, storage I/O (/proc/self/io) and node page cache (/proc/vmstat) per phase", OPTION_FLAG, 'd', & o.client_stats},
+      {0, "perfCounters", "Report the cycles, instructions, IPC, LLC misses, page faults and dTLB misses per phase using perf_event_open", OPTION_FLAG, 'd', & o.perf_counters},
+      {0, "timeline", "Write a timeline of all backend calls of all ranks into the named file in the Chrome trace format (chrome://tracing, ui.perfetto.dev)", OPTION_OPTIONAL_ARGUMENT, 's', & o.timeline},
+      {0, "timelineEvents", "Number of backend calls kept per rank for the timeline, older calls are dropped", OPTION_OPTIONAL_ARGUMENT, 'd', & o.timeline_events},
+      {0, "telemetry", "Publish live progress counters of each rank into the shared memory segment /NAME on each node, watch them with ior-top NAME", OPTION_OPTIONAL_ARGUMENT, 's', & o.telemetry},
+      {0, "savePerOpDataFormat", "Format of the per operation data [csv|binary|binary-delta], convert binary files with iortrace2csv", OPTION_OPTIONAL_ARGUMENT, 's', & perOpDataFormat},
       {0, "showRankStatistics", "Include statistics per rank", OPTION_FLAG, 'd', & o.show_perrank_statistics},
       LAST_OPTION
     };
@@ -2377,6 +2546,10 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
     free(global_options);
     
     o.dataPacketType = parsePacketType(packetType[0]);
+    o.savePerOpDataFormat = optrace_parse_format(perOpDataFormat);
+    if (o.savePerOpDataFormat < 0) {
+        FAIL("Unknown savePerOpDataFormat: %s", perOpDataFormat);
+    }
 
     MPI_CHECK(MPI_Comm_rank(testComm, &rank), "MPI_Comm_rank error");
     MPI_CHECK(MPI_Comm_size(testComm, &o.size), "MPI_Comm_size error");
@@ -2390,6 +2563,11 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
     if (o.backend->initialize){
       o.backend->initialize(o.backend_options);
     }
+    telemetry_init(o.telemetry, "mdtest", world_com);
+    o.backend = timeline_init(o.timeline, o.timeline_events, o.backend, world_com);
+    if (o.perf_counters) {
+      perf_counters_init();
+    }
 
     o.pid = getpid();
     o.uid = getuid();
@@ -2467,6 +2645,7 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
     VERBOSE(1,-1, "call_sync               : %s", ( o.call_sync ? "True" : "False" ));
     VERBOSE(1,-1, "depth                   : %d", o.depth );
     VERBOSE(1,-1, "make_node               : %d", o.make_node );
+    VERBOSE(1,-1, "batch_size              : %d", o.batch_size );
     int tasksBlockMapping = QueryNodeMapping(testComm, true);
 
     if(o.gpuMemoryFlags != IOR_MEMORY_TYPE_CPU){
@@ -2549,8 +2728,12 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
 
     /* allocate and initialize write buffer with # */
     if (o.write_bytes > 0) {
-        o.write_buffer = aligned_buffer_alloc(o.write_bytes, o.gpuMemoryFlags);
-        generate_memory_pattern(o.write_buffer, o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+        /* batches use one slice of the buffer per file */
+        int slices = o.batch_size > 1 ? o.batch_size : 1;
+        o.write_buffer = aligned_buffer_alloc(o.write_bytes * slices, o.gpuMemoryFlags);
+        for (int i = 0; i < slices; i++) {
+            generate_memory_pattern(o.write_buffer + o.write_bytes * i, o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+        }
     }
 
     /* setup directory path to work in */
@@ -2647,6 +2830,9 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
             continue;
         }
         MPI_CHECK(MPI_Comm_size(testComm, &o.size), "MPI_Comm_size error");
+        if (o.client_stats) {
+            client_stats_init(testComm);
+        }
 
         if (rank == 0) {
             uint64_t items_all = i * o.items;
@@ -2699,6 +2885,9 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
     }
 
     VERBOSE(0,-1,"-- finished at %s --\n", PrintTimestamp());
+    telemetry_finalize();
+    perf_counters_finalize();
+    timeline_finalize();
 
     if (o.random_seed > 0) {
         free(o.rand_array);
@@ -0,0 +1,163 @@
+/*
+ * Encoding and decoding of the binary per-operation trace, see optrace.h
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <string.h>
+#include <strings.h>
+
+#include "optrace.h"
+
+int optrace_parse_format(const char * str){
+  if(strcasecmp(str, "csv") == 0){
+    return OPTRACE_FORMAT_CSV;
+  }else if(strcasecmp(str, "binary") == 0){
+    return OPTRACE_FORMAT_BINARY;
+  }else if(strcasecmp(str, "binary-delta") == 0){
+    return OPTRACE_FORMAT_BINARY_DELTA;
+  }
+  return -1;
+}
+
+const char * optrace_format_suffix(int format){
+  return format == OPTRACE_FORMAT_CSV ? "csv" : "trace";
+}
+
+static void put_u32(char * out, uint32_t v){
+  for(int i=0; i < 4; i++){
+    out[i] = (char) (v >> (8*i));
+  }
+}
+
+static void put_u64(char * out, uint64_t v){
+  for(int i=0; i < 8; i++){
+    out[i] = (char) (v >> (8*i));
+  }
+}
+
+static uint64_t get_u64(const unsigned char * in, int bytes){
+  uint64_t v = 0;
+  for(int i=0; i < bytes; i++){
+    v |= ((uint64_t) in[i]) << (8*i);
+  }
+  return v;
+}
+
+static size_t put_varint(char * out, uint64_t v){
+  size_t pos = 0;
+  while(v >= 0x80){
+    out[pos++] = (char) (v | 0x80);
+    v >>= 7;
+  }
+  out[pos++] = (char) v;
+  return pos;
+}
+
+static uint64_t zigzag(int64_t v){
+  return ((uint64_t) v << 1) ^ (uint64_t) (v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v){
+  return (int64_t) (v >> 1) ^ -(int64_t) (v & 1);
+}
+
+static uint64_t to_ns(double t){
+  return t <= 0 ? 0 : (uint64_t) (t * 1e9 + 0.5);
+}
+
+int optrace_write_header(FILE * f, int format){
+  char header[OPTRACE_HEADER_SIZE];
+  memcpy(header, OPTRACE_MAGIC, 8);
+  put_u32(header + 8, OPTRACE_VERSION);
+  put_u32(header + 12, format == OPTRACE_FORMAT_BINARY_DELTA ? OPTRACE_FLAG_DELTA : 0);
+  return fwrite(header, OPTRACE_HEADER_SIZE, 1, f) == 1 ? 0 : -1;
+}
+
+size_t optrace_encode(char * out, int format, optrace_state_t * state, const optrace_record_t * rec){
+  uint64_t start_ns = to_ns(rec->time);
+  uint64_t runtime_ns = to_ns(rec->runtime);
+  if(format == OPTRACE_FORMAT_BINARY){
+    put_u64(out, start_ns);
+    put_u64(out + 8, runtime_ns);
+    put_u64(out + 16, (uint64_t) rec->size);
+    put_u64(out + 24, (uint64_t) rec->offset);
+    out[32] = (char) rec->op;
+    return OPTRACE_RECORD_SIZE;
+  }
+  size_t pos = 0;
+  pos += put_varint(out + pos, zigzag((int64_t) (start_ns - state->start_ns)));
+  pos += put_varint(out + pos, runtime_ns);
+  pos += put_varint(out + pos, (uint64_t) rec->op);
+  pos += put_varint(out + pos, zigzag(rec->size - state->size));
+  pos += put_varint(out + pos, zigzag(rec->offset - state->offset));
+  state->start_ns = start_ns;
+  state->size = rec->size;
+  state->offset = rec->offset;
+  return pos;
+}
+
+int optrace_read_header(FILE * f){
+  unsigned char header[OPTRACE_HEADER_SIZE];
+  if(fread(header, OPTRACE_HEADER_SIZE, 1, f) != 1){
+    return -1;
+  }
+  if(memcmp(header, OPTRACE_MAGIC, 8) != 0 || get_u64(header + 8, 4) != OPTRACE_VERSION){
+    return -1;
+  }
+  return get_u64(header + 12, 4) & OPTRACE_FLAG_DELTA ? OPTRACE_FORMAT_BINARY_DELTA : OPTRACE_FORMAT_BINARY;
+}
+
+/* @return 1 on success, 0 at the end of the file before the first byte, -1 otherwise */
+static int read_varint(FILE * f, uint64_t * out){
+  uint64_t v = 0;
+  for(int shift = 0; shift < 64; shift += 7){
+    int c = getc(f);
+    if(c == EOF){
+      return shift == 0 ? 0 : -1;
+    }
+    v |= ((uint64_t) (c & 0x7f)) << shift;
+    if(! (c & 0x80)){
+      *out = v;
+      return 1;
+    }
+  }
+  return -1;
+}
+
+int optrace_read(FILE * f, int format, optrace_state_t * state, optrace_record_t * rec){
+  if(format == OPTRACE_FORMAT_BINARY){
+    unsigned char buf[OPTRACE_RECORD_SIZE];
+    size_t ret = fread(buf, 1, OPTRACE_RECORD_SIZE, f);
+    if(ret == 0){
+      return 0;
+    }
+    if(ret != OPTRACE_RECORD_SIZE){
+      return -1;
+    }
+    rec->time = get_u64(buf, 8) * 1e-9;
+    rec->runtime = get_u64(buf + 8, 8) * 1e-9;
+    rec->size = (int64_t) get_u64(buf + 16, 8);
+    rec->offset = (int64_t) get_u64(buf + 24, 8);
+    rec->op = buf[32];
+    return 1;
+  }
+  uint64_t v[5];
+  for(int i=0; i < 5; i++){
+    int ret = read_varint(f, & v[i]);
+    if(ret != 1){
+      return i == 0 && ret == 0 ? 0 : -1;
+    }
+  }
+  state->start_ns += (uint64_t) unzigzag(v[0]);
+  state->size += unzigzag(v[3]);
+  state->offset += unzigzag(v[4]);
+  rec->time = state->start_ns * 1e-9;
+  rec->runtime = v[1] * 1e-9;
+  rec->op = (int) v[2];
+  rec->size = state->size;
+  rec->offset = state->offset;
+  return 1;
+}
@@ -0,0 +1,62 @@
+#ifndef _IOR_OPTRACE_H
+#define _IOR_OPTRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Compact binary format for per-operation traces.
+ *
+ * A file starts with a 16 byte header: the magic "IORTRACE", a 32 bit version
+ * and 32 bit flags, all integers are stored little endian.
+ * Each record contains the start time and duration in nanoseconds, the operation
+ * type (defined by the producer), the size and the offset (-1 if unknown).
+ * Without flags, a record has a fixed width of OPTRACE_RECORD_SIZE bytes.
+ * With OPTRACE_FLAG_DELTA, each field is stored as a varint; start time, size and
+ * offset as zigzag encoded difference to the previous record.
+ */
+
+#define OPTRACE_MAGIC "IORTRACE"
+#define OPTRACE_VERSION 1
+#define OPTRACE_HEADER_SIZE 16
+#define OPTRACE_RECORD_SIZE 33
+#define OPTRACE_MAX_RECORD_SIZE 50 /* 5 varints of at most 10 bytes */
+
+#define OPTRACE_FLAG_DELTA 1
+
+typedef enum {
+  OPTRACE_FORMAT_CSV = 0,
+  OPTRACE_FORMAT_BINARY,
+  OPTRACE_FORMAT_BINARY_DELTA
+} optrace_format_e;
+
+typedef struct {
+  double time;    /* start in seconds since the begin of the phase */
+  double runtime; /* in seconds */
+  int64_t size;
+  int64_t offset;
+  int op;
+} optrace_record_t;
+
+/* state of the delta encoding, initialize with zeros */
+typedef struct {
+  uint64_t start_ns;
+  int64_t size;
+  int64_t offset;
+} optrace_state_t;
+
+/* @return the format or -1 if the string is unknown */
+int optrace_parse_format(const char * str);
+/* file extension used for the format */
+const char * optrace_format_suffix(int format);
+
+int optrace_write_header(FILE * f, int format);
+/* encode one record into out, @return the number of bytes used */
+size_t optrace_encode(char * out, int format, optrace_state_t * state, const optrace_record_t * rec);
+
+/* read the header, @return the format or -1 on error */
+int optrace_read_header(FILE * f);
+/* @return 1 if a record was read, 0 at the end of the file and -1 on error */
+int optrace_read(FILE * f, int format, optrace_state_t * state, optrace_record_t * rec);
+
+#endif
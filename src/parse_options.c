@@ -120,6 +120,11 @@ void DecodeDirective(char *line, IOR_param_t *params, options_all_t * module_opt
           params->saveRankDetailsCSV = strdup(value);
         } else if (strcasecmp(option, "savePerOpDataCSV") == 0){
           params->savePerOpDataCSV = strdup(value);
+        } else if (strcasecmp(option, "savePerOpDataFormat") == 0){
+          params->savePerOpDataFormat = optrace_parse_format(value);
+          if(params->savePerOpDataFormat < 0){
+            FAIL("Unknown savePerOpDataFormat");
+          }
         } else if (strcasecmp(option, "summaryFormat") == 0) {
                 if(strcasecmp(value, "default") == 0){
                   outputFormat = OUTPUT_DEFAULT;
@@ -476,7 +481,14 @@ option_help * createGlobalOptions(IOR_param_t * params){
     {.help="  -O summaryFormat=[default,JSON,CSV] -- use the format for outputting the summary", .arg = OPTION_OPTIONAL_ARGUMENT},
     {.help="  -O saveRankPerformanceDetailsCSV=<FILE> -- store the performance of each rank into the named CSV file.", .arg = OPTION_OPTIONAL_ARGUMENT},
     {.help="  -O savePerOpDataCSV=<FILE> -- store the performance of each rank into an individual file prefixed with this option.", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O savePerOpDataFormat=[csv,binary,binary-delta] -- format of the per operation data, convert binary files with iortrace2csv", .arg = OPTION_OPTIONAL_ARGUMENT},
     {0, "dryRun",      "do not perform any I/Os just run evtl. inputs print dummy output", OPTION_FLAG, 'd', & params->dryRun},
+    {0, "clientStats", "report the client CPU time, context switches, storage I/O (/proc/self/io) and node page cache (/proc/vmstat) per phase", OPTION_FLAG, 'd', & params->clientStats},
+    {0, "perfCounters", "report the cycles, instructions, IPC, LLC misses, page faults and dTLB misses per phase using perf_event_open", OPTION_FLAG, 'd', & params->perfCounters},
+    {0, "timeline",    "write a timeline of all backend calls of all ranks into the named file in the Chrome trace format (chrome://tracing, ui.perfetto.dev)", OPTION_OPTIONAL_ARGUMENT, 's', & params->timeline},
+    {0, "timelineEvents", "number of backend calls kept per rank for the timeline, older calls are dropped", OPTION_OPTIONAL_ARGUMENT, 'd', & params->timelineEvents},
+    {0, "coalesceBuffer", "coalesce the writes to each file in a write-back buffer, each filled aligned window of this size is written with one backend call without splitting single transfers, reports the logical and backend operations per phase", OPTION_OPTIONAL_ARGUMENT, 'l', & params->coalesceBuffer},
+    {0, "telemetry",   "publish live progress counters of each rank into the shared memory segment /NAME on each node, watch them with ior-top NAME", OPTION_OPTIONAL_ARGUMENT, 's', & params->telemetry},
     LAST_OPTION,
   };
   option_help * options = malloc(sizeof(o));
@@ -0,0 +1,141 @@
+/*
+ * Performance counters via perf_event_open(), see perf-counters.h
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#ifdef HAVE_LINUX_PERF_EVENT_H
+#  define _GNU_SOURCE            /* Needed for syscall() */
+#endif
+
+#include <string.h>
+#include <unistd.h>
+
+#ifdef HAVE_LINUX_PERF_EVENT_H
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#endif
+
+#include "perf-counters.h"
+#include "utilities.h"
+#include "aiori-debug.h"
+
+static int perf_fd[PERF_COUNTERS_COUNT] = {-1, -1, -1, -1, -1};
+
+#ifdef HAVE_LINUX_PERF_EVENT_H
+static int perf_open(uint32_t type, uint64_t config){
+  struct perf_event_attr attr;
+  memset(& attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  /* count the threads created later as well, e.g., the workers of the md-workbench window */
+  attr.inherit = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  int fd = syscall(__NR_perf_event_open, & attr, 0, -1, -1, 0);
+  if(fd < 0){
+    /* unprivileged users may only count user space */
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = syscall(__NR_perf_event_open, & attr, 0, -1, -1, 0);
+  }
+  return fd;
+}
+
+#define PERF_CACHE_MISS(cache) ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+#endif
+
+void perf_counters_init(void){
+#ifdef HAVE_LINUX_PERF_EVENT_H
+  perf_fd[PERF_COUNTERS_CYCLES] = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  perf_fd[PERF_COUNTERS_INSTRUCTIONS] = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  perf_fd[PERF_COUNTERS_LLC_MISSES] = perf_open(PERF_TYPE_HW_CACHE, PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_LL));
+  perf_fd[PERF_COUNTERS_PAGE_FAULTS] = perf_open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+  perf_fd[PERF_COUNTERS_DTLB_MISSES] = perf_open(PERF_TYPE_HW_CACHE, PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_DTLB));
+#else
+  if(rank == 0){
+    WARN("Performance counters are not supported on this platform");
+  }
+#endif
+}
+
+void perf_counters_finalize(void){
+  for(int i=0; i < PERF_COUNTERS_COUNT; i++){
+    if(perf_fd[i] >= 0){
+      close(perf_fd[i]);
+      perf_fd[i] = -1;
+    }
+  }
+}
+
+void perf_counters_start(perf_counters_t * p){
+  memset(p, 0, sizeof(perf_counters_t));
+#ifdef HAVE_LINUX_PERF_EVENT_H
+  for(int i=0; i < PERF_COUNTERS_COUNT; i++){
+    if(perf_fd[i] >= 0){
+      ioctl(perf_fd[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(perf_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+}
+
+void perf_counters_stop(perf_counters_t * p){
+#ifdef HAVE_LINUX_PERF_EVENT_H
+  for(int i=0; i < PERF_COUNTERS_COUNT; i++){
+    uint64_t values[3]; /* value, time enabled, time running */
+    if(perf_fd[i] < 0){
+      continue;
+    }
+    ioctl(perf_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+    if(read(perf_fd[i], values, sizeof(values)) != sizeof(values) || values[2] == 0){
+      continue;
+    }
+    /* scale the value if the counter was multiplexed */
+    p->v[i] = values[0] * ((double) values[1] / values[2]);
+    p->available[i] = 1;
+  }
+#endif
+}
+
+void perf_counters_report(FILE * out, const char * phase, perf_counters_t * p, uint64_t ops, MPI_Comm com){
+  double local[2 * PERF_COUNTERS_COUNT + 1];
+  double sum[2 * PERF_COUNTERS_COUNT + 1];
+  int com_rank;
+  int com_size;
+  MPI_CHECK(MPI_Comm_rank(com, & com_rank), "MPI_Comm_rank() error");
+  MPI_CHECK(MPI_Comm_size(com, & com_size), "MPI_Comm_size() error");
+  memcpy(local, p->v, sizeof(p->v));
+  memcpy(local + PERF_COUNTERS_COUNT, p->available, sizeof(p->available));
+  local[2 * PERF_COUNTERS_COUNT] = ops;
+  MPI_CHECK(MPI_Reduce(local, sum, 2 * PERF_COUNTERS_COUNT + 1, MPI_DOUBLE, MPI_SUM, 0, com), "MPI_Reduce() error");
+  if(com_rank != 0){
+    return;
+  }
+  const char * names[] = {"cycles", "instructions", "LLC-misses", "page-faults", "dTLB-misses"};
+  double * v = sum;
+  double * available = sum + PERF_COUNTERS_COUNT;
+  double total_ops = sum[2 * PERF_COUNTERS_COUNT];
+
+  fprintf(out, "perf %-20s", phase);
+  for(int i=0; i < PERF_COUNTERS_COUNT; i++){
+    /* only report counters that are available on all ranks */
+    if(available[i] != com_size){
+      fprintf(out, " %s n/a", names[i]);
+      continue;
+    }
+    fprintf(out, " %s %.4g", names[i], v[i]);
+    if(i == PERF_COUNTERS_INSTRUCTIONS && available[PERF_COUNTERS_CYCLES] == com_size && v[PERF_COUNTERS_CYCLES] > 0){
+      fprintf(out, " IPC %.2f", v[i] / v[PERF_COUNTERS_CYCLES]);
+    }
+    if(i != PERF_COUNTERS_INSTRUCTIONS && i != PERF_COUNTERS_CYCLES && total_ops > 0){
+      fprintf(out, " (%.2f/op)", v[i] / total_ops);
+    }
+  }
+  fprintf(out, "\n");
+  fflush(out);
+}
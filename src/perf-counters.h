@@ -0,0 +1,37 @@
+#ifndef _IOR_PERF_COUNTERS_H
+#define _IOR_PERF_COUNTERS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <mpi.h>
+
+/*
+ * Hardware and software performance counters of the calling process via perf_event_open(),
+ * counted per phase. The counters include the threads created after perf_counters_init(),
+ * threads started before (e.g., by the MPI library) are not counted. Counters that cannot be opened (e.g., due to perf_event_paranoid or
+ * inside a VM) are reported as unavailable.
+ */
+
+enum {
+  PERF_COUNTERS_CYCLES = 0,
+  PERF_COUNTERS_INSTRUCTIONS,
+  PERF_COUNTERS_LLC_MISSES,
+  PERF_COUNTERS_PAGE_FAULTS,
+  PERF_COUNTERS_DTLB_MISSES,
+  PERF_COUNTERS_COUNT
+};
+
+typedef struct {
+  double v[PERF_COUNTERS_COUNT];
+  double available[PERF_COUNTERS_COUNT]; /* 1 if the counter was read */
+} perf_counters_t;
+
+void perf_counters_init(void);
+void perf_counters_finalize(void);
+
+void perf_counters_start(perf_counters_t * p);
+void perf_counters_stop(perf_counters_t * p);
+/* collective, sums up the counters of all ranks and prints them on rank 0, ops is the local number of operations */
+void perf_counters_report(FILE * out, const char * phase, perf_counters_t * p, uint64_t ops, MPI_Comm com);
+
+#endif
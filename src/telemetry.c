@@ -0,0 +1,125 @@
+/*
+ * Live progress telemetry via a per-node POSIX shared memory segment, see telemetry.h
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "telemetry.h"
+#include "utilities.h"
+#include "aiori-debug.h"
+
+static telemetry_segment_t * segment = NULL;
+static telemetry_slot_t * my_slot = NULL;
+static size_t segment_size;
+static char segment_name[MAX_PATHLEN];
+static MPI_Comm node_comm;
+static int node_rank;
+
+static double wall_time(){
+  struct timeval tv;
+  gettimeofday(& tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+void telemetry_init(const char * name, const char * command, MPI_Comm com){
+  int node_size;
+  int com_rank;
+  if(name == NULL){
+    return;
+  }
+  MPI_CHECK(MPI_Comm_rank(com, & com_rank), "MPI_Comm_rank() error");
+  MPI_CHECK(MPI_Comm_split_type(com, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, & node_comm), "MPI_Comm_split_type() error");
+  MPI_CHECK(MPI_Comm_rank(node_comm, & node_rank), "MPI_Comm_rank() error");
+  MPI_CHECK(MPI_Comm_size(node_comm, & node_size), "MPI_Comm_size() error");
+
+  snprintf(segment_name, sizeof(segment_name), "/%s", name);
+  segment_size = sizeof(telemetry_segment_t) + sizeof(telemetry_slot_t) * node_size;
+
+  int fd = -1;
+  if(node_rank == 0){
+    fd = shm_open(segment_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0 || ftruncate(fd, segment_size) != 0){
+      WARNF("Cannot create the telemetry segment %s: %s", segment_name, strerror(errno));
+    }
+  }
+  MPI_CHECK(MPI_Barrier(node_comm), "barrier error");
+  if(node_rank != 0){
+    fd = shm_open(segment_name, O_RDWR, 0644);
+  }
+  if(fd >= 0){
+    segment = mmap(NULL, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(segment == MAP_FAILED){
+      WARNF("Cannot map the telemetry segment %s: %s", segment_name, strerror(errno));
+      segment = NULL;
+    }
+  }
+  if(segment != NULL && node_rank == 0){
+    memset(segment, 0, segment_size);
+    segment->slots = node_size;
+    gethostname(segment->hostname, sizeof(segment->hostname) - 1);
+    strncpy(segment->command, command, sizeof(segment->command) - 1);
+    segment->start_time = wall_time();
+  }
+  MPI_CHECK(MPI_Barrier(node_comm), "barrier error");
+  if(segment != NULL){
+    my_slot = & segment->slot[node_rank];
+    my_slot->rank = com_rank;
+    my_slot->update_time = wall_time();
+    if(node_rank == 0){
+      __sync_synchronize();
+      segment->magic = TELEMETRY_MAGIC;
+    }
+  }
+}
+
+void telemetry_finalize(void){
+  if(segment == NULL){
+    return;
+  }
+  telemetry_phase("finished");
+  MPI_CHECK(MPI_Barrier(node_comm), "barrier error");
+  if(node_rank == 0){
+    segment->finished = 1;
+    shm_unlink(segment_name);
+  }
+  munmap(segment, segment_size);
+  segment = NULL;
+  my_slot = NULL;
+  MPI_CHECK(MPI_Comm_free(& node_comm), "MPI_Comm_free() error");
+}
+
+void telemetry_phase(const char * phase){
+  if(my_slot == NULL){
+    return;
+  }
+  strncpy(my_slot->phase, phase, TELEMETRY_PHASE_LEN - 1);
+  my_slot->update_time = wall_time();
+}
+
+void telemetry_op(uint64_t bytes, double latency){
+  if(my_slot == NULL){
+    return;
+  }
+  my_slot->bytes += bytes;
+  my_slot->ops++;
+  my_slot->last_latency = latency;
+  my_slot->update_time = wall_time();
+}
+
+void telemetry_error(uint64_t count){
+  if(my_slot == NULL || count == 0){
+    return;
+  }
+  my_slot->errors += count;
+}
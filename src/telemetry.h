@@ -0,0 +1,49 @@
+#ifndef _IOR_TELEMETRY_H
+#define _IOR_TELEMETRY_H
+
+#include <stdint.h>
+
+/*
+ * Live progress telemetry: each rank publishes its counters into a POSIX shared memory
+ * segment per node that can be watched with ior-top while the benchmark runs.
+ * The segment consists of a header followed by one slot per rank on the node.
+ * Counters are updated without locking, readers may observe a slightly stale slot.
+ */
+
+#define TELEMETRY_MAGIC 0x494f52544c4d0001ull /* "IORTLM" version 1 */
+#define TELEMETRY_PHASE_LEN 32
+
+typedef struct {
+  int32_t rank;
+  char phase[TELEMETRY_PHASE_LEN];
+  uint64_t bytes;
+  uint64_t ops;
+  uint64_t errors;
+  double last_latency; /* in s */
+  double update_time;  /* wall-clock time of the last update */
+} telemetry_slot_t;
+
+typedef struct {
+  uint64_t magic;
+  int32_t slots;
+  int32_t finished; /* set once the benchmark completed */
+  char hostname[64];
+  char command[64];
+  double start_time;
+  telemetry_slot_t slot[];
+} telemetry_segment_t;
+
+#ifndef TELEMETRY_READER_ONLY
+#include <mpi.h>
+
+/* collective on com, creates the segment /name on each node */
+void telemetry_init(const char * name, const char * command, MPI_Comm com);
+/* collective on the communicator used for telemetry_init */
+void telemetry_finalize(void);
+
+void telemetry_phase(const char * phase);
+void telemetry_op(uint64_t bytes, double latency);
+void telemetry_error(uint64_t count);
+#endif
+
+#endif
@@ -0,0 +1,447 @@
+/*
+ * Timeline of the backend calls in the Chrome trace event format, see timeline.h
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "timeline.h"
+#include "utilities.h"
+
+#define TIMELINE_PHASE_LEN 32
+#define TIMELINE_PINGS 8 /* round trips per rank to determine the clock offset */
+
+enum {
+  TIMELINE_CREATE = 0,
+  TIMELINE_MKNOD,
+  TIMELINE_OPEN,
+  TIMELINE_WRITE,
+  TIMELINE_READ,
+  TIMELINE_CLOSE,
+  TIMELINE_REMOVE,
+  TIMELINE_FSYNC,
+  TIMELINE_GET_FILE_SIZE,
+  TIMELINE_STATFS,
+  TIMELINE_MKDIR,
+  TIMELINE_RMDIR,
+  TIMELINE_ACCESS,
+  TIMELINE_STAT,
+  TIMELINE_RENAME,
+  TIMELINE_SYNC,
+  TIMELINE_PUT_BATCH,
+  TIMELINE_GET_BATCH,
+  TIMELINE_REMOVE_BATCH,
+  TIMELINE_STAT_BATCH
+};
+
+static const char * op_names[] = {"create", "mknod", "open", "write", "read", "close", "remove", "fsync",
+  "get_file_size", "statfs", "mkdir", "rmdir", "access", "stat", "rename", "sync",
+  "put_batch", "get_batch", "remove_batch", "stat_batch"};
+
+typedef struct {
+  double start;    /* local clock */
+  double end;
+  int64_t size;    /* bytes or objects of a batch, -1 if not applicable */
+  int64_t offset;  /* -1 if not applicable */
+  int32_t op;
+  int32_t error;   /* 1 if the call failed */
+} timeline_event_t;
+
+typedef struct {
+  char name[TIMELINE_PHASE_LEN];
+  double start;
+  double end;
+} timeline_phase_t;
+
+static struct {
+  const ior_aiori_t * orig; /* NULL if the timeline is disabled */
+  ior_aiori_t wrapped;
+  char * filename;
+  MPI_Comm com;
+  int rank;
+  int size;
+  timeline_event_t * events; /* ring buffer */
+  int64_t capacity;
+  int64_t count; /* number of recorded events, including overwritten ones */
+  timeline_phase_t * phases;
+  int phase_count;
+  int phase_open;
+  double * clock; /* rank 0 only: local time and offset of each rank at the start and at the end */
+} tl;
+
+static double now(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, & ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void record(int op, double start, int64_t size, int64_t offset, int error){
+  timeline_event_t * e = & tl.events[tl.count % tl.capacity];
+  e->start = start;
+  e->end = now();
+  e->size = size;
+  e->offset = offset;
+  e->op = op;
+  e->error = error;
+  tl.count++;
+}
+
+/* wrappers of the backend functions */
+
+static aiori_fd_t *timeline_create(char * name, int flags, aiori_mod_opt_t * module_options){
+  double start = now();
+  aiori_fd_t * fd = tl.orig->create(name, flags, module_options);
+  record(TIMELINE_CREATE, start, -1, -1, fd == NULL);
+  return fd;
+}
+
+static int timeline_mknod(char * name){
+  double start = now();
+  int ret = tl.orig->mknod(name);
+  record(TIMELINE_MKNOD, start, -1, -1, ret != 0);
+  return ret;
+}
+
+static aiori_fd_t *timeline_open(char * name, int flags, aiori_mod_opt_t * module_options){
+  double start = now();
+  aiori_fd_t * fd = tl.orig->open(name, flags, module_options);
+  record(TIMELINE_OPEN, start, -1, -1, fd == NULL);
+  return fd;
+}
+
+static IOR_offset_t timeline_xfer(int access, aiori_fd_t * fd, IOR_size_t * buffer, IOR_offset_t size, IOR_offset_t offset, aiori_mod_opt_t * module_options){
+  double start = now();
+  IOR_offset_t ret = tl.orig->xfer(access, fd, buffer, size, offset, module_options);
+  record(access == WRITE ? TIMELINE_WRITE : TIMELINE_READ, start, size, offset, ret != size);
+  return ret;
+}
+
+static void timeline_close(aiori_fd_t * fd, aiori_mod_opt_t * module_options){
+  double start = now();
+  tl.orig->close(fd, module_options);
+  record(TIMELINE_CLOSE, start, -1, -1, 0);
+}
+
+static void timeline_remove(char * name, aiori_mod_opt_t * module_options){
+  double start = now();
+  tl.orig->remove(name, module_options);
+  record(TIMELINE_REMOVE, start, -1, -1, 0);
+}
+
+static void timeline_fsync(aiori_fd_t * fd, aiori_mod_opt_t * module_options){
+  double start = now();
+  tl.orig->fsync(fd, module_options);
+  record(TIMELINE_FSYNC, start, -1, -1, 0);
+}
+
+static IOR_offset_t timeline_get_file_size(aiori_mod_opt_t * module_options, char * name){
+  double start = now();
+  IOR_offset_t ret = tl.orig->get_file_size(module_options, name);
+  record(TIMELINE_GET_FILE_SIZE, start, ret, -1, ret < 0);
+  return ret;
+}
+
+static int timeline_statfs(const char * path, ior_aiori_statfs_t * buf, aiori_mod_opt_t * module_options){
+  double start = now();
+  int ret = tl.orig->statfs(path, buf, module_options);
+  record(TIMELINE_STATFS, start, -1, -1, ret != 0);
+  return ret;
+}
+
+static int timeline_mkdir(const char * path, mode_t mode, aiori_mod_opt_t * module_options){
+  double start = now();
+  int ret = tl.orig->mkdir(path, mode, module_options);
+  record(TIMELINE_MKDIR, start, -1, -1, ret != 0);
+  return ret;
+}
+
+static int timeline_rmdir(const char * path, aiori_mod_opt_t * module_options){
+  double start = now();
+  int ret = tl.orig->rmdir(path, module_options);
+  record(TIMELINE_RMDIR, start, -1, -1, ret != 0);
+  return ret;
+}
+
+static int timeline_access(const char * path, int mode, aiori_mod_opt_t * module_options){
+  double start = now();
+  int ret = tl.orig->access(path, mode, module_options);
+  record(TIMELINE_ACCESS, start, -1, -1, ret != 0);
+  return ret;
+}
+
+static int timeline_stat(const char * path, struct stat * buf, aiori_mod_opt_t * module_options){
+  double start = now();
+  int ret = tl.orig->stat(path, buf, module_options);
+  record(TIMELINE_STAT, start, -1, -1, ret != 0);
+  return ret;
+}
+
+static int timeline_rename(const char * oldpath, const char * newpath, aiori_mod_opt_t * module_options){
+  double start = now();
+  int ret = tl.orig->rename(oldpath, newpath, module_options);
+  record(TIMELINE_RENAME, start, -1, -1, ret != 0);
+  return ret;
+}
+
+static void timeline_sync(aiori_mod_opt_t * module_options){
+  double start = now();
+  tl.orig->sync(module_options);
+  record(TIMELINE_SYNC, start, -1, -1, 0);
+}
+
+static int timeline_put_batch(int count, char ** names, IOR_size_t ** buffers, IOR_offset_t * sizes, int * status, aiori_mod_opt_t * module_options){
+  double start = now();
+  int ret = tl.orig->put_batch(count, names, buffers, sizes, status, module_options);
+  record(TIMELINE_PUT_BATCH, start, count, -1, ret != count);
+  return ret;
+}
+
+static int timeline_get_batch(int count, char ** names, IOR_size_t ** buffers, IOR_offset_t * sizes, int * status, aiori_mod_opt_t * module_options){
+  double start = now();
+  int ret = tl.orig->get_batch(count, names, buffers, sizes, status, module_options);
+  record(TIMELINE_GET_BATCH, start, count, -1, ret != count);
+  return ret;
+}
+
+static int timeline_remove_batch(int count, char ** names, int * status, aiori_mod_opt_t * module_options){
+  double start = now();
+  int ret = tl.orig->remove_batch(count, names, status, module_options);
+  record(TIMELINE_REMOVE_BATCH, start, count, -1, ret != count);
+  return ret;
+}
+
+static int timeline_stat_batch(int count, char ** names, struct stat * bufs, int * status, aiori_mod_opt_t * module_options){
+  double start = now();
+  int ret = tl.orig->stat_batch(count, names, bufs, status, module_options);
+  record(TIMELINE_STAT_BATCH, start, count, -1, ret != count);
+  return ret;
+}
+
+/*
+ * Determine the offset of the clock of each rank to rank 0 using the round trip with the
+ * lowest latency, only rank 0 receives the values.
+ */
+static void clock_sync(double * local_time, double * offset){
+  for(int r = 1; r < tl.size; r++){
+    if(tl.rank == 0){
+      double best = -1;
+      for(int i=0; i < TIMELINE_PINGS; i++){
+        double remote;
+        double t0 = now();
+        MPI_CHECK(MPI_Send(& t0, 1, MPI_DOUBLE, r, 0, tl.com), "MPI_Send() error");
+        MPI_CHECK(MPI_Recv(& remote, 1, MPI_DOUBLE, r, 0, tl.com, MPI_STATUS_IGNORE), "MPI_Recv() error");
+        double t1 = now();
+        if(best < 0 || t1 - t0 < best){
+          best = t1 - t0;
+          local_time[r] = remote;
+          offset[r] = remote - (t0 + t1) / 2;
+        }
+      }
+    }else if(tl.rank == r){
+      for(int i=0; i < TIMELINE_PINGS; i++){
+        double t;
+        MPI_CHECK(MPI_Recv(& t, 1, MPI_DOUBLE, 0, 0, tl.com, MPI_STATUS_IGNORE), "MPI_Recv() error");
+        t = now();
+        MPI_CHECK(MPI_Send(& t, 1, MPI_DOUBLE, 0, 0, tl.com), "MPI_Send() error");
+      }
+    }
+  }
+  if(tl.rank == 0){
+    local_time[0] = now();
+    offset[0] = 0;
+  }
+}
+
+const ior_aiori_t * timeline_init(const char * filename, int events, const ior_aiori_t * backend, MPI_Comm com){
+  if(filename == NULL || filename[0] == 0){
+    return backend;
+  }
+  if(events <= 0 || events > INT_MAX / (int) sizeof(timeline_event_t)){
+    ERRF("Invalid number of timeline events: %d", events);
+  }
+  if(tl.orig != NULL){
+    ERR("The timeline is already active");
+  }
+  memset(& tl, 0, sizeof(tl));
+  tl.orig = backend;
+  tl.filename = strdup(filename);
+  tl.capacity = events;
+  tl.events = safeMalloc(sizeof(timeline_event_t) * events);
+  MPI_CHECK(MPI_Comm_dup(com, & tl.com), "MPI_Comm_dup() error");
+  MPI_CHECK(MPI_Comm_rank(tl.com, & tl.rank), "MPI_Comm_rank() error");
+  MPI_CHECK(MPI_Comm_size(tl.com, & tl.size), "MPI_Comm_size() error");
+  if(tl.rank == 0){
+    tl.clock = safeMalloc(sizeof(double) * 4 * tl.size);
+  }
+  clock_sync(tl.clock, tl.clock + tl.size);
+
+  /* wrap the available functions only, the backend interface checks for NULL */
+  tl.wrapped = *backend;
+  ior_aiori_t * w = & tl.wrapped;
+  w->create = backend->create ? timeline_create : NULL;
+  w->mknod = backend->mknod ? timeline_mknod : NULL;
+  w->open = backend->open ? timeline_open : NULL;
+  w->xfer = backend->xfer ? timeline_xfer : NULL;
+  w->close = backend->close ? timeline_close : NULL;
+  w->remove = backend->remove ? timeline_remove : NULL;
+  w->fsync = backend->fsync ? timeline_fsync : NULL;
+  w->get_file_size = backend->get_file_size ? timeline_get_file_size : NULL;
+  w->statfs = backend->statfs ? timeline_statfs : NULL;
+  w->mkdir = backend->mkdir ? timeline_mkdir : NULL;
+  w->rmdir = backend->rmdir ? timeline_rmdir : NULL;
+  w->access = backend->access ? timeline_access : NULL;
+  w->stat = backend->stat ? timeline_stat : NULL;
+  w->rename = backend->rename ? timeline_rename : NULL;
+  w->sync = backend->sync ? timeline_sync : NULL;
+  w->put_batch = backend->put_batch ? timeline_put_batch : NULL;
+  w->get_batch = backend->get_batch ? timeline_get_batch : NULL;
+  w->remove_batch = backend->remove_batch ? timeline_remove_batch : NULL;
+  w->stat_batch = backend->stat_batch ? timeline_stat_batch : NULL;
+  return w;
+}
+
+void timeline_phase(const char * phase){
+  if(tl.orig == NULL){
+    return;
+  }
+  double t = now();
+  if(tl.phase_open){
+    tl.phases[tl.phase_count - 1].end = t;
+    tl.phase_open = 0;
+  }
+  if(phase == NULL){
+    return;
+  }
+  tl.phases = realloc(tl.phases, sizeof(timeline_phase_t) * (tl.phase_count + 1));
+  if(tl.phases == NULL){
+    ERR("Out of memory");
+  }
+  timeline_phase_t * p = & tl.phases[tl.phase_count++];
+  snprintf(p->name, TIMELINE_PHASE_LEN, "%s", phase);
+  p->start = t;
+  p->end = t;
+  tl.phase_open = 1;
+}
+
+/* position of the stored events in the ring, the oldest event first */
+static void ring_chunks(int64_t count, int64_t * first, int64_t * n1, int64_t * n2){
+  int64_t stored = count < tl.capacity ? count : tl.capacity;
+  *first = count > tl.capacity ? count % tl.capacity : 0;
+  *n1 = stored < tl.capacity - *first ? stored : tl.capacity - *first;
+  *n2 = stored - *n1;
+}
+
+/* convert the local time of rank r into microseconds since timeline_init() on rank 0 */
+static double global_time(int r, double t){
+  double * start_time = tl.clock;
+  double * start_offset = tl.clock + tl.size;
+  double * end_time = tl.clock + 2 * tl.size;
+  double * end_offset = tl.clock + 3 * tl.size;
+  double offset = start_offset[r];
+  if(end_time[r] > start_time[r]){
+    offset += (end_offset[r] - start_offset[r]) * (t - start_time[r]) / (end_time[r] - start_time[r]);
+  }
+  return (t - offset - start_time[0]) * 1e6;
+}
+
+static void write_events(FILE * f, int r, timeline_event_t * e, int64_t count){
+  for(int64_t i=0; i < count; i++, e++){
+    double ts = global_time(r, e->start);
+    fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"io\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f", op_names[e->op], r, ts, global_time(r, e->end) - ts);
+    if(e->op >= TIMELINE_PUT_BATCH){
+      fprintf(f, ",\"args\":{\"objects\":%lld,\"error\":%d}}", (long long) e->size, e->error);
+    }else if(e->offset >= 0){
+      fprintf(f, ",\"args\":{\"size\":%lld,\"offset\":%lld,\"error\":%d}}", (long long) e->size, (long long) e->offset, e->error);
+    }else{
+      fprintf(f, ",\"args\":{\"error\":%d}}", e->error);
+    }
+  }
+}
+
+static void write_phases(FILE * f, int r, timeline_phase_t * p, int count){
+  for(int i=0; i < count; i++, p++){
+    double ts = global_time(r, p->start);
+    fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"phase\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", p->name, r, ts, global_time(r, p->end) - ts);
+  }
+}
+
+void timeline_finalize(void){
+  if(tl.orig == NULL){
+    return;
+  }
+  timeline_phase(NULL);
+  if(tl.rank == 0){
+    clock_sync(tl.clock + 2 * tl.size, tl.clock + 3 * tl.size);
+  }else{
+    clock_sync(NULL, NULL);
+  }
+
+  int64_t first, n1, n2;
+  if(tl.rank != 0){
+    /* send the events once rank 0 is ready to process them */
+    int64_t info[2] = {tl.count, tl.phase_count};
+    int go;
+    ring_chunks(tl.count, & first, & n1, & n2);
+    MPI_CHECK(MPI_Recv(& go, 1, MPI_INT, 0, 1, tl.com, MPI_STATUS_IGNORE), "MPI_Recv() error");
+    MPI_CHECK(MPI_Send(info, 2, MPI_INT64_T, 0, 1, tl.com), "MPI_Send() error");
+    MPI_CHECK(MPI_Send(tl.events + first, n1 * sizeof(timeline_event_t), MPI_BYTE, 0, 1, tl.com), "MPI_Send() error");
+    MPI_CHECK(MPI_Send(tl.events, n2 * sizeof(timeline_event_t), MPI_BYTE, 0, 1, tl.com), "MPI_Send() error");
+    MPI_CHECK(MPI_Send(tl.phases, tl.phase_count * sizeof(timeline_phase_t), MPI_BYTE, 0, 1, tl.com), "MPI_Send() error");
+  }else{
+    FILE * f = fopen(tl.filename, "w");
+    if(f == NULL){
+      ERRF("Cannot open the timeline file %s", tl.filename);
+    }
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"ranks\"}}");
+    timeline_event_t * events = safeMalloc(sizeof(timeline_event_t) * tl.capacity);
+    int64_t dropped = 0;
+    for(int r=0; r < tl.size; r++){
+      fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"rank %d\"}}", r, r);
+      fprintf(f, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"sort_index\":%d}}", r, r);
+      if(r == 0){
+        ring_chunks(tl.count, & first, & n1, & n2);
+        write_phases(f, r, tl.phases, tl.phase_count);
+        write_events(f, r, tl.events + first, n1);
+        write_events(f, r, tl.events, n2);
+        dropped += tl.count - n1 - n2;
+        continue;
+      }
+      int64_t info[2];
+      int go = 1;
+      MPI_CHECK(MPI_Send(& go, 1, MPI_INT, r, 1, tl.com), "MPI_Send() error");
+      MPI_CHECK(MPI_Recv(info, 2, MPI_INT64_T, r, 1, tl.com, MPI_STATUS_IGNORE), "MPI_Recv() error");
+      ring_chunks(info[0], & first, & n1, & n2);
+      MPI_CHECK(MPI_Recv(events, n1 * sizeof(timeline_event_t), MPI_BYTE, r, 1, tl.com, MPI_STATUS_IGNORE), "MPI_Recv() error");
+      MPI_CHECK(MPI_Recv(events + n1, n2 * sizeof(timeline_event_t), MPI_BYTE, r, 1, tl.com, MPI_STATUS_IGNORE), "MPI_Recv() error");
+      timeline_phase_t * phases = safeMalloc(sizeof(timeline_phase_t) * (info[1] + 1));
+      MPI_CHECK(MPI_Recv(phases, info[1] * sizeof(timeline_phase_t), MPI_BYTE, r, 1, tl.com, MPI_STATUS_IGNORE), "MPI_Recv() error");
+      write_phases(f, r, phases, info[1]);
+      write_events(f, r, events, n1 + n2);
+      free(phases);
+      dropped += info[0] - n1 - n2;
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    free(events);
+    free(tl.clock);
+    if(dropped > 0){
+      WARNF("The timeline dropped the %lld oldest backend calls, increase the number of timeline events", (long long) dropped);
+    }
+  }
+  MPI_CHECK(MPI_Comm_free(& tl.com), "MPI_Comm_free() error");
+  free(tl.events);
+  free(tl.phases);
+  free(tl.filename);
+  /* the wrapped backend may still be referenced, let it call the original functions */
+  tl.wrapped = *tl.orig;
+  tl.orig = NULL;
+}
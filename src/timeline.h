@@ -0,0 +1,27 @@
+#ifndef _IOR_TIMELINE_H
+#define _IOR_TIMELINE_H
+
+#include <mpi.h>
+
+#include "aiori.h"
+
+/*
+ * Timeline of every backend call: the functions of the ior_aiori_t are wrapped and each call is
+ * recorded with its begin and end time into a ring buffer per rank (the oldest calls are
+ * overwritten if it is full). At the end, rank 0 merges the events of all ranks into a JSON
+ * file in the Chrome trace event format (chrome://tracing, ui.perfetto.dev) with one track
+ * per rank. The clock offset of each rank to rank 0 is measured at the beginning and at the
+ * end, timestamps are corrected by the linear interpolation of both offsets.
+ */
+
+#define TIMELINE_DEFAULT_EVENTS 1048576
+
+/* collective on com, returns the wrapped backend or backend itself if filename is NULL */
+const ior_aiori_t * timeline_init(const char * filename, int events, const ior_aiori_t * backend, MPI_Comm com);
+/* collective on the communicator used for timeline_init, writes the merged file */
+void timeline_finalize(void);
+
+/* starts a new phase that is shown as span around the calls, NULL ends the current phase */
+void timeline_phase(const char * phase);
+
+#endif
@@ -36,6 +36,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
+#include <pthread.h>
 
 #ifdef HAVE_CUDA
 #include <cuda_runtime.h>
@@ -235,71 +236,157 @@ int verify_memory_pattern(uint64_t item, char * buffer, size_t bytes, int rand_s
   return error;
 }
 
-/* Data structure to store information about per-operation timer */
+/*
+ Data structure to store information about per-operation timer.
+ Records are collected into one of two buffers, a full buffer is handed to a background thread
+ that formats/encodes and writes it while the benchmark continues with the other buffer.
+ */
 struct OpTimer{
     FILE * fd;
     int size; /* per op */
-    double * time;
-    double * value;
+    int format; /* optrace_format_e */
+    optrace_record_t * buffer[2];
+    int active; /* buffer filled by the benchmark */
     int pos;
+    int pending; /* number of records in the buffer handed to the writer */
+    int stop;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
 };
 
-/* by default store 1M operations into the buffer before flushing */
-#define OP_BUFFER_SIZE 1000000
+/* by default store 256k operations into each buffer before flushing */
+#define OP_BUFFER_SIZE 262144
+
+static void OpTimerWrite(OpTimer * ot, optrace_record_t * records, int count, optrace_state_t * state){
+  if(ot->format == OPTRACE_FORMAT_CSV){
+    for(int i=0; i < count; i++){
+      fprintf(ot->fd, "%.8e,%.8e,%e\n", records[i].time, records[i].runtime, records[i].size/records[i].runtime);
+    }
+    return;
+  }
+  char buf[OPTRACE_MAX_RECORD_SIZE * 1024];
+  size_t len = 0;
+  for(int i=0; i < count; i++){
+    len += optrace_encode(buf + len, ot->format, state, & records[i]);
+    if(len > sizeof(buf) - OPTRACE_MAX_RECORD_SIZE || i == count - 1){
+      if(fwrite(buf, len, 1, ot->fd) != 1){
+        WARN("Cannot write to OpTimer file");
+      }
+      len = 0;
+    }
+  }
+}
+
+static void * OpTimerWriter(void * arg){
+  OpTimer * ot = (OpTimer *) arg;
+  optrace_state_t state = {0};
+  pthread_mutex_lock(& ot->lock);
+  while(1){
+    while(ot->pending == 0 && ! ot->stop){
+      pthread_cond_wait(& ot->cond, & ot->lock);
+    }
+    if(ot->pending == 0){
+      break;
+    }
+    optrace_record_t * records = ot->buffer[1 - ot->active];
+    int count = ot->pending;
+    pthread_mutex_unlock(& ot->lock);
+    OpTimerWrite(ot, records, count, & state);
+    pthread_mutex_lock(& ot->lock);
+    ot->pending = 0;
+    pthread_cond_broadcast(& ot->cond);
+  }
+  pthread_mutex_unlock(& ot->lock);
+  return NULL;
+}
 
-OpTimer* OpTimerInit(char * filename, int size){
+OpTimer* OpTimerInit(char * filename, int size, int format){
   if(filename == NULL) {
     return NULL;
   }
   OpTimer * ot = safeMalloc(sizeof(OpTimer));
   ot->size = size;
-  ot->value = safeMalloc(sizeof(double)*OP_BUFFER_SIZE);
-  ot->time = safeMalloc(sizeof(double)*OP_BUFFER_SIZE);
+  ot->format = format;
+  ot->buffer[0] = safeMalloc(sizeof(optrace_record_t)*OP_BUFFER_SIZE);
+  ot->buffer[1] = safeMalloc(sizeof(optrace_record_t)*OP_BUFFER_SIZE);
   ot->pos = 0;
   ot->fd = fopen(filename, "w");
-  if(ot->fd < 0){
+  if(ot->fd == NULL){
     ERR("Could not create OpTimer");
   }
-  char buff[] = "time,runtime,tp\n";
-  int ret = fwrite(buff, strlen(buff), 1, ot->fd);
-  if(ret != 1){
+  if(format == OPTRACE_FORMAT_CSV){
+    char buff[] = "time,runtime,tp\n";
+    int ret = fwrite(buff, strlen(buff), 1, ot->fd);
+    if(ret != 1){
+      FAIL("Cannot write header to OpTimer file");
+    }
+  }else if(optrace_write_header(ot->fd, format) != 0){
     FAIL("Cannot write header to OpTimer file");
   }
+  pthread_mutex_init(& ot->lock, NULL);
+  pthread_cond_init(& ot->cond, NULL);
+  if(pthread_create(& ot->thread, NULL, OpTimerWriter, ot) != 0){
+    FAIL("Cannot create the OpTimer writer thread");
+  }
   return ot;
 }
 
+/* hand the active buffer to the writer, waits if it is still busy with the other buffer */
 void OpTimerFlush(OpTimer* ot){
   if(ot == NULL) {
     return;
-  }  
-  for(int i=0; i < ot->pos; i++){
-    fprintf(ot->fd, "%.8e,%.8e,%e\n", ot->time[i], ot->value[i], ot->size/ot->value[i]);
   }
-  ot->pos = 0;
+  pthread_mutex_lock(& ot->lock);
+  while(ot->pending != 0){
+    pthread_cond_wait(& ot->cond, & ot->lock);
+  }
+  if(ot->pos > 0){
+    ot->pending = ot->pos;
+    ot->active = 1 - ot->active;
+    ot->pos = 0;
+    pthread_cond_broadcast(& ot->cond);
+  }
+  pthread_mutex_unlock(& ot->lock);
 }
 
-void OpTimerValue(OpTimer* ot, double now, double runTime){
+void OpTimerRecord(OpTimer* ot, int op, double now, double runTime, int64_t size, int64_t offset){
   if(ot == NULL) {
     return;
-  }  
-  ot->time[ot->pos] = now;
-  ot->value[ot->pos++] = runTime;
+  }
+  optrace_record_t * r = & ot->buffer[ot->active][ot->pos++];
+  r->time = now;
+  r->runtime = runTime;
+  r->size = size;
+  r->offset = offset;
+  r->op = op;
   if(ot->pos == OP_BUFFER_SIZE){
     OpTimerFlush(ot);
   }
 }
 
+void OpTimerValue(OpTimer* ot, double now, double runTime){
+  if(ot == NULL) {
+    return;
+  }
+  OpTimerRecord(ot, 0, now, runTime, ot->size, -1);
+}
+
 void OpTimerFree(OpTimer** otp){
   if(otp == NULL || *otp == NULL) {
     return;
   }
   OpTimer * ot = *otp;
   OpTimerFlush(ot);
-  ot->pos = 0;
-  free(ot->value);
-  free(ot->time);
-  ot->value = NULL;
-  ot->time = NULL;
+  pthread_mutex_lock(& ot->lock);
+  ot->stop = 1;
+  pthread_cond_broadcast(& ot->cond);
+  pthread_mutex_unlock(& ot->lock);
+  pthread_join(ot->thread, NULL);
+  pthread_mutex_destroy(& ot->lock);
+  pthread_cond_destroy(& ot->cond);
+  free(ot->buffer[0]);
+  free(ot->buffer[1]);
   fclose(ot->fd);
   free(ot);
   *otp = NULL;
@@ -17,6 +17,7 @@
 
 #include <mpi.h>
 #include "ior.h"
+#include "optrace.h"
 
 extern int rank;
 extern int rankOffset;
@@ -64,9 +65,12 @@ void DelaySecs(int delay);
 void updateParsedOptions(IOR_param_t * options, options_all_t * global_options);
 size_t NodeMemoryStringToBytes(char *size_str);
 
+/* Per-operation timer, the records are written by a background thread in the optrace_format_e */
 typedef struct OpTimer OpTimer;
-OpTimer* OpTimerInit(char * filename, int size);
+OpTimer* OpTimerInit(char * filename, int size, int format);
 void OpTimerValue(OpTimer* otimer_in, double now, double runTime);
+/* record an operation of the type op with size and offset (-1 if unknown) */
+void OpTimerRecord(OpTimer* otimer_in, int op, double now, double runTime, int64_t size, int64_t offset);
 void OpTimerFlush(OpTimer* otimer_in);
 void OpTimerFree(OpTimer** otimer_in);
 
@@ -22,11 +22,22 @@ MDTEST 1 -a POSIX
 MDTEST 2 -a POSIX -W 2
 MDTEST 1 -C -T -r -F -I 1 -z 1 -b 1 -L -u
 MDTEST 1 -C -T -I 1 -z 1 -b 1 -u
+MDTEST 1 -C -T -r -F -I 10 -z 1 -b 1 -w 100 --batch-size=4
+MDTEST 2 -n 20 -w 10 --telemetry=mdtest-basic-tests
 MDTEST 2 -n 1 -f 1 -l 2
 
 IOR 1 -a POSIX -w    -z                  -F -Y -e -i1 -m -t 100k -b 2000k
 IOR 1 -a POSIX -w    -z                  -F -k -e -i2 -m -t 100k -b 200k
 IOR 1 -a MMAP -r    -z                  -F -k -e -i1 -m -t 100k -b 200k
+IOR 1 -a POSIX -w -r                     -F -k -e -i1 -m -t 100k -b 200k -O savePerOpDataCSV=perop -O savePerOpDataFormat=binary-delta
+IOR 2 -a POSIX -w -r                     -F -k -e -i1 -m -t 100k -b 200k --clientStats
+IOR 2 -a POSIX -w -r                     -F -k -e -i1 -m -t 100k -b 200k --perfCounters
+IOR 2 -a POSIX -w -r                     -F -k -e -i1 -m -t 100k -b 200k --timeline=${IOR_OUT}/timeline.json
+IOR 2 -a POSIX -w -r -W -R -G 5         -k -e -i1 -m -t 4k -b 200k -s 2 --coalesceBuffer=64k
+IOR 2 -a MPIIO -w -r -W -R              -k -e -i1 -m -t 100k -b 200k -s 2 --mpiio.nonBlocking --mpiio.requestWindow=4
+IOR 2 -a MPIIO -w -r -W -R -c           -k -e -i1 -m -t 100k -b 200k -s 2 --mpiio.nonBlocking
+IOR 2 -a MPIIO -w -r -W -R -c           -k -e -i1 -m -t 100k -b 200k -s 3 --mpiio.wholePhase --mpiio.phaseBufferSize=300k
+IOR 2 -a EC -w -r -W -R -G 7            -k -e -i1 -m -t 128k -b 256k -s 2 --ec.code=rs --ec.m=2 --ec.stripeUnit=32k --ec.failed=1,4
 
 IOR 2 -a POSIX -w     -C              -k -e -i1 -m -t 100k -b 200k
 # Random read the file previously created
@@ -44,11 +55,17 @@ IOR 2 -f "$ROOT/test_comments.ior"
 # Test for JSON output
 IOR 2 -a DUMMY -e -F -t 1m -b 1m -A 328883 -O summaryFormat=JSON -O summaryFile=OUT.json
 python -mjson.tool OUT.json >/dev/null  && echo "JSON OK"
+python -mjson.tool ${IOR_OUT}/timeline.json >/dev/null  && echo "Timeline JSON OK"
 
 # MDWB
 MDWB 3 -a POSIX -O=1 -D=1 -G=10 -P=1 -I=1 -R=2 -X
 MDWB 3 -a POSIX -O=1 -D=4 -G=10 -P=4 -I=1 -R=2 -X -t=0.001 -L=latency.txt
+MDWB 3 -a POSIX -O=1 -D=4 -G=10 -P=4 -I=1 -R=2 -X --latency-accuracy=0.001 -L=latency.txt --latency-all
 MDWB 3 -a POSIX -O=1 -D=2 -G=10 -P=4 -I=3 -R=2 -X -W -w 1
+MDWB 3 -a POSIX -O=1 -D=2 -G=10 -P=4 -I=3 -R=2 -X -W -w 1 --window=4
+MDWB 3 -a POSIX -O=1 -D=2 -G=10 -P=4 -I=3 -R=2 -X --arrival-rate=100 --window=2
+MDWB 3 -a POSIX -O=1 -D=4 -G=10 -P=4 -I=3 -R=2 -X --object-size-distribution=lognormal --objects-per-request=2
+MDWB 3 -a POSIX -O=1 -D=4 -G=10 -P=4 -I=3 -R=2 -X --objects-per-request=3 --batch
 MDWB 3 -a POSIX -O=1 -D=2 -G=10 -P=4 -I=3 -1 -W -w 1 --run-info-file=mdw.tst --print-detailed-stats
 MDWB 3 -a POSIX -O=1 -D=2 -G=10 -P=4 -I=3 -2 -W -w 1 --run-info-file=mdw.tst --print-detailed-stats
 MDWB 3 -a POSIX -O=1 -D=2 -G=10 -P=4 -I=3 -2 -W -w 1 --read-only --run-info-file=mdw.tst --print-detailed-stats
@@ -5,6 +5,9 @@
 #include <string.h>
 #include <fcntl.h>
 #include <sys/statvfs.h>
+#include <sys/time.h>
+#include <stdint.h>
+#include <stdlib.h>
 
 #include <cmocka.h>
 #include <nfsc/libnfs.h>
@@ -12,6 +15,26 @@
 #include "../../../src/aiori-LIBNFS.h"
 #include "../../../src/aiori.h"
 
+/******* the symbols of utilities.c used by the backend, linking it would pull in all of IOR *******/
+
+int rank = 0;
+FILE * out_logfile = NULL;
+
+double GetTimeStamp(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+void *safeMalloc(uint64_t size) {
+    void *ptr = malloc(size);
+    if (ptr == NULL) {
+        printf("could not allocate %llu bytes\n", (unsigned long long) size);
+        exit(1);
+    }
+    memset(ptr, 0, size);
+    return ptr;
+}
 
 // data structure that contains all necessary information about the test environment
 typedef struct
@@ -157,6 +180,23 @@ static int teardown(void **state) {
     return 0;
 }
 
+static int setup_pipelined(void **state) {
+    test_infrastructure_data *data = (test_infrastructure_data *)*state;
+    data->fake_options.rpcs = 8;
+    data->fake_options.connections = 2;
+
+    return setup(state);
+}
+
+static int teardown_pipelined(void **state) {
+    test_infrastructure_data *data = (test_infrastructure_data *)*state;
+    int result = teardown(state);
+    data->fake_options.rpcs = 1;
+    data->fake_options.connections = 1;
+
+    return result;
+}
+
 /******* tests *******/
 
 static void create_file(void **state) {
@@ -393,6 +433,43 @@ static void get_file_size(void **state) {
     assert_int_equal(file_size, 4);
 }
 
+static void write_and_read_file_pipelined(void **state) {
+    test_infrastructure_data *data = (test_infrastructure_data *)*state;
+    aiori_mod_opt_t *module_options = (aiori_mod_opt_t *)&data->fake_options;
+
+    //Arrange: two transfers that span several RPCs each
+    const size_t transfer_size = 3 * 1024 * 1024 + 5;
+    char *buffer = malloc(2 * transfer_size);
+    for (size_t i = 0; i < 2 * transfer_size; i++) {
+        buffer[i] = (char)(i % 251);
+    }
+
+    //Act
+    aiori_fd_t *file_handle = libnfs_aiori.create("test.txt", IOR_CREAT | IOR_RDWR, module_options);
+    IOR_offset_t written = libnfs_aiori.xfer(WRITE, file_handle, (IOR_size_t *)buffer, transfer_size, 0, module_options);
+    written += libnfs_aiori.xfer(WRITE, file_handle, (IOR_size_t *)(buffer + transfer_size), transfer_size, transfer_size, module_options);
+    libnfs_aiori.fsync(file_handle, module_options);
+
+    char *read_buffer = calloc(1, transfer_size);
+    IOR_offset_t readed = libnfs_aiori.xfer(READ, file_handle, (IOR_size_t *)read_buffer, transfer_size, transfer_size, module_options);
+    libnfs_aiori.close(file_handle, module_options);
+
+    //Assert
+    assert_int_equal(written, 2 * transfer_size);
+    assert_int_equal(readed, transfer_size);
+    assert_memory_equal(read_buffer, buffer + transfer_size, transfer_size);
+
+    char file_path[PATH_MAX];
+    snprintf(file_path, sizeof(file_path), "%s/test.txt", data->local_folder_path);
+    char *local_buffer = calloc(1, 2 * transfer_size);
+    assert_int_equal(read_local_file(file_path, local_buffer, 2 * transfer_size), 0);
+    assert_memory_equal(local_buffer, buffer, 2 * transfer_size);
+
+    free(local_buffer);
+    free(read_buffer);
+    free(buffer);
+}
+
 /******* main *******/
 
 int main(int argc, char** argv) {
@@ -402,8 +479,12 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    out_logfile = stdout;
+
     libnfs_options_t fake_options;
     fake_options.url = argv[2];
+    fake_options.rpcs = 1;
+    fake_options.connections = 1;
 
     test_infrastructure_data data;
     data.local_folder_path = argv[1];
@@ -453,6 +534,7 @@ int main(int argc, char** argv) {
         cmocka_unit_test_prestate_setup_teardown(make_directory, setup, teardown, state),
         cmocka_unit_test_prestate_setup_teardown(remove_directory, setup, teardown, state),
         cmocka_unit_test_prestate_setup_teardown(get_file_size, setup, teardown, state),
+        cmocka_unit_test_prestate_setup_teardown(write_and_read_file_pipelined, setup_pipelined, teardown_pipelined, state),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
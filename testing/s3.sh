@@ -24,6 +24,8 @@ I=100 # Start with this ID
 IOR 2 -a S3-libs3 --S3.host=localhost:9000  --S3.secret-key=secretkey --S3.access-key=accesskey -b $((10*1024*1024)) -t $((10*1024*1024))
 MDTEST 2 -a S3-libs3 -L --S3.host=localhost:9000  --S3.secret-key=secretkey --S3.access-key=accesskey -n 10
 MDTEST 2 -a S3-libs3 --S3.host=localhost:9000  --S3.secret-key=secretkey --S3.access-key=accesskey -n 5 -w 1024 -e 1024
+IOR 2 -a S3-libs3 --S3-libs3.host=localhost:9000  --S3-libs3.secret-key=secretkey --S3-libs3.access-key=accesskey -b $((20*1024*1024)) -t $((5*1024*1024)) --S3-libs3.multipart --S3-libs3.parallel-parts=2
+IOR 2 -a S3-libs3 --S3-libs3.host=localhost:9000  --S3-libs3.secret-key=secretkey --S3-libs3.access-key=accesskey -b $((20*1024*1024)) -t $((5*1024*1024)) -F --S3-libs3.multipart --S3-libs3.range-size=$((1024*1024)) --S3-libs3.parallel-ranges=4 --S3-libs3.read-ahead
 
 IOR 1 -a S3-libs3 --S3.host=localhost:9000  --S3.secret-key=secretkey --S3.access-key=accesskey -b $((10*1024)) -t $((10*1024)) --S3.bucket-per-file
 MDTEST 1 -a S3-libs3 -L --S3.host=localhost:9000  --S3.secret-key=secretkey --S3.access-key=accesskey --S3.bucket-per-file -n 5